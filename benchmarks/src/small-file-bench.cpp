@@ -0,0 +1,225 @@
+// Measures the inflating of the small files of an archive, where the setup of the decoder weighs
+// the most, and the decoding of the small textures among them: inflateTextureFileBuffer, which
+// starts afresh for each texture, against a reused TextureInflater.
+//
+// usage: small-file-bench <archive> [iterations] [max content size]
+//
+// The compressed files whose content is at most <max content size> bytes, 4096 by default, are read
+// in memory first; only their inflating is timed, into a buffer of the caller. The textures are the
+// contents starting with a texture header. The time reported is the best of the iterations.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <gw2dattools/compression/inflateDatFileBuffer.h>
+#include <gw2dattools/compression/inflateTextureFileBuffer.h>
+#include <gw2dattools/interface/ANDatInterface.h>
+
+namespace
+{
+
+    struct SmallFile
+    {
+        std::vector<uint8_t> raw;
+        uint32_t contentSize;
+    };
+
+    void printLine(const char *iName, double iTime, size_t iNbOfFiles, uint64_t iNbOfBytes)
+    {
+        std::cout << std::left << std::setw(18) << iName << std::right << std::fixed
+                  << std::setw(10) << std::setprecision(1) << iTime * 1000 << " ms"
+                  << std::setw(10) << std::setprecision(2) << iTime * 1e6 / iNbOfFiles << " us/file"
+                  << std::setw(10) << std::setprecision(1) << iNbOfBytes / iTime / (1024 * 1024) << " MB/s" << std::endl;
+    }
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: small-file-bench <archive> [iterations] [max content size]" << std::endl;
+        return 1;
+    }
+
+    uint32_t aNbIterations = argc > 2 ? static_cast<uint32_t>(atoi(argv[2])) : 5;
+    uint32_t aMaxContentSize = argc > 3 ? static_cast<uint32_t>(atoi(argv[3])) : 4096;
+    if (aNbIterations == 0 || aMaxContentSize == 0)
+    {
+        std::cerr << "usage: small-file-bench <archive> [iterations] [max content size]" << std::endl;
+        return 1;
+    }
+
+    std::vector<SmallFile> aSmallFileVect;
+    uint64_t aNbOfBytes = 0;
+
+    try
+    {
+        std::unique_ptr<gw2dt::datfile::ANDatInterface> pANDatInterface = gw2dt::datfile::createANDatInterface(argv[1]);
+
+        for (const gw2dt::datfile::ANDatInterface::FileRecord &aFileRecord : pANDatInterface->getFileRecordVect())
+        {
+            if (!aFileRecord.isCompressed || aFileRecord.size < 2 * sizeof(uint32_t))
+            {
+                continue;
+            }
+
+            SmallFile aSmallFile;
+            aSmallFile.raw.resize(aFileRecord.size);
+            uint32_t aSize = aFileRecord.size;
+            pANDatInterface->getBuffer(aFileRecord, aSize, aSmallFile.raw.data());
+            if (aSize < 2 * sizeof(uint32_t))
+            {
+                continue;
+            }
+            aSmallFile.raw.resize(aSize & ~3u);
+
+            // The size of the content follows the first word of the compressed stream
+            memcpy(&aSmallFile.contentSize, aSmallFile.raw.data() + sizeof(uint32_t), sizeof(aSmallFile.contentSize));
+            if (aSmallFile.contentSize == 0 || aSmallFile.contentSize > aMaxContentSize)
+            {
+                continue;
+            }
+
+            aNbOfBytes += aSmallFile.contentSize;
+            aSmallFileVect.push_back(std::move(aSmallFile));
+        }
+    }
+    catch (std::exception &iException)
+    {
+        std::cerr << "small-file-bench: " << iException.what() << std::endl;
+        return 1;
+    }
+
+    if (aSmallFileVect.empty())
+    {
+        std::cerr << "small-file-bench: no compressed file of at most " << aMaxContentSize << " bytes" << std::endl;
+        return 1;
+    }
+
+    std::cout << aSmallFileVect.size() << " files of at most " << aMaxContentSize << " bytes, " << aNbOfBytes / 1024
+              << " KB, best of " << aNbIterations << " iterations" << std::endl;
+
+    std::vector<uint8_t> aOutputVect(aMaxContentSize);
+
+    // The small textures, inflated once
+    std::vector<std::vector<uint8_t>> aTextureVect;
+    uint64_t aNbOfTextureBytes = 0;
+    uint32_t aMaxTextureSize = 0;
+    for (const SmallFile &aSmallFile : aSmallFileVect)
+    {
+        try
+        {
+            uint32_t aOutputSize = aSmallFile.contentSize;
+            gw2dt::compression::inflateDatFileBuffer(static_cast<uint32_t>(aSmallFile.raw.size()), aSmallFile.raw.data(), aOutputSize, aOutputVect.data());
+
+            uint32_t aMagic;
+            uint32_t aFormatFourCc;
+            uint16_t aWidth;
+            uint16_t aHeight;
+            if (gw2dt::compression::readTextureFileHeader(aOutputSize, aOutputVect.data(), aMagic, aFormatFourCc, aWidth, aHeight))
+            {
+                // At most 16 bytes per pixel block
+                uint32_t aTextureSize = ((aWidth + 3) / 4) * ((aHeight + 3) / 4) * 16;
+                aMaxTextureSize = std::max(aMaxTextureSize, aTextureSize);
+                aNbOfTextureBytes += aTextureSize;
+                aTextureVect.emplace_back(aOutputVect.begin(), aOutputVect.begin() + (aOutputSize & ~3u));
+            }
+        }
+        catch (std::exception &)
+        {
+        }
+    }
+
+    std::vector<uint8_t> aTextureOutputVect(aMaxTextureSize);
+    gw2dt::compression::TextureInflater aTextureInflater;
+
+    double aBestDatTime = 0;
+    double aBestTextureFunctionTime = 0;
+    double aBestTextureInflaterTime = 0;
+    uint32_t aNbOfFailures = 0;
+    uint32_t aNbOfTextureFailures = 0;
+
+    for (uint32_t aIteration = 0; aIteration < aNbIterations; ++aIteration)
+    {
+        aNbOfFailures = 0;
+        aNbOfTextureFailures = 0;
+
+        auto aStart = std::chrono::steady_clock::now();
+        for (const SmallFile &aSmallFile : aSmallFileVect)
+        {
+            try
+            {
+                uint32_t aOutputSize = aSmallFile.contentSize;
+                gw2dt::compression::inflateDatFileBuffer(static_cast<uint32_t>(aSmallFile.raw.size()), aSmallFile.raw.data(), aOutputSize, aOutputVect.data());
+            }
+            catch (std::exception &)
+            {
+                ++aNbOfFailures;
+            }
+        }
+        auto aDatEnd = std::chrono::steady_clock::now();
+        for (const std::vector<uint8_t> &aTexture : aTextureVect)
+        {
+            try
+            {
+                uint32_t aOutputSize = aMaxTextureSize;
+                gw2dt::compression::inflateTextureFileBuffer(static_cast<uint32_t>(aTexture.size()), aTexture.data(), aOutputSize, aTextureOutputVect.data());
+            }
+            catch (std::exception &)
+            {
+                ++aNbOfTextureFailures;
+            }
+        }
+        auto aTextureFunctionEnd = std::chrono::steady_clock::now();
+        for (const std::vector<uint8_t> &aTexture : aTextureVect)
+        {
+            try
+            {
+                uint32_t aOutputSize = aMaxTextureSize;
+                aTextureInflater.inflate(static_cast<uint32_t>(aTexture.size()), aTexture.data(), aOutputSize, aTextureOutputVect.data());
+            }
+            catch (std::exception &)
+            {
+                ++aNbOfTextureFailures;
+            }
+        }
+        auto aEnd = std::chrono::steady_clock::now();
+
+        double aDatTime = std::chrono::duration<double>(aDatEnd - aStart).count();
+        double aTextureFunctionTime = std::chrono::duration<double>(aTextureFunctionEnd - aDatEnd).count();
+        double aTextureInflaterTime = std::chrono::duration<double>(aEnd - aTextureFunctionEnd).count();
+        aBestDatTime = aIteration == 0 ? aDatTime : std::min(aBestDatTime, aDatTime);
+        aBestTextureFunctionTime = aIteration == 0 ? aTextureFunctionTime : std::min(aBestTextureFunctionTime, aTextureFunctionTime);
+        aBestTextureInflaterTime = aIteration == 0 ? aTextureInflaterTime : std::min(aBestTextureInflaterTime, aTextureInflaterTime);
+    }
+
+    if (aNbOfFailures != 0)
+    {
+        std::cout << aNbOfFailures << " files failed to inflate" << std::endl;
+    }
+    printLine("inflate", aBestDatTime, aSmallFileVect.size(), aNbOfBytes);
+
+    if (aTextureVect.empty())
+    {
+        std::cout << "no texture among the files" << std::endl;
+        return 0;
+    }
+
+    std::cout << aTextureVect.size() << " textures, " << aNbOfTextureBytes / 1024 << " KB of pixel blocks at most" << std::endl;
+    if (aNbOfTextureFailures != 0)
+    {
+        std::cout << aNbOfTextureFailures / 2 << " textures failed to decode" << std::endl;
+    }
+    printLine("texture function", aBestTextureFunctionTime, aTextureVect.size(), aNbOfTextureBytes);
+    printLine("TextureInflater", aBestTextureInflaterTime, aTextureVect.size(), aNbOfTextureBytes);
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Measures the decoding of the texture formats, one synthetic texture per format.
+//
+// usage: texture-bench [iterations] [width] [height]
+//
+// The textures are encoded by synthetic::encodeTexture, which exercises both the runs and the plain
+// data of the decoder. The time reported is the best of the iterations.
+//
+// Built with TEXTURE_BENCH_FUNCTION defined, the textures are decoded with inflateTextureFileBuffer
+// instead of a TextureInflater, so that the benchmark also builds against an older library for a
+// baseline, e.g. the one before the per-format decoding paths (be6b2e0^):
+//   c++ -O2 -DTEXTURE_BENCH_FUNCTION -Itests/src -I<baseline>/include benchmarks/src/texture-bench.cpp
+//       -L<baseline build> -lgw2dattools
+// That library needs the fixes of the Huffman dictionaries (71d587a, 8143e97 and a1345df) to load
+// and to decode the synthetic textures.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <gw2dattools/compression/inflateTextureFileBuffer.h>
+
+#include "SyntheticTexture.h"
+
+int main(int argc, char *argv[])
+{
+    uint32_t aNbIterations = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 50;
+    uint16_t aWidth = static_cast<uint16_t>(argc > 2 ? atoi(argv[2]) : 1024);
+    uint16_t aHeight = static_cast<uint16_t>(argc > 3 ? atoi(argv[3]) : 1024);
+
+    if (aNbIterations == 0 || aWidth == 0 || aHeight == 0)
+    {
+        std::cerr << "usage: texture-bench [iterations] [width] [height]" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Texture " << aWidth << "x" << aHeight << ", best of " << aNbIterations << " iterations" << std::endl;
+
+#ifndef TEXTURE_BENCH_FUNCTION
+    gw2dt::compression::TextureInflater aInflater;
+#endif
+
+    // At most 16 bytes per pixel block
+    std::vector<uint8_t> aOutputVect(((aWidth + 3) / 4) * ((aHeight + 3) / 4) * 16);
+
+    for (const synthetic::TextureFormat &aFormat : synthetic::sFormatTab)
+    {
+        std::vector<uint32_t> aInputVect = synthetic::encodeTexture(aFormat, aWidth, aHeight);
+        uint32_t aInputSize = static_cast<uint32_t>(aInputVect.size() * sizeof(uint32_t));
+        const uint8_t *pInput = reinterpret_cast<const uint8_t *>(aInputVect.data());
+
+        double aBestTime = 0;
+        uint32_t aOutputSize = 0;
+        try
+        {
+            for (uint32_t aIteration = 0; aIteration < aNbIterations; ++aIteration)
+            {
+                aOutputSize = static_cast<uint32_t>(aOutputVect.size());
+
+                auto aStart = std::chrono::steady_clock::now();
+#ifdef TEXTURE_BENCH_FUNCTION
+                gw2dt::compression::inflateTextureFileBuffer(aInputSize, pInput, aOutputSize, aOutputVect.data());
+#else
+                aInflater.inflate(aInputSize, pInput, aOutputSize, aOutputVect.data());
+#endif
+                double aTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - aStart).count();
+
+                aBestTime = aIteration == 0 ? aTime : std::min(aBestTime, aTime);
+            }
+        }
+        catch (std::exception &iException)
+        {
+            std::cerr << aFormat.name << ": " << iException.what() << std::endl;
+            return 1;
+        }
+
+        std::cout << std::left << std::setw(6) << aFormat.name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << aBestTime * 1000 << " ms"
+                  << std::setw(10) << std::setprecision(1) << aOutputSize / aBestTime / (1024 * 1024) << " MB/s" << std::endl;
+    }
+
+    return 0;
+}
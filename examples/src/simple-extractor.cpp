@@ -2,10 +2,12 @@
 #include <cstdint>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <fstream>
 #include <iomanip> // For hex output
 #include <cctype>  // For ASCII printing
-#include <memory>  // For std::unique_ptr
+#include <cstring> // For memcpy
+#include <vector>
 
 #include <gw2dattools/interface/ANDatInterface.h>
 #include <gw2dattools/compression/inflateDatFileBuffer.h>
@@ -35,9 +37,23 @@ void printBuffer(const uint8_t *buffer, uint32_t size, const std::string &label)
     std::cout << std::endl;
 }
 
+// Reads the raw data of a file at the end of a buffer of iBufferSize bytes, throws if the archive ends before it
+void readToBufferEnd(gw2dt::datfile::ANDatInterface &iANDatInterface,
+                     const gw2dt::datfile::ANDatInterface::FileRecord &iFileRecord,
+                     uint32_t iBufferSize,
+                     std::vector<uint8_t> &oBuffer)
+{
+    oBuffer.assign(iBufferSize, 0);
+    uint32_t aSize = iFileRecord.size;
+    iANDatInterface.getBuffer(iFileRecord, aSize, oBuffer.data() + iBufferSize - iFileRecord.size);
+    if (aSize < iFileRecord.size)
+    {
+        throw std::runtime_error("Truncated file.");
+    }
+}
+
 int main(int argc, char *argv[])
 {
-    const uint32_t aBufferSize = 1024 * 1024 * 30; // Assume no file is bigger than 30 Mb
     auto datfile = "Local.dat";
     std::cout << "Filename: " << datfile << std::endl;
 
@@ -47,10 +63,6 @@ int main(int argc, char *argv[])
     auto aFileRecordVect = pANDatInterface->getFileRecordVect();
     std::cout << "Record Size: " << aFileRecordVect.size() << std::endl;
 
-    // Use unique_ptr with array specialization to manage memory automatically
-    std::unique_ptr<uint8_t[]> pOriBuffer = std::make_unique<uint8_t[]>(aBufferSize);
-    std::unique_ptr<uint8_t[]> pInfBuffer = std::make_unique<uint8_t[]>(aBufferSize);
-
     for (const auto &it : aFileRecordVect)
     {
         if (it.fileId != targetFileId) // Process only the target file ID
@@ -58,29 +70,43 @@ int main(int argc, char *argv[])
             continue;
         }
 
-        uint32_t aOriSize = aBufferSize;
-        pANDatInterface->getBuffer(it, aOriSize, pOriBuffer.get()); // Use get() to access the raw pointer
-
         std::cout << "Processing File: " << it.fileId << "\tFile Size: " << it.size << std::endl;
 
-        // Print first 15 bytes of the original (possibly compressed) data
-        printBuffer(pOriBuffer.get(), aOriSize, "Original Data");
+        // The decompressed size is the second word of the compressed data
+        uint8_t aHeader[8] = {0};
+        uint32_t aHeaderSize = sizeof(aHeader);
+        uint32_t aInfSize = 0;
+        if (it.isCompressed)
+        {
+            pANDatInterface->getBuffer(it, aHeaderSize, aHeader);
+            memcpy(&aInfSize, aHeader + 4, sizeof(aInfSize));
+        }
 
-        if (aOriSize == aBufferSize)
+        // Compressed data is inflated in place: a single buffer of about the decompressed size, ending with the compressed data
+        std::vector<uint8_t> aBuffer;
+        try
+        {
+            readToBufferEnd(*pANDatInterface, it, it.isCompressed ? gw2dt::compression::getInPlaceBufferSize(it.size, aInfSize) : it.size, aBuffer);
+        }
+        catch (std::exception &iException)
         {
-            std::cout << "File " << it.fileId << " has a size greater than (or equal to) 30Mb." << std::endl;
+            std::cout << "File " << it.fileId << " failed to read: " << std::string(iException.what()) << std::endl;
+            break;
         }
 
+        // Print first 15 bytes of the original (possibly compressed) data
+        printBuffer(aBuffer.data() + aBuffer.size() - it.size, it.size, "Original Data");
+
         if (it.isCompressed)
         {
-            uint32_t aInfSize = aBufferSize;
-
             try
             {
-                gw2dt::compression::inflateDatFileBuffer(aOriSize, pOriBuffer.get(), aInfSize, pInfBuffer.get());
+                uint32_t aOutputSize = aInfSize;
+                gw2dt::compression::inflateDatFileBufferInPlace(static_cast<uint32_t>(aBuffer.size()), aBuffer.data(), it.size, aOutputSize);
+                aInfSize = aOutputSize;
 
                 // Print first 15 bytes of the decompressed data
-                printBuffer(pInfBuffer.get(), aInfSize, "Decompressed Data");
+                printBuffer(aBuffer.data(), aInfSize, "Decompressed Data");
             }
             catch (std::exception &iException)
             {
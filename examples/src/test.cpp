@@ -77,6 +77,7 @@ int main( int argc, char* argv[] ) {
 
     delete[] pOriBuffer;
     delete[] pInfBuffer;
+    delete[] pOutBuffer;
 
     return 0;
 };
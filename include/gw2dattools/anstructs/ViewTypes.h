@@ -0,0 +1,455 @@
+#ifndef GW2DATTOOLS_ANSTRUCTS_VIEWTYPES_H
+#define GW2DATTOOLS_ANSTRUCTS_VIEWTYPES_H
+
+#include <cstdint>
+#include <cstring>
+
+// Generated at build time, defines GW2DATTOOLS_ANSTRUCTS_POINTER_SIZE
+#include "gw2dattools/anstructs/Config.h"
+
+namespace gw2dt
+{
+    namespace anstructs
+    {
+
+        // Pointers stored in chunks are offsets relative to the address of the pointer itself
+#if GW2DATTOOLS_ANSTRUCTS_POINTER_SIZE == 8
+        typedef int64_t PointerOffset;
+#else
+        typedef int32_t PointerOffset;
+#endif
+
+        template <typename Type>
+        inline Type readValue(const uint8_t *iData)
+        {
+            Type aValue;
+            memcpy(&aValue, iData, sizeof(Type));
+            return aValue;
+        }
+
+        // Returns the address a relative pointer points to, nullptr for a null pointer
+        inline const uint8_t *resolvePointer(const uint8_t *iPointer)
+        {
+            PointerOffset aOffset = readValue<PointerOffset>(iPointer);
+            return aOffset == 0 ? nullptr : iPointer + aOffset;
+        }
+
+#pragma pack(push, 1)
+        struct Byte3
+        {
+            uint8_t data[3];
+        };
+
+        struct Byte4
+        {
+            uint8_t data[4];
+        };
+
+        struct Byte16
+        {
+            uint8_t data[16];
+        };
+
+        struct Word3
+        {
+            uint16_t data[3];
+        };
+
+        struct Dword2
+        {
+            uint32_t data[2];
+        };
+
+        struct Dword4
+        {
+            uint32_t data[4];
+        };
+
+        struct Float2
+        {
+            float data[2];
+        };
+
+        struct Float3
+        {
+            float data[3];
+        };
+
+        struct Float4
+        {
+            float data[4];
+        };
+#pragma pack(pop)
+
+        /**
+         * How an element of an array is read from the chunk.
+         * Views are built on the element address, plain values are copied out.
+         */
+        template <typename Type>
+        struct ElementTraits
+        {
+            typedef Type ValueType;
+            static const uint32_t size = Type::structSize;
+
+            static Type get(const uint8_t *iData)
+            {
+                return Type(iData);
+            }
+        };
+
+        template <typename Type>
+        struct ValueElementTraits
+        {
+            typedef Type ValueType;
+            static const uint32_t size = sizeof(Type);
+
+            static Type get(const uint8_t *iData)
+            {
+                return readValue<Type>(iData);
+            }
+        };
+
+        template <> struct ElementTraits<uint8_t> : ValueElementTraits<uint8_t> {};
+        template <> struct ElementTraits<uint16_t> : ValueElementTraits<uint16_t> {};
+        template <> struct ElementTraits<uint32_t> : ValueElementTraits<uint32_t> {};
+        template <> struct ElementTraits<uint64_t> : ValueElementTraits<uint64_t> {};
+        template <> struct ElementTraits<float> : ValueElementTraits<float> {};
+        template <> struct ElementTraits<double> : ValueElementTraits<double> {};
+        template <> struct ElementTraits<Byte3> : ValueElementTraits<Byte3> {};
+        template <> struct ElementTraits<Byte4> : ValueElementTraits<Byte4> {};
+        template <> struct ElementTraits<Byte16> : ValueElementTraits<Byte16> {};
+        template <> struct ElementTraits<Word3> : ValueElementTraits<Word3> {};
+        template <> struct ElementTraits<Dword2> : ValueElementTraits<Dword2> {};
+        template <> struct ElementTraits<Dword4> : ValueElementTraits<Dword4> {};
+        template <> struct ElementTraits<Float2> : ValueElementTraits<Float2> {};
+        template <> struct ElementTraits<Float3> : ValueElementTraits<Float3> {};
+        template <> struct ElementTraits<Float4> : ValueElementTraits<Float4> {};
+
+        /**
+         * Pointer to a single element, resolved when accessed.
+         */
+        template <typename Type>
+        class Ptr
+        {
+        public:
+            static const uint32_t structSize = sizeof(PointerOffset);
+
+            explicit Ptr(const uint8_t *iData) : _data(iData)
+            {
+            }
+
+            bool isNull() const
+            {
+                return resolvePointer(_data) == nullptr;
+            }
+
+            // Must not be called on a null pointer
+            typename ElementTraits<Type>::ValueType get() const
+            {
+                return ElementTraits<Type>::get(resolvePointer(_data));
+            }
+
+            const uint8_t *getData() const
+            {
+                return _data;
+            }
+
+        private:
+            const uint8_t *_data;
+        };
+
+        /**
+         * Counted array stored elsewhere in the chunk: a 32-bit count followed by a pointer to the elements.
+         */
+        template <typename Type>
+        class ArrayView
+        {
+        public:
+            static const uint32_t structSize = sizeof(uint32_t) + sizeof(PointerOffset);
+
+            explicit ArrayView(const uint8_t *iData) : _data(iData)
+            {
+            }
+
+            uint32_t size() const
+            {
+                return getElements() == nullptr ? 0 : readValue<uint32_t>(_data);
+            }
+
+            bool empty() const
+            {
+                return size() == 0;
+            }
+
+            typename ElementTraits<Type>::ValueType operator[](uint32_t iIndex) const
+            {
+                return ElementTraits<Type>::get(getElements() + iIndex * ElementTraits<Type>::size);
+            }
+
+            // Address of the first element, nullptr for an empty array
+            const uint8_t *getElements() const
+            {
+                return resolvePointer(_data + sizeof(uint32_t));
+            }
+
+            const uint8_t *getData() const
+            {
+                return _data;
+            }
+
+        private:
+            const uint8_t *_data;
+        };
+
+        /**
+         * Counted array of pointers, each element may be null.
+         */
+        template <typename Type>
+        class PtrArrayView
+        {
+        public:
+            static const uint32_t structSize = sizeof(uint32_t) + sizeof(PointerOffset);
+
+            explicit PtrArrayView(const uint8_t *iData) : _data(iData)
+            {
+            }
+
+            uint32_t size() const
+            {
+                return resolvePointer(_data + sizeof(uint32_t)) == nullptr ? 0 : readValue<uint32_t>(_data);
+            }
+
+            bool empty() const
+            {
+                return size() == 0;
+            }
+
+            Ptr<Type> operator[](uint32_t iIndex) const
+            {
+                return Ptr<Type>(getElements() + iIndex * sizeof(PointerOffset));
+            }
+
+            // Address of the first pointer, nullptr for an empty array
+            const uint8_t *getElements() const
+            {
+                return resolvePointer(_data + sizeof(uint32_t));
+            }
+
+            const uint8_t *getData() const
+            {
+                return _data;
+            }
+
+        private:
+            const uint8_t *_data;
+        };
+
+        /**
+         * Reference to another file of the archive.
+         */
+        class Filename
+        {
+        public:
+            static const uint32_t structSize = sizeof(PointerOffset);
+
+            explicit Filename(const uint8_t *iData) : _data(iData)
+            {
+            }
+
+            // Base id of the referenced file, 0 when there is none
+            uint32_t getFileId() const
+            {
+                const uint8_t *aValue = resolvePointer(_data);
+                if (aValue == nullptr)
+                {
+                    return 0;
+                }
+
+                uint16_t aLowValue = readValue<uint16_t>(aValue);
+                uint16_t aHighValue = readValue<uint16_t>(aValue + sizeof(uint16_t));
+                if (aLowValue < 0x100 || aHighValue < 0x100)
+                {
+                    return 0;
+                }
+                return 0xFF00 * (aHighValue - 0x100) + (aLowValue - 0x100) + 1;
+            }
+
+            const uint8_t *getData() const
+            {
+                return _data;
+            }
+
+        private:
+            const uint8_t *_data;
+        };
+
+        /**
+         * Pointer to a null-terminated string.
+         */
+        template <typename CharType>
+        class StringPtr
+        {
+        public:
+            static const uint32_t structSize = sizeof(PointerOffset);
+
+            explicit StringPtr(const uint8_t *iData) : _data(iData)
+            {
+            }
+
+            // nullptr when the pointer is null
+            const CharType *get() const
+            {
+                return reinterpret_cast<const CharType *>(resolvePointer(_data));
+            }
+
+        private:
+            const uint8_t *_data;
+        };
+
+        typedef StringPtr<char> CharPtr;
+        typedef StringPtr<char16_t> WCharPtr;
+
+        /**
+         * Memory range a traversal of untrusted chunk data may read.
+         */
+        class Bounds
+        {
+        public:
+            Bounds(const uint8_t *iData, uint32_t iSize) : _begin(reinterpret_cast<uintptr_t>(iData)), _end(_begin + iSize)
+            {
+            }
+
+            // True if the iSize bytes at iData are all within the range
+            bool contains(const uint8_t *iData, uint64_t iSize) const
+            {
+                uintptr_t aAddress = reinterpret_cast<uintptr_t>(iData);
+                return aAddress >= _begin && aAddress <= _end && iSize <= _end - aAddress;
+            }
+
+        private:
+            uintptr_t _begin;
+            uintptr_t _end;
+        };
+
+        // Walks the fields of type filename reachable from a field, the generated views provide
+        // a visitFilenames method for the structures holding such fields.
+        // Each returns false as soon as the walk would leave iBounds.
+
+        template <typename Type, typename Visitor>
+        bool visitFilenames(const Bounds &iBounds, const Type &iView, Visitor &ioVisitor);
+
+        template <typename Visitor>
+        bool visitFilenames(const Bounds &iBounds, const Filename &iFilename, Visitor &ioVisitor);
+
+        template <typename Type, typename Visitor>
+        bool visitFilenames(const Bounds &iBounds, const Ptr<Type> &iPtr, Visitor &ioVisitor);
+
+        template <typename Type, typename Visitor>
+        bool visitFilenames(const Bounds &iBounds, const ArrayView<Type> &iArray, Visitor &ioVisitor);
+
+        template <typename Type, typename Visitor>
+        bool visitFilenames(const Bounds &iBounds, const PtrArrayView<Type> &iArray, Visitor &ioVisitor);
+
+        template <typename Type, typename Visitor>
+        bool visitFilenames(const Bounds &iBounds, const Type &iView, Visitor &ioVisitor)
+        {
+            return iView.visitFilenames(iBounds, ioVisitor);
+        }
+
+        // Calls ioVisitor with the base id of the referenced file, if any
+        template <typename Visitor>
+        bool visitFilenames(const Bounds &iBounds, const Filename &iFilename, Visitor &ioVisitor)
+        {
+            if (!iBounds.contains(iFilename.getData(), Filename::structSize))
+            {
+                return false;
+            }
+
+            const uint8_t *aValue = resolvePointer(iFilename.getData());
+            if (aValue == nullptr)
+            {
+                return true;
+            }
+
+            if (!iBounds.contains(aValue, 2 * sizeof(uint16_t)))
+            {
+                return false;
+            }
+
+            uint32_t aFileId = iFilename.getFileId();
+            if (aFileId != 0)
+            {
+                ioVisitor(aFileId);
+            }
+            return true;
+        }
+
+        template <typename Type, typename Visitor>
+        bool visitFilenames(const Bounds &iBounds, const Ptr<Type> &iPtr, Visitor &ioVisitor)
+        {
+            if (!iBounds.contains(iPtr.getData(), Ptr<Type>::structSize))
+            {
+                return false;
+            }
+
+            const uint8_t *aElement = resolvePointer(iPtr.getData());
+            if (aElement == nullptr)
+            {
+                return true;
+            }
+
+            return iBounds.contains(aElement, ElementTraits<Type>::size) && visitFilenames(iBounds, iPtr.get(), ioVisitor);
+        }
+
+        template <typename Type, typename Visitor>
+        bool visitFilenames(const Bounds &iBounds, const ArrayView<Type> &iArray, Visitor &ioVisitor)
+        {
+            if (!iBounds.contains(iArray.getData(), ArrayView<Type>::structSize))
+            {
+                return false;
+            }
+
+            uint32_t aSize = iArray.size();
+            if (!iBounds.contains(iArray.getElements(), static_cast<uint64_t>(aSize) * ElementTraits<Type>::size))
+            {
+                return aSize == 0;
+            }
+
+            for (uint32_t aIndex = 0; aIndex < aSize; ++aIndex)
+            {
+                if (!visitFilenames(iBounds, iArray[aIndex], ioVisitor))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <typename Type, typename Visitor>
+        bool visitFilenames(const Bounds &iBounds, const PtrArrayView<Type> &iArray, Visitor &ioVisitor)
+        {
+            if (!iBounds.contains(iArray.getData(), PtrArrayView<Type>::structSize))
+            {
+                return false;
+            }
+
+            uint32_t aSize = iArray.size();
+            if (!iBounds.contains(iArray.getElements(), static_cast<uint64_t>(aSize) * sizeof(PointerOffset)))
+            {
+                return aSize == 0;
+            }
+
+            for (uint32_t aIndex = 0; aIndex < aSize; ++aIndex)
+            {
+                if (!visitFilenames(iBounds, iArray[aIndex], ioVisitor))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    } // namespace anstructs
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_ANSTRUCTS_VIEWTYPES_H
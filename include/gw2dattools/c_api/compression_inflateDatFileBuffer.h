@@ -10,6 +10,16 @@ extern "C"
 {
 #endif
 
+    /**
+     * @brief Allocates the output buffers of the inflate functions, see gw2dt::compression::Allocator.
+     */
+    typedef struct compression_Allocator
+    {
+        void *(*allocate)(void *iContext, uint32_t iSize); /* Returns NULL on failure */
+        void (*release)(void *iContext, void *ipBuffer);
+        void *context;
+    } compression_Allocator;
+
     /**
      * @brief Inflates a compressed buffer.
      *
@@ -31,11 +41,27 @@ extern "C"
      * @return uint8_t*    Pointer to the output buffer, which may be different from `ioOutputTab`
      *                     if memory was allocated internally. Returns NULL if decompression fails.
      */
-    GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY compression_inflateBuffer(
+    GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY compression_inflateDatFileBuffer(
+        const uint32_t iInputSize,
+        const uint8_t *iInputTab,
+        uint32_t *ioOutputSize,
+        uint8_t *ioOutputTab);
+
+    /**
+     * @brief Inflates a compressed buffer into a buffer of an allocator.
+     *
+     * @param iInputSize   Size of the input buffer in bytes.
+     * @param iInputTab    Pointer to the compressed input buffer.
+     * @param ioOutputSize Pointer to the maximum number of bytes to decode if non-zero on input, size of the
+     *                     decompressed data on output.
+     * @param iAllocator   Allocator of the output buffer, the caller releases the buffer with it.
+     * @return uint8_t*    Pointer to the output buffer. Returns NULL if decompression or allocation fails.
+     */
+    GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY compression_inflateDatFileBufferWithAllocator(
         const uint32_t iInputSize,
         const uint8_t *iInputTab,
         uint32_t *ioOutputSize,
-        uint8_t *ioOutputTab = NULL);
+        const compression_Allocator *iAllocator);
 
 #ifdef __cplusplus
 }
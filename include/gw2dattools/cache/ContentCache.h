@@ -0,0 +1,108 @@
+#ifndef GW2DATTOOLS_CACHE_CONTENTCACHE_H
+#define GW2DATTOOLS_CACHE_CONTENTCACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gw2dattools/dllMacros.h"
+#include "gw2dattools/interface/ANDatInterface.h"
+
+namespace gw2dt
+{
+    namespace cache
+    {
+
+        /**
+         * @brief Persistent cache of inflated file contents.
+         *
+         * The content of a compressed file is stored uncompressed in a file of its own, named after the
+         * fileId and tagged with the MFT crc of the stored file: an entry is only used while the crc of
+         * the archive matches, and is replaced when the file changes. Reading an entry back is a plain
+         * read, which avoids inflateDatFileBuffer entirely. Entries are checked against their file size
+         * and a hash of the content, a damaged entry is a miss.
+         *
+         * Files without a crc, uncompressed files and files whose content is too small to be worth a
+         * file of their own are not cached. The cache can be shared by threads and processes.
+         */
+        class GW2DATTOOLS_API ContentCache
+        {
+        public:
+            static const uint32_t DefaultMinContentSize = 4096;
+
+            /**
+             * @param iDirectory      Directory of the cache, created if needed.
+             * @param iMinContentSize Contents smaller than this are not cached, inflating them is cheaper
+             *                        than opening a file.
+             */
+            ContentCache(const char *iDirectory, uint32_t iMinContentSize = DefaultMinContentSize);
+
+            // Whether the content of a file can be cached, its size aside
+            bool isCacheable(const datfile::ANDatInterface::FileRecord &iFileRecord) const;
+
+            /**
+             * @brief Reads the size of the cached content of a file, without reading the content.
+             *
+             * Lets a caller reserve memory for the content before lookup reads it. Only the header of the
+             * entry is checked, the content may still turn out damaged. Not counted as a hit or a miss.
+             *
+             * @param iFileRecord  File to look up.
+             * @param oContentSize Size of the content.
+             * @return bool        True if the cache has an entry for this version of the file.
+             */
+            bool peekContentSize(const datfile::ANDatInterface::FileRecord &iFileRecord, uint32_t &oContentSize) const;
+
+            /**
+             * @brief Reads the cached content of a file.
+             *
+             * @param iFileRecord     File to look up.
+             * @param ioContentBuffer Buffer receiving the content, enlarged if needed.
+             * @param oContentSize    Size of the content.
+             * @return bool           True if the cache has the content of this version of the file.
+             */
+            bool lookup(const datfile::ANDatInterface::FileRecord &iFileRecord, std::vector<uint8_t> &ioContentBuffer, uint32_t &oContentSize);
+
+            /**
+             * @brief Stores the content of a file, failures are ignored as the content can be inflated again.
+             *
+             * @param iFileRecord  File the content belongs to.
+             * @param iContentSize Size of the content in bytes.
+             * @param iContent     Inflated content.
+             * @return bool        True if the content was stored.
+             */
+            bool store(const datfile::ANDatInterface::FileRecord &iFileRecord, uint32_t iContentSize, const uint8_t *iContent);
+
+            /**
+             * @brief Reads the content of a file from the cache, or from the archive, caching it.
+             *
+             * @param iANDatInterface Archive to read from on a miss.
+             * @param iFileRecord     File to read.
+             * @param ioInputBuffer   Buffer receiving the raw data, reused between calls.
+             * @param ioContentBuffer Buffer receiving the content, reused between calls.
+             * @return uint32_t       Size of the content, the buffer may be larger.
+             * @throws gw2dt::exception::Exception If the file cannot be read or inflated.
+             */
+            uint32_t readFileContent(datfile::ANDatInterface &iANDatInterface,
+                                     const datfile::ANDatInterface::FileRecord &iFileRecord,
+                                     std::vector<uint8_t> &ioInputBuffer,
+                                     std::vector<uint8_t> &ioContentBuffer);
+
+            uint64_t getNbOfHits() const;
+            uint64_t getNbOfMisses() const;
+
+        private:
+            std::string getPath(uint32_t iFileId) const;
+
+            std::string _directory;
+            uint32_t _minContentSize;
+
+            std::atomic<uint64_t> _nbOfHits;
+            std::atomic<uint64_t> _nbOfMisses;
+            std::atomic<uint32_t> _nbOfStores;
+        };
+
+    } // namespace cache
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_CACHE_CONTENTCACHE_H
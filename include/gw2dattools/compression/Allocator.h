@@ -0,0 +1,35 @@
+#ifndef GW2DATTOOLS_COMPRESSION_ALLOCATOR_H
+#define GW2DATTOOLS_COMPRESSION_ALLOCATOR_H
+
+#include <cstdint>
+#include "gw2dattools/dllMacros.h"
+
+namespace gw2dt
+{
+    namespace compression
+    {
+
+        /**
+         * @brief Allocates the output buffers of the inflate functions.
+         *
+         * The callbacks receive the context, which lets them allocate from an arena, a pool or pinned
+         * memory. A buffer returned by the inflate functions is released with the callback of the
+         * allocator it was given; on failure, the inflate functions release what they allocated.
+         * The release callback may do nothing, e.g. for an arena freed as a whole.
+         */
+        struct Allocator
+        {
+            void *(*allocate)(void *iContext, uint32_t iSize); // Returns null on failure
+            void (*release)(void *iContext, void *ipBuffer);
+            void *context;
+        };
+
+        /**
+         * @brief Returns the allocator used when no output buffer is given: malloc and free.
+         */
+        GW2DATTOOLS_API const Allocator &GW2DATTOOLS_APIENTRY getDefaultAllocator();
+
+    } // namespace compression
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_COMPRESSION_ALLOCATOR_H
@@ -0,0 +1,87 @@
+#ifndef GW2DATTOOLS_COMPRESSION_INFLATEDATFILEBATCH_H
+#define GW2DATTOOLS_COMPRESSION_INFLATEDATFILEBATCH_H
+
+#include <cstdint>
+#include <vector>
+#include "gw2dattools/dllMacros.h"
+#include "gw2dattools/compression/Allocator.h"
+
+namespace gw2dt
+{
+    namespace compression
+    {
+
+        struct BatchInput
+        {
+            uint32_t size;
+            const uint8_t *data; // Compressed data, as stored in the archive
+        };
+
+        /**
+         * @brief Contents of a batch of files, decoded into a single arena.
+         *
+         * The arena is one allocation of the allocator given to inflateDatFileBatch, released at once
+         * when the batch is destroyed. The contents are slices of it, aligned on BatchAlignment bytes
+         * whatever the alignment of the allocation: the arena has room to align its first slice.
+         */
+        class GW2DATTOOLS_API DecodedBatch
+        {
+        public:
+            static const uint32_t BatchAlignment = 16;
+
+            struct Span
+            {
+                uint32_t offset; // Offset of the content in the arena
+                uint32_t size;   // Size of the content, as announced by the header of the compressed data, 0 if the
+                                 // header is missing or announces more than the compressed data can hold
+                bool isDecoded;  // False if the data could not be decoded, the slice content is then undefined;
+                                 // true for an empty content
+            };
+
+            DecodedBatch(uint8_t *ipArena, uint32_t iArenaSize, const Allocator &iAllocator, std::vector<Span> iSpanVect);
+            DecodedBatch(DecodedBatch &&ioBatch);
+            DecodedBatch &operator=(DecodedBatch &&ioBatch);
+            ~DecodedBatch();
+
+            DecodedBatch(const DecodedBatch &) = delete;
+            DecodedBatch &operator=(const DecodedBatch &) = delete;
+
+            // In the order of the inputs
+            const std::vector<Span> &getSpanVect() const;
+
+            const uint8_t *getContent(uint32_t iIndex) const;
+            uint32_t getArenaSize() const;
+
+        private:
+            uint8_t *_pArena;
+            uint32_t _arenaSize;
+            Allocator _allocator;
+            std::vector<Span> _spanVect;
+        };
+
+        /**
+         * @brief Inflates a batch of compressed files into a single arena.
+         *
+         * The content sizes are read from the 12-byte header of each compressed file first, so that the
+         * arena is allocated once and each file decoded directly into its slice: decoding the batch does
+         * a single allocation for the contents whatever the number of files. A file which cannot be
+         * decoded is flagged in its span rather than failing the batch, and so is a file whose header
+         * announces a content larger than its compressed data can expand to, which gets no room in the
+         * arena: a corrupt header cannot make the batch allocate gigabytes.
+         *
+         * @param iInputVect  Compressed files.
+         * @param iNbThreads  Number of decoding threads, 0 to use one per hardware thread.
+         * @param iAllocator  Allocator of the arena.
+         * @return DecodedBatch Contents of the files.
+         * @throws gw2dt::exception::Exception If the contents exceed 4 GB.
+         * @throws std::bad_alloc If the allocator returns null.
+         */
+        GW2DATTOOLS_API DecodedBatch GW2DATTOOLS_APIENTRY inflateDatFileBatch(
+            const std::vector<BatchInput> &iInputVect,
+            uint32_t iNbThreads = 1,
+            const Allocator &iAllocator = getDefaultAllocator());
+
+    } // namespace compression
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_COMPRESSION_INFLATEDATFILEBATCH_H
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <string>
 #include "gw2dattools/dllMacros.h"
+#include "gw2dattools/compression/Allocator.h"
 
 namespace gw2dt
 {
@@ -36,6 +37,69 @@ namespace gw2dt
             uint32_t &ioOutputSize,
             uint8_t *ioOutputTab = nullptr);
 
+        /**
+         * @brief Inflates a compressed data buffer into a buffer of an allocator.
+         *
+         * @param iInputSize   Size of the input buffer in bytes.
+         * @param iInputTab    Pointer to the compressed input buffer.
+         * @param ioOutputSize Reference to the maximum number of bytes to decode if non-zero on input, size of the
+         *                     decompressed data on output.
+         * @param iAllocator   Allocator of the output buffer, the caller releases the buffer with it.
+         * @return uint8_t*    Pointer to the output buffer.
+         * @throws std::bad_alloc If the allocator returns null.
+         * @throws std::exception If decompression fails due to invalid parameters or data.
+         */
+        GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY inflateDatFileBuffer(
+            uint32_t iInputSize,
+            const uint8_t *iInputTab,
+            uint32_t &ioOutputSize,
+            const Allocator &iAllocator);
+
+        /**
+         * @brief Returns the size of a buffer in which a compressed data buffer can be inflated in place.
+         *
+         * The size is derived from the worst case of the format, so that the output never catches up with
+         * the compressed data not read yet: a single byte of output may take up to 11 bytes of compressed
+         * data, so only about an eleventh of the compressed size can be saved over separate buffers. Placed
+         * at the end of a buffer of this size, compressed data is aligned on a word if the buffer is.
+         *
+         * The bound holds for compressed data ending at most 64 bytes after its last code, which is the
+         * case of the files of the archives. Data followed by more bytes needs a buffer of the compressed
+         * plus the decompressed size.
+         *
+         * @param iInputSize  Size of the compressed data in bytes.
+         * @param iOutputSize Size of the decompressed data, read from the second word of the compressed data.
+         * @return uint32_t   Size of the buffer in bytes.
+         * @throws gw2dt::exception::Exception If the size exceeds 4 GB.
+         */
+        GW2DATTOOLS_API uint32_t GW2DATTOOLS_APIENTRY getInPlaceBufferSize(
+            uint32_t iInputSize,
+            uint32_t iOutputSize);
+
+        /**
+         * @brief Inflates a compressed data buffer in place.
+         *
+         * The compressed data occupies the last iInputSize bytes of the buffer and is inflated to the start
+         * of the same buffer, so that a single buffer of about the decompressed size is needed instead of
+         * two. Every write is checked against the compressed data not read yet: decoding fails rather than
+         * overwrite it. A buffer of getInPlaceBufferSize bytes never fails for lack of room, see there for its
+         * limit, nor does one of at least the compressed plus the decompressed size.
+         *
+         * @param iBufferSize  Size of the buffer in bytes.
+         * @param ioBuffer     Buffer ending with the compressed data, starting with the decompressed data on
+         *                     return. Its content is undefined if decompression fails.
+         * @param iInputSize   Size of the compressed data in bytes.
+         * @param ioOutputSize Reference to the maximum number of bytes to decode if non-zero on input, size of the
+         *                     decompressed data on output.
+         * @throws std::exception If decompression fails due to invalid parameters or data, or if the buffer is too
+         *                        small for the decompressed data to stay behind the compressed data.
+         */
+        GW2DATTOOLS_API void GW2DATTOOLS_APIENTRY inflateDatFileBufferInPlace(
+            uint32_t iBufferSize,
+            uint8_t *ioBuffer,
+            uint32_t iInputSize,
+            uint32_t &ioOutputSize);
+
     } // namespace compression
 } // namespace gw2dt
 
@@ -2,8 +2,10 @@
 #define GW2DATTOOLS_COMPRESSION_INFLATETEXTUREFILEBUFFER_H
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include "gw2dattools/dllMacros.h"
+#include "gw2dattools/compression/Allocator.h"
 
 namespace gw2dt
 {
@@ -37,6 +39,46 @@ namespace gw2dt
             uint32_t &ioOutputSize,
             uint8_t *ioOutputTab = nullptr);
 
+        /**
+         * @brief Inflates a compressed texture file buffer into a buffer of an allocator.
+         *
+         * @param iInputSize   Size of the input buffer in bytes.
+         * @param iInputTab    Pointer to the compressed input buffer.
+         * @param ioOutputSize Reference to the size of the output buffer if non-zero on input, size of the
+         *                     decompressed data on output.
+         * @param iAllocator   Allocator of the output buffer, the caller releases the buffer with it.
+         * @return uint8_t*    Pointer to the output buffer.
+         * @throws std::bad_alloc If the allocator returns null.
+         * @throws std::exception If decompression fails due to invalid parameters or data.
+         */
+        GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY inflateTextureFileBuffer(
+            uint32_t iInputSize,
+            const uint8_t *iInputTab,
+            uint32_t &ioOutputSize,
+            const Allocator &iAllocator);
+
+        /**
+         * @brief Reads the header of a texture file buffer.
+         *
+         * Only the first 12 bytes of the buffer are read: the magic, the FourCC code of the
+         * format and the dimensions, as parsed by inflateTextureFileBuffer.
+         *
+         * @param iInputSize    Size of the input buffer in bytes.
+         * @param iInputTab     Pointer to the texture file buffer.
+         * @param oMagic        Magic of the file (ATEX, ATTX, ATEC, ATEP, ATEU or ATET).
+         * @param oFormatFourCc FourCC code describing the format of the texture data.
+         * @param oWidth        Width of the texture in pixels.
+         * @param oHeight       Height of the texture in pixels.
+         * @return bool         True if the buffer starts with a texture header, false otherwise.
+         */
+        GW2DATTOOLS_API bool GW2DATTOOLS_APIENTRY readTextureFileHeader(
+            uint32_t iInputSize,
+            const uint8_t *iInputTab,
+            uint32_t &oMagic,
+            uint32_t &oFormatFourCc,
+            uint16_t &oWidth,
+            uint16_t &oHeight);
+
         /**
          * @brief Inflates a compressed texture block buffer.
          *
@@ -70,6 +112,86 @@ namespace gw2dt
             uint32_t &ioOutputSize,
             uint8_t *ioOutputTab = nullptr);
 
+        /**
+         * @brief Inflates a compressed texture block buffer into a buffer of an allocator.
+         *
+         * @param iWidth       Width of the texture in pixels.
+         * @param iHeight      Height of the texture in pixels.
+         * @param iFormatFourCc FourCC code describing the format of the texture data.
+         * @param iInputSize   Size of the input buffer in bytes.
+         * @param iInputTab    Pointer to the compressed input buffer.
+         * @param ioOutputSize Reference to the size of the output buffer if non-zero on input, size of the
+         *                     decompressed data on output.
+         * @param iAllocator   Allocator of the output buffer, the caller releases the buffer with it.
+         * @return uint8_t*    Pointer to the output buffer.
+         * @throws std::bad_alloc If the allocator returns null.
+         * @throws std::exception If decompression fails due to invalid parameters or data.
+         */
+        GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY inflateTextureBlockBuffer(
+            uint16_t iWidth,
+            uint16_t iHeight,
+            uint32_t iFormatFourCc,
+            uint32_t iInputSize,
+            const uint8_t *iInputTab,
+            uint32_t &ioOutputSize,
+            const Allocator &iAllocator);
+
+        /**
+         * @brief Inflates compressed textures, reusing its scratch space between calls.
+         *
+         * Equivalent to inflateTextureFileBuffer and inflateTextureBlockBuffer, for callers inflating
+         * many textures in a row. An inflater is not thread-safe, use one per thread.
+         */
+        class GW2DATTOOLS_API TextureInflater
+        {
+        public:
+            /**
+             * @param iAllocator Allocator of the output buffers, when no output buffer is given.
+             */
+            explicit TextureInflater(const Allocator &iAllocator = getDefaultAllocator());
+            ~TextureInflater();
+
+            TextureInflater(const TextureInflater &) = delete;
+            TextureInflater &operator=(const TextureInflater &) = delete;
+
+            /**
+             * @brief Inflates a compressed texture file buffer, see inflateTextureFileBuffer.
+             *
+             * @param iInputSize   Size of the input buffer in bytes.
+             * @param iInputTab    Pointer to the compressed input buffer.
+             * @param ioOutputSize Reference to the size of the output buffer if non-zero on input, size of the
+             *                     decompressed data on output.
+             * @param ioOutputTab  Optional output buffer, if null the buffer is allocated with the allocator of
+             *                     the inflater and the caller releases it with it.
+             * @return uint8_t*    Pointer to the output buffer.
+             * @throws std::bad_alloc If the allocator returns null.
+             * @throws std::exception If decompression fails due to invalid parameters or data.
+             */
+            uint8_t *inflate(uint32_t iInputSize, const uint8_t *iInputTab, uint32_t &ioOutputSize, uint8_t *ioOutputTab = nullptr);
+
+            /**
+             * @brief Inflates a compressed texture block buffer, see inflateTextureBlockBuffer.
+             *
+             * @param iWidth        Width of the texture in pixels.
+             * @param iHeight       Height of the texture in pixels.
+             * @param iFormatFourCc FourCC code describing the format of the texture data.
+             * @param iInputSize    Size of the input buffer in bytes.
+             * @param iInputTab     Pointer to the compressed input buffer.
+             * @param ioOutputSize  Reference to the size of the output buffer if non-zero on input, size of the
+             *                      decompressed data on output.
+             * @param ioOutputTab   Optional output buffer, as for inflate.
+             * @return uint8_t*     Pointer to the output buffer.
+             * @throws std::bad_alloc If the allocator returns null.
+             * @throws std::exception If decompression fails due to invalid parameters or data.
+             */
+            uint8_t *inflateBlocks(uint16_t iWidth, uint16_t iHeight, uint32_t iFormatFourCc, uint32_t iInputSize, const uint8_t *iInputTab,
+                                   uint32_t &ioOutputSize, uint8_t *ioOutputTab = nullptr);
+
+        private:
+            struct Context;
+            std::unique_ptr<Context> _pContext;
+        };
+
     } // namespace compression
 } // namespace gw2dt
 
@@ -0,0 +1,143 @@
+#ifndef GW2DATTOOLS_CONTAINER_EXPORTCONTAINER_H
+#define GW2DATTOOLS_CONTAINER_EXPORTCONTAINER_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "gw2dattools/dllMacros.h"
+
+namespace gw2dt
+{
+    namespace container
+    {
+
+        /*
+         * An export container stores many files in one file written front to back:
+         *  - a 16-byte header,
+         *  - for each file, a 16-byte entry header followed by the data, padded to 16 bytes,
+         *  - the index, an array of ContainerEntry sorted by fileId,
+         *  - a 24-byte trailer giving the offset of the index.
+         * The index is aligned and stored as it is in memory, so it can be mapped directly. The entry
+         * headers let the files be recovered by a linear scan when the index is missing.
+         */
+
+        // Files are aligned on this many bytes in the container
+        static const uint32_t ContainerAlignment = 16;
+
+        enum ContainerEntryFlags
+        {
+            CEF_TEXTURE = 1 // Pixel blocks of a texture file rather than its content
+        };
+
+#pragma pack(push, 1)
+        struct ContainerEntry
+        {
+            uint64_t offset; // Offset of the data in the container
+            uint32_t fileId;
+            uint32_t size;
+            uint32_t flags;
+            uint32_t reserved;
+        };
+#pragma pack(pop)
+
+        /**
+         * @brief Appends files to a container through a large buffer.
+         *
+         * The data is copied to the buffer, which is written whenever it is full: the writes to the
+         * disk are all of the size of the buffer, at offsets multiple of it, except the last one.
+         * Files can be added concurrently from several threads.
+         */
+        class GW2DATTOOLS_API ContainerWriter
+        {
+        public:
+            static const uint32_t DefaultBufferSize = 8 * 1024 * 1024;
+
+            /**
+             * @param iPath       Path of the container, overwritten if it exists.
+             * @param iBufferSize Size of the write buffer, rounded up to a multiple of 4096.
+             * @throws gw2dt::exception::Exception If the file cannot be opened.
+             */
+            ContainerWriter(const char *iPath, uint32_t iBufferSize = DefaultBufferSize);
+
+            /**
+             * @brief Appends a file.
+             *
+             * @param iFileId Id of the file.
+             * @param iFlags  Combination of ContainerEntryFlags.
+             * @param iSize   Size of the data in bytes.
+             * @param iData   Data of the file.
+             * @throws gw2dt::exception::Exception If the container cannot be written or is finished.
+             */
+            void add(uint32_t iFileId, uint32_t iFlags, uint32_t iSize, const uint8_t *iData);
+
+            /**
+             * @brief Writes the index and the trailer. A container which is not finished has no index.
+             *
+             * @throws gw2dt::exception::Exception If the container cannot be written.
+             */
+            void finish();
+
+            // Bytes appended so far, buffered ones included
+            uint64_t getSize() const;
+
+        private:
+            void append(uint32_t iSize, const uint8_t *iData);
+            void flush();
+
+            std::ofstream _stream;
+            std::unique_ptr<uint8_t[]> _pBuffer;
+            uint32_t _bufferSize;
+            uint32_t _bufferUsedSize;
+            uint64_t _size;
+            bool _isFinished;
+
+            std::vector<ContainerEntry> _entryVect;
+            mutable std::mutex _mutex;
+        };
+
+        /**
+         * @brief Reads the files of a finished container without extracting it.
+         */
+        class GW2DATTOOLS_API ContainerReader
+        {
+        public:
+            /**
+             * @param iPath Path of the container.
+             * @throws gw2dt::exception::Exception If the file is not a finished container.
+             */
+            explicit ContainerReader(const char *iPath);
+
+            // Sorted by fileId
+            const std::vector<ContainerEntry> &getEntryVect() const;
+
+            /**
+             * @brief Finds the entry of a file.
+             *
+             * @param iFileId Id of the file.
+             * @return const ContainerEntry* Entry of the file, nullptr if it is not in the container.
+             */
+            const ContainerEntry *findEntry(uint32_t iFileId) const;
+
+            /**
+             * @brief Reads the data of a file, can be called concurrently from several threads.
+             *
+             * @param iEntry       Entry of the file.
+             * @param ioOutputSize Size of the buffer on input, number of bytes read on output.
+             * @param ioBuffer     Buffer receiving the data.
+             * @throws gw2dt::exception::Exception If the data cannot be read.
+             */
+            void getBuffer(const ContainerEntry &iEntry, uint32_t &ioOutputSize, uint8_t *ioBuffer);
+
+        private:
+            std::ifstream _stream;
+            std::vector<ContainerEntry> _entryVect;
+            std::mutex _mutex;
+        };
+
+    } // namespace container
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_CONTAINER_EXPORTCONTAINER_H
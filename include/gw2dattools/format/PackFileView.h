@@ -0,0 +1,88 @@
+#ifndef GW2DATTOOLS_FORMAT_PACKFILEVIEW_H
+#define GW2DATTOOLS_FORMAT_PACKFILEVIEW_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "gw2dattools/dllMacros.h"
+
+namespace gw2dt
+{
+    namespace format
+    {
+
+        /**
+         * @brief Read-only view of a PackFile (PF) held in memory.
+         *
+         * The view only records where the chunks are, the chunk contents are never copied and
+         * stay in the buffer given at construction, which must outlive the view.
+         */
+        class GW2DATTOOLS_API PackFileView
+        {
+        public:
+            struct Chunk
+            {
+                uint32_t magic;
+                uint16_t version;
+                uint16_t headerSize;
+
+                // Chunk data, offsets of the offset table are relative to its start
+                const uint8_t *data;
+                uint32_t dataSize;
+
+                // Offset table, nullptr when the chunk does not have one; its entries are not aligned, read them with getOffset
+                const uint8_t *offsetTab;
+                uint32_t nbOfOffsets;
+
+                // Whole chunk, header included
+                const uint8_t *begin;
+                uint32_t size;
+
+                // Entry iIndex of the offset table, iIndex being below nbOfOffsets
+                uint32_t getOffset(uint32_t iIndex) const;
+            };
+
+            /**
+             * @brief Parses the header and the chunk list of a PackFile.
+             *
+             * @param iSize   Size of the buffer in bytes.
+             * @param iBuffer Inflated content of the file.
+             * @throws gw2dt::exception::Exception If the buffer is not a PackFile or a chunk exceeds it.
+             */
+            PackFileView(uint32_t iSize, const uint8_t *iBuffer);
+
+            /**
+             * @brief Checks the magic of a buffer.
+             *
+             * @param iSize   Size of the buffer in bytes.
+             * @param iBuffer Buffer to check, only its first bytes are read.
+             * @return bool True if the buffer starts with a PackFile header.
+             */
+            static bool isPackFile(uint32_t iSize, const uint8_t *iBuffer);
+
+            uint16_t getVersion() const;
+            uint32_t getType() const;
+
+            const std::vector<Chunk> &getChunkVect() const;
+
+            /**
+             * @brief Finds a chunk by its magic in constant time.
+             *
+             * @param iMagic FourCC of the chunk.
+             * @return const Chunk* First chunk with this magic, nullptr if there is none.
+             */
+            const Chunk *findChunk(uint32_t iMagic) const;
+
+        private:
+            uint16_t _version;
+            uint32_t _type;
+
+            std::vector<Chunk> _chunkVect;
+            std::unordered_map<uint32_t, uint32_t> _chunkIndexMap;
+        };
+
+    } // namespace format
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_FORMAT_PACKFILEVIEW_H
@@ -0,0 +1,155 @@
+#ifndef GW2DATTOOLS_INDEX_ASSETMANIFEST_H
+#define GW2DATTOOLS_INDEX_ASSETMANIFEST_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gw2dattools/dllMacros.h"
+#include "gw2dattools/format/PackFileView.h"
+#include "gw2dattools/interface/ANDatInterface.h"
+
+namespace gw2dt
+{
+    namespace index
+    {
+
+        /**
+         * @brief Compact list of the assets of a client build.
+         *
+         * Records are sorted by baseId with one record per baseId, so that two manifests can be
+         * compared with a single merge pass. A manifest is either parsed from an MFST chunk or built
+         * from the file records of an archive.
+         */
+        class GW2DATTOOLS_API AssetManifest
+        {
+        public:
+#pragma pack(push, 1)
+            struct Record
+            {
+                uint32_t baseId;
+                uint32_t fileId; // Current version of the asset
+                uint32_t size;
+                uint32_t flags;  // 0 for the MFST versions without flags and for archives
+                uint32_t crc;    // Checksum of the stored file for archives, 0 for MFST chunks
+            };
+
+            struct Stream
+            {
+                uint32_t parentBaseId;
+                uint32_t streamBaseId;
+            };
+#pragma pack(pop)
+
+            /**
+             * @param iBuildId      Build the manifest describes, 0 if unknown.
+             * @param iRecordVect   Records in any order. For records sharing a baseId, only the one with
+             *                      the highest fileId is kept.
+             * @param iStreamVect   Streams in any order.
+             */
+            AssetManifest(uint32_t iBuildId, std::vector<Record> iRecordVect, std::vector<Stream> iStreamVect);
+
+            uint32_t getBuildId() const;
+
+            // Sorted by baseId
+            const std::vector<Record> &getRecordVect() const;
+
+            // Sorted by parentBaseId, then by streamBaseId
+            const std::vector<Stream> &getStreamVect() const;
+
+            /**
+             * @brief Finds the record of an asset.
+             *
+             * @param iBaseId BaseId of the asset.
+             * @return const Record* Record of the asset, nullptr if it is not in the manifest.
+             */
+            const Record *findRecord(uint32_t iBaseId) const;
+
+            /**
+             * @brief Writes the manifest to a file.
+             *
+             * @param iPath Path of the file to write.
+             * @throws gw2dt::exception::Exception If the file cannot be written.
+             */
+            void save(const char *iPath) const;
+
+        private:
+            uint32_t _buildId;
+            std::vector<Record> _recordVect;
+            std::vector<Stream> _streamVect;
+        };
+
+        /**
+         * @brief Differences between two manifests.
+         */
+        struct ManifestDiff
+        {
+            static const uint32_t NoRecord = 0xFFFFFFFF;
+
+            enum ChangeKind
+            {
+                CK_ADDED,
+                CK_REMOVED,
+                CK_MODIFIED
+            };
+
+            struct Change
+            {
+                uint32_t baseId;
+                ChangeKind kind;
+                uint32_t oldRecordIndex; // Index in the old manifest, NoRecord for an added asset
+                uint32_t newRecordIndex; // Index in the new manifest, NoRecord for a removed asset
+            };
+
+            std::vector<Change> changeVect; // Sorted by baseId
+
+            uint32_t nbOfAdded;
+            uint32_t nbOfRemoved;
+            uint32_t nbOfModified;
+            uint64_t downloadSize; // Size of the added and modified assets in the new manifest
+        };
+
+        /**
+         * @brief Parses the MFST chunk of a PackFile.
+         *
+         * @param iPackFile Asset manifest PackFile.
+         * @return std::unique_ptr<AssetManifest> Parsed manifest.
+         * @throws gw2dt::exception::Exception If there is no MFST chunk, its version is not supported or it is malformed.
+         */
+        GW2DATTOOLS_API std::unique_ptr<AssetManifest> GW2DATTOOLS_APIENTRY parseAssetManifest(const format::PackFileView &iPackFile);
+
+        /**
+         * @brief Builds a manifest from the file records of an archive, without reading any file.
+         *
+         * @param iANDatInterface Archive to describe.
+         * @return std::unique_ptr<AssetManifest> Manifest of the archive, with a null build id and no stream.
+         */
+        GW2DATTOOLS_API std::unique_ptr<AssetManifest> GW2DATTOOLS_APIENTRY buildArchiveManifest(const datfile::ANDatInterface &iANDatInterface);
+
+        /**
+         * @brief Loads a manifest written by AssetManifest::save.
+         *
+         * @param iPath Path of the manifest file.
+         * @return std::unique_ptr<AssetManifest> Loaded manifest.
+         * @throws gw2dt::exception::Exception If the file cannot be read or is not a manifest.
+         */
+        GW2DATTOOLS_API std::unique_ptr<AssetManifest> GW2DATTOOLS_APIENTRY loadAssetManifest(const char *iPath);
+
+        /**
+         * @brief Compares two manifests in a single pass over their sorted records.
+         *
+         * An asset is modified when its fileId or size differ, or its flags or crc when both records have
+         * them: a null flags or crc field is taken as unknown. An MFST manifest, without crc, can so be
+         * compared with an archive manifest, without flags, but a crc cleared between two archives or
+         * flags cleared between two builds go unnoticed unless the fileId or size change too.
+         *
+         * @param iOldManifest Manifest of the installed build.
+         * @param iNewManifest Manifest of the build to install.
+         * @return ManifestDiff Assets added, removed and modified by the new build.
+         */
+        GW2DATTOOLS_API ManifestDiff GW2DATTOOLS_APIENTRY diffManifests(const AssetManifest &iOldManifest, const AssetManifest &iNewManifest);
+
+    } // namespace index
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_INDEX_ASSETMANIFEST_H
@@ -0,0 +1,95 @@
+#ifndef GW2DATTOOLS_INDEX_FILETYPEINDEX_H
+#define GW2DATTOOLS_INDEX_FILETYPEINDEX_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gw2dattools/dllMacros.h"
+#include "gw2dattools/interface/ANDatInterface.h"
+
+namespace gw2dt
+{
+    namespace index
+    {
+
+        /**
+         * @brief Type of every file of an archive.
+         *
+         * The type of a file is the magic found at the start of its content and, for PackFiles, the
+         * type FourCC of the pack. Entries are sorted by magic, then by pack type, then by fileId, so
+         * that queries on a type only scan the entries of that type.
+         */
+        class GW2DATTOOLS_API FileTypeIndex
+        {
+        public:
+            // Magic of the PackFiles, only their first two bytes are fixed
+            static const uint32_t PackFileMagic = 0x4650;
+
+#pragma pack(push, 1)
+            struct Entry
+            {
+                uint32_t fileId;
+                uint32_t magic;    // First four bytes of the content, PackFileMagic for PackFiles, 0 if unreadable
+                uint32_t packType; // Type FourCC of a PackFile, 0 for other files
+            };
+#pragma pack(pop)
+
+            explicit FileTypeIndex(std::vector<Entry> iEntryVect);
+
+            /**
+             * @brief Finds the files of a type.
+             *
+             * @param iMagic    Magic of the files.
+             * @param iPackType Type FourCC of the PackFiles, 0 to match any type.
+             * @return std::vector<Entry> Matching entries, sorted by fileId within a pack type.
+             */
+            std::vector<Entry> findFiles(uint32_t iMagic, uint32_t iPackType = 0) const;
+
+            /**
+             * @brief Finds the PackFiles of a type, e.g. all the MODL packs.
+             *
+             * @param iPackType Type FourCC of the PackFiles.
+             * @return std::vector<Entry> Matching entries, sorted by fileId.
+             */
+            std::vector<Entry> findPackFiles(uint32_t iPackType) const;
+
+            const std::vector<Entry> &getEntryVect() const;
+
+            /**
+             * @brief Writes the index to a file.
+             *
+             * @param iPath Path of the file to write.
+             * @throws gw2dt::exception::Exception If the file cannot be written.
+             */
+            void save(const char *iPath) const;
+
+        private:
+            std::vector<Entry> _entryVect;
+        };
+
+        /**
+         * @brief Builds the file type index of an archive.
+         *
+         * Every file is inflated only as far as needed to read its magic and the PackFile header,
+         * the files are processed in parallel.
+         *
+         * @param iANDatInterface Archive to scan.
+         * @param iNbThreads      Number of threads, 0 to use one per hardware thread.
+         * @return std::unique_ptr<FileTypeIndex> Index of all the files of the archive.
+         */
+        GW2DATTOOLS_API std::unique_ptr<FileTypeIndex> GW2DATTOOLS_APIENTRY buildFileTypeIndex(datfile::ANDatInterface &iANDatInterface, uint32_t iNbThreads = 0);
+
+        /**
+         * @brief Loads a file type index written by FileTypeIndex::save.
+         *
+         * @param iPath Path of the index file.
+         * @return std::unique_ptr<FileTypeIndex> Loaded index.
+         * @throws gw2dt::exception::Exception If the file cannot be read or is not an index.
+         */
+        GW2DATTOOLS_API std::unique_ptr<FileTypeIndex> GW2DATTOOLS_APIENTRY loadFileTypeIndex(const char *iPath);
+
+    } // namespace index
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_INDEX_FILETYPEINDEX_H
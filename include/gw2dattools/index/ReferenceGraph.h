@@ -0,0 +1,99 @@
+#ifndef GW2DATTOOLS_INDEX_REFERENCEGRAPH_H
+#define GW2DATTOOLS_INDEX_REFERENCEGRAPH_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gw2dattools/dllMacros.h"
+#include "gw2dattools/interface/ANDatInterface.h"
+
+namespace gw2dt
+{
+    namespace index
+    {
+
+        class FileTypeIndex;
+
+        /**
+         * @brief Files referenced by each PackFile of an archive.
+         *
+         * The graph is stored as compressed sparse rows: the files having references are sorted by
+         * fileId, and the references of the file at row i are the entries [offsets[i], offsets[i + 1])
+         * of the reference array, sorted by fileId and without duplicates.
+         */
+        class GW2DATTOOLS_API ReferenceGraph
+        {
+        public:
+            /**
+             * @param iFileIdVect    Sorted fileIds of the files having references.
+             * @param iOffsetVect    Start of the references of each file plus the end of the last ones.
+             * @param iReferenceVect Referenced fileIds.
+             * @throws gw2dt::exception::Exception If the arrays are not consistent.
+             */
+            ReferenceGraph(std::vector<uint32_t> iFileIdVect, std::vector<uint32_t> iOffsetVect, std::vector<uint32_t> iReferenceVect);
+
+            /**
+             * @brief Gets the files directly referenced by a file.
+             *
+             * @param iFileId          File to look up.
+             * @param oNbOfReferences  Number of referenced files.
+             * @return const uint32_t* Referenced fileIds, nullptr if the file has no reference.
+             */
+            const uint32_t *getReferences(uint32_t iFileId, uint32_t &oNbOfReferences) const;
+
+            /**
+             * @brief Gets all the files a file depends on, directly or not.
+             *
+             * @param iFileId File to look up.
+             * @return std::vector<uint32_t> Dependencies in breadth-first order, iFileId excluded.
+             */
+            std::vector<uint32_t> getDependencyClosure(uint32_t iFileId) const;
+
+            const std::vector<uint32_t> &getFileIdVect() const;
+            const std::vector<uint32_t> &getOffsetVect() const;
+            const std::vector<uint32_t> &getReferenceVect() const;
+
+            /**
+             * @brief Writes the graph to a file.
+             *
+             * @param iPath Path of the file to write.
+             * @throws gw2dt::exception::Exception If the file cannot be written.
+             */
+            void save(const char *iPath) const;
+
+        private:
+            std::vector<uint32_t> _fileIdVect;
+            std::vector<uint32_t> _offsetVect;
+            std::vector<uint32_t> _referenceVect;
+        };
+
+        /**
+         * @brief Builds the reference graph of an archive.
+         *
+         * Every PackFile is inflated and its chunks are walked with the views generated from
+         * ANStructs.txt to collect their filename fields. The files are processed in parallel.
+         * References to files missing from the archive are dropped.
+         *
+         * @param iANDatInterface Archive to scan.
+         * @param ipFileTypeIndex Optional index of the archive, used to skip the files which are not PackFiles.
+         * @param iNbThreads      Number of threads, 0 to use one per hardware thread.
+         * @return std::unique_ptr<ReferenceGraph> Reference graph of the archive.
+         */
+        GW2DATTOOLS_API std::unique_ptr<ReferenceGraph> GW2DATTOOLS_APIENTRY buildReferenceGraph(datfile::ANDatInterface &iANDatInterface,
+                                                                                                const FileTypeIndex *ipFileTypeIndex = nullptr,
+                                                                                                uint32_t iNbThreads = 0);
+
+        /**
+         * @brief Loads a reference graph written by ReferenceGraph::save.
+         *
+         * @param iPath Path of the graph file.
+         * @return std::unique_ptr<ReferenceGraph> Loaded graph.
+         * @throws gw2dt::exception::Exception If the file cannot be read or is not a reference graph.
+         */
+        GW2DATTOOLS_API std::unique_ptr<ReferenceGraph> GW2DATTOOLS_APIENTRY loadReferenceGraph(const char *iPath);
+
+    } // namespace index
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_INDEX_REFERENCEGRAPH_H
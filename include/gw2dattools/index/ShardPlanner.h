@@ -0,0 +1,74 @@
+#ifndef GW2DATTOOLS_INDEX_SHARDPLANNER_H
+#define GW2DATTOOLS_INDEX_SHARDPLANNER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "gw2dattools/dllMacros.h"
+#include "gw2dattools/interface/ANDatInterface.h"
+
+namespace gw2dt
+{
+    namespace index
+    {
+
+        /**
+         * @brief Part of an archive processed independently of the others.
+         *
+         * The files of a shard are contiguous in the archive, so that processing a shard reads a
+         * single byte range of it.
+         */
+        struct Shard
+        {
+            uint32_t index;
+            uint32_t nbOfShards;
+
+            uint64_t beginOffset; // Offset of the first file, 0 for an empty shard
+            uint64_t endOffset;   // End of the last file, 0 for an empty shard
+            uint64_t size;        // Sum of the stored sizes of the files
+
+            uint64_t archiveHash; // Hash of the file table of the archive the shard was planned on
+
+            std::vector<uint32_t> fileIdVect; // In the order of their offsets
+        };
+
+        /**
+         * @brief Splits the files of an archive into shards of balanced stored size.
+         *
+         * The files are taken in the order of their offsets and cut into contiguous runs, each
+         * boundary being placed on the file boundary closest to an equal share of the total size.
+         *
+         * @param iANDatInterface Archive to split.
+         * @param iNbOfShards     Number of shards, some may be empty if the archive has fewer files.
+         * @return std::vector<Shard> Shards in the order of their offsets.
+         * @throws gw2dt::exception::Exception If the number of shards is null.
+         */
+        GW2DATTOOLS_API std::vector<Shard> GW2DATTOOLS_APIENTRY planShards(const datfile::ANDatInterface &iANDatInterface, uint32_t iNbOfShards);
+
+        /**
+         * @brief Writes the manifest of a shard.
+         *
+         * @param iShard Shard to write.
+         * @param iPath  Path of the file to write.
+         * @throws gw2dt::exception::Exception If the file cannot be written.
+         */
+        GW2DATTOOLS_API void GW2DATTOOLS_APIENTRY saveShardManifest(const Shard &iShard, const char *iPath);
+
+        /**
+         * @brief Reads the manifest of a shard and checks that it was planned on an archive.
+         *
+         * The file ids and offsets of a shard only hold for the archive it was planned on: a manifest
+         * planned before the archive was updated would select the wrong files.
+         *
+         * @param iPath           Path of the file written by saveShardManifest.
+         * @param iANDatInterface Archive the shard is to be processed on.
+         * @return Shard Shard described by the manifest.
+         * @throws gw2dt::exception::Exception If the file cannot be read, is not a shard manifest, or was
+         *                                     planned on another archive or another version of it.
+         */
+        GW2DATTOOLS_API Shard GW2DATTOOLS_APIENTRY loadShardManifest(const char *iPath, const datfile::ANDatInterface &iANDatInterface);
+
+    } // namespace index
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_INDEX_SHARDPLANNER_H
@@ -0,0 +1,86 @@
+#ifndef GW2DATTOOLS_INDEX_TEXTURECATALOG_H
+#define GW2DATTOOLS_INDEX_TEXTURECATALOG_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gw2dattools/dllMacros.h"
+#include "gw2dattools/interface/ANDatInterface.h"
+
+namespace gw2dt
+{
+    namespace index
+    {
+
+        /**
+         * @brief Table of the texture headers of an archive.
+         *
+         * Entries are sorted by format, then by fileId, so that queries on a format only
+         * scan the entries of that format.
+         */
+        class GW2DATTOOLS_API TextureCatalog
+        {
+        public:
+#pragma pack(push, 1)
+            struct Entry
+            {
+                uint32_t fileId;
+                uint32_t magic;
+                uint32_t formatFourCc;
+                uint16_t width;
+                uint16_t height;
+            };
+#pragma pack(pop)
+
+            explicit TextureCatalog(std::vector<Entry> iEntryVect);
+
+            /**
+             * @brief Finds the textures of a format with at least the given dimensions.
+             *
+             * @param iFormatFourCc FourCC code of the format, 0 to match any format.
+             * @param iMinWidth     Minimum width in pixels.
+             * @param iMinHeight    Minimum height in pixels.
+             * @return std::vector<Entry> Matching entries, sorted by fileId within a format.
+             */
+            std::vector<Entry> findTextures(uint32_t iFormatFourCc, uint16_t iMinWidth = 0, uint16_t iMinHeight = 0) const;
+
+            const std::vector<Entry> &getEntryVect() const;
+
+            /**
+             * @brief Writes the catalog to a file.
+             *
+             * @param iPath Path of the file to write.
+             * @throws gw2dt::exception::Exception If the file cannot be written.
+             */
+            void save(const char *iPath) const;
+
+        private:
+            std::vector<Entry> _entryVect;
+        };
+
+        /**
+         * @brief Builds the texture catalog of an archive.
+         *
+         * Every file is inflated only as far as needed to read its texture header, the
+         * files are processed in parallel.
+         *
+         * @param iANDatInterface Archive to scan.
+         * @param iNbThreads      Number of threads, 0 to use one per hardware thread.
+         * @return std::unique_ptr<TextureCatalog> Catalog of the textures found in the archive.
+         */
+        GW2DATTOOLS_API std::unique_ptr<TextureCatalog> GW2DATTOOLS_APIENTRY buildTextureCatalog(datfile::ANDatInterface &iANDatInterface, uint32_t iNbThreads = 0);
+
+        /**
+         * @brief Loads a texture catalog written by TextureCatalog::save.
+         *
+         * @param iPath Path of the catalog file.
+         * @return std::unique_ptr<TextureCatalog> Loaded catalog.
+         * @throws gw2dt::exception::Exception If the file cannot be read or is not a catalog.
+         */
+        GW2DATTOOLS_API std::unique_ptr<TextureCatalog> GW2DATTOOLS_APIENTRY loadTextureCatalog(const char *iPath);
+
+    } // namespace index
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_INDEX_TEXTURECATALOG_H
@@ -0,0 +1,29 @@
+#ifndef GW2DATTOOLS_INTEGRITY_CONTENTHASH_H
+#define GW2DATTOOLS_INTEGRITY_CONTENTHASH_H
+
+#include <cstdint>
+
+#include "gw2dattools/dllMacros.h"
+
+namespace gw2dt
+{
+    namespace integrity
+    {
+
+        /**
+         * @brief Computes a 64-bit hash identifying the content of a buffer.
+         *
+         * The hash is XXH64: it is not cryptographic but runs at memory speed, which makes it
+         * suitable to detect identical files among the content of an archive.
+         *
+         * @param iSize     Size of the buffer in bytes.
+         * @param iBuffer   Data to hash.
+         * @param iSeed     Seed of the hash.
+         * @return uint64_t Hash of the data.
+         */
+        GW2DATTOOLS_API uint64_t GW2DATTOOLS_APIENTRY computeContentHash(uint32_t iSize, const uint8_t *iBuffer, uint64_t iSeed = 0);
+
+    } // namespace integrity
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_INTEGRITY_CONTENTHASH_H
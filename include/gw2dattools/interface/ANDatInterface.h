@@ -24,10 +24,14 @@ namespace gw2dt
                 uint32_t fileId;
 
                 bool isCompressed;
+
+                uint32_t crc; // Checksum of the stored file, as recorded in the MFT
             };
 
             virtual ~ANDatInterface() {};
 
+            // Reads the raw content of a file, can be called concurrently from several threads.
+            // ioOutputSize receives the number of bytes read, less than the file size if the archive is truncated.
             virtual void getBuffer(const ANDatInterface::FileRecord &iFileRecord, uint32_t &ioOutputSize, uint8_t *ioBuffer) = 0;
 
             virtual const FileRecord &getFileRecordForFileId(const uint32_t &iFileId) const = 0;
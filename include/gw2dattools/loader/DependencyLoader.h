@@ -0,0 +1,91 @@
+#ifndef GW2DATTOOLS_LOADER_DEPENDENCYLOADER_H
+#define GW2DATTOOLS_LOADER_DEPENDENCYLOADER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gw2dattools/dllMacros.h"
+#include "gw2dattools/interface/ANDatInterface.h"
+
+namespace gw2dt
+{
+    namespace index
+    {
+        class ReferenceGraph;
+    }
+
+    namespace loader
+    {
+
+        /**
+         * @brief Loads a file and every file it depends on, reading and inflating them in parallel.
+         *
+         * Dependencies are resolved breadth-first: once a PackFile is inflated, the files referenced by
+         * its filename fields join the frontier and are read by the next free worker. The number of
+         * workers bounds the concurrency, and the content held by the loader is bounded by a memory budget.
+         * A file counts against the budget from the moment a worker takes it, for its raw size until it is
+         * inflated, so that workers starting together see each other's reads. Its content is only known
+         * once read: the loader may hold up to the budget plus the raw and the inflated size of one file
+         * per worker.
+         *
+         * The archive has a single stream, whose reads are serialized by the ANDatInterface: the workers
+         * overlap the inflating and the reference walking of their files, not the reads themselves.
+         */
+        class GW2DATTOOLS_API DependencyLoader
+        {
+        public:
+            struct Asset
+            {
+                uint32_t fileId;
+                uint32_t depth; // Number of references followed from the root
+
+                std::vector<uint8_t> content; // Inflated content, empty if the file failed to load
+                std::string error;            // Reason of the failure, empty on success
+            };
+
+            typedef std::function<void(Asset &ioAsset)> AssetCallback;
+
+            /**
+             * @param iANDatInterface   Archive to read from, must outlive the loader.
+             * @param iNbThreads        Number of reading threads, 0 to use one per hardware thread.
+             * @param iMemoryBudget     Number of bytes being read or waiting for the callback above which the workers
+             *                          stop starting new reads. A single file larger than the budget is still loaded.
+             * @param ipReferenceGraph  Optional prebuilt graph of the archive. Without it, the references are read from
+             *                          the content of each loaded PackFile, and the ids of the archive are indexed
+             *                          once here for all the loads.
+             */
+            DependencyLoader(datfile::ANDatInterface &iANDatInterface,
+                             uint32_t iNbThreads = 0,
+                             uint64_t iMemoryBudget = 256 * 1024 * 1024,
+                             const index::ReferenceGraph *ipReferenceGraph = nullptr);
+
+            /**
+             * @brief Loads a file and its dependency closure.
+             *
+             * The callback is called on the calling thread, once per file, as soon as a file is inflated. The
+             * content of an asset may be moved out of it, its memory stops being counted once the callback returns.
+             *
+             * @param iRootFileId File to load.
+             * @param iCallback   Function receiving the loaded files.
+             * @throws gw2dt::exception::Exception If the root file is not in the archive.
+             * @throws Any exception thrown by the callback, which stops the load.
+             */
+            void load(uint32_t iRootFileId, const AssetCallback &iCallback);
+
+        private:
+            datfile::ANDatInterface &_rANDatInterface;
+            uint32_t _nbThreads;
+            uint64_t _memoryBudget;
+            const index::ReferenceGraph *_pReferenceGraph;
+
+            // Base ids and fileIds of the archive mapped to fileIds, empty with a reference graph
+            std::unordered_map<uint32_t, uint32_t> _fileIdDict;
+        };
+
+    } // namespace loader
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_LOADER_DEPENDENCYLOADER_H
@@ -0,0 +1,156 @@
+#ifndef GW2DATTOOLS_MAP_MAPREADER_H
+#define GW2DATTOOLS_MAP_MAPREADER_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "gw2dattools/dllMacros.h"
+#include "gw2dattools/format/PackFileView.h"
+
+namespace gw2dt
+{
+    namespace map
+    {
+
+        /**
+         * @brief Reader of a map PackFile decoding its terrain one tile at a time.
+         *
+         * Opening a map only walks the chunk headers: the terrain tiles of the trn chunk and the props of
+         * the prp2 chunk are indexed, but no tile is decoded. A tile is decoded when it is first requested
+         * and kept in a least recently used cache, so a viewer streaming the world only pays for the tiles
+         * in view. The other chunks (havk, cube...) are reachable untouched through the PackFile view.
+         */
+        class GW2DATTOOLS_API MapReader
+        {
+        public:
+            enum PropKind
+            {
+                PK_STATIC,
+                PK_ANIMATED,
+                PK_INSTANCE, // One prop per transform of an instanced record
+                PK_META
+            };
+
+            struct Prop
+            {
+                PropKind kind;
+                uint32_t recordIndex; // Index of the record in the prp2 array of its kind
+                uint32_t fileId;      // Base id of the model, 0 when there is none
+                uint64_t guid;
+                float position[3];
+                float rotation[3];
+                float scale;
+                uint32_t flags;
+            };
+
+            struct TerrainInfo
+            {
+                bool hasTerrain;
+                uint32_t dims[2];
+                float swapDistance;
+
+                uint32_t nbOfTiles;
+                uint32_t nbOfTilesX;
+                uint32_t nbOfTilesY;
+                uint32_t nbOfHeightsPerTile;
+                uint32_t tileSide; // Height samples per side of a tile, 0 if the tiles are not square
+            };
+
+            struct TerrainTile
+            {
+                uint32_t index;
+                uint32_t chunkFlags;
+
+                float minHeight;
+                float maxHeight;
+                std::vector<float> heights; // Row-major, tileSide * tileSide samples for square tiles
+                std::vector<uint32_t> tileFlags;
+
+                std::vector<uint16_t> surfaceIndices; // trn version 14 and above
+                std::vector<uint64_t> surfaceTokens;  // trn version 14 and above
+                std::vector<uint8_t> tileTable;       // trn versions before 14
+            };
+
+            // Location in the content, found when indexing, of the variable parts of a tile
+            struct TileRecord
+            {
+                uint32_t chunkFlags;
+
+                const uint8_t *pSurfaceIndices;
+                uint32_t nbOfSurfaceIndices;
+                const uint8_t *pSurfaceTokens;
+                uint32_t nbOfSurfaceTokens;
+                const uint8_t *pTileTable;
+                uint32_t nbOfTileTableBytes;
+            };
+
+            /**
+             * @brief Opens a map and indexes its terrain tiles and props.
+             *
+             * @param iContent           Inflated content of the map file, kept by the reader.
+             * @param iTileCacheCapacity Maximum number of decoded tiles kept in memory, 0 to disable the cache.
+             * @throws gw2dt::exception::Exception If the content is not a PackFile, a chunk version is not
+             *                                     supported or the trn and prp2 chunks are malformed.
+             */
+            MapReader(std::vector<uint8_t> iContent, uint32_t iTileCacheCapacity = 64);
+
+            const format::PackFileView &getPackFile() const;
+            const TerrainInfo &getTerrainInfo() const;
+            const std::vector<Prop> &getPropVect() const;
+
+            /**
+             * @brief Finds the props whose position is within a box.
+             *
+             * @param iMin Lowest corner of the box.
+             * @param iMax Highest corner of the box.
+             * @return std::vector<uint32_t> Indexes of the props in getPropVect.
+             */
+            std::vector<uint32_t> findProps(const float iMin[3], const float iMax[3]) const;
+
+            /**
+             * @brief Gets a decoded terrain tile, decoding it if it is not in the cache.
+             *
+             * Can be called from several threads at once.
+             *
+             * @param iIndex Index of the tile in the trn chunk.
+             * @return std::shared_ptr<const TerrainTile> Decoded tile, still valid once evicted from the cache.
+             * @throws gw2dt::exception::Exception If the index is out of range.
+             */
+            std::shared_ptr<const TerrainTile> getTile(uint32_t iIndex);
+
+            // Same as above for the tile at column iX and row iY of the tile grid
+            std::shared_ptr<const TerrainTile> getTile(uint32_t iX, uint32_t iY);
+
+            uint32_t getNbOfCachedTiles() const;
+
+        private:
+            typedef std::list<std::shared_ptr<const TerrainTile>> TileList;
+
+            std::shared_ptr<const TerrainTile> decodeTile(uint32_t iIndex) const;
+
+            std::vector<uint8_t> _content;
+            format::PackFileView _packFile;
+
+            TerrainInfo _terrainInfo;
+            const uint8_t *_pHeights;
+            const uint8_t *_pTileFlags;
+            uint32_t _nbOfTileFlagsPerTile;
+            std::vector<TileRecord> _tileRecordVect;
+
+            std::vector<Prop> _propVect;
+
+            // Most recently used tile first
+            uint32_t _tileCacheCapacity;
+            TileList _tileCacheList;
+            std::unordered_map<uint32_t, TileList::iterator> _tileCacheMap;
+            mutable std::mutex _tileCacheMutex;
+        };
+
+    } // namespace map
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_MAP_MAPREADER_H
@@ -0,0 +1,124 @@
+#ifndef GW2DATTOOLS_MESH_MESHEXTRACTOR_H
+#define GW2DATTOOLS_MESH_MESHEXTRACTOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "gw2dattools/dllMacros.h"
+#include "gw2dattools/format/PackFileView.h"
+
+namespace gw2dt
+{
+    namespace mesh
+    {
+
+        // Flags of the flexible vertex format (fvf) of PackVertexType, attributes are stored in this order
+        enum VertexFormatFlag
+        {
+            VFF_POSITION = 0x00000001,            // float3
+            VFF_WEIGHTS = 0x00000002,             // byte4
+            VFF_GROUP = 0x00000004,               // byte4
+            VFF_NORMAL = 0x00000008,              // float3
+            VFF_COLOR = 0x00000010,               // byte4
+            VFF_TANGENT = 0x00000020,             // float3
+            VFF_BITANGENT = 0x00000040,           // float3
+            VFF_TANGENT_FRAME = 0x00000080,       // float3
+            VFF_UV32_MASK = 0x0000FF00,           // float2 per set bit
+            VFF_UV16_MASK = 0x00FF0000,           // half2 per set bit
+            VFF_UNKNOWN1 = 0x01000000,            // 48 bytes
+            VFF_UNKNOWN2 = 0x02000000,            // 4 bytes
+            VFF_UNKNOWN3 = 0x04000000,            // 4 bytes
+            VFF_UNKNOWN4 = 0x08000000,            // 16 bytes
+            VFF_POSITION_COMPRESSED = 0x10000000, // half3
+            VFF_UNKNOWN5 = 0x20000000             // 12 bytes
+        };
+
+        /**
+         * @brief Layout of a vertex, decoded once from its format flags.
+         */
+        struct VertexLayout
+        {
+            static const uint32_t MaxNbOfUvSets = 16;
+
+            uint32_t flags;
+            uint32_t vertexSize;
+
+            bool hasPosition;
+            bool isPositionCompressed;
+            uint32_t positionOffset;
+
+            bool hasNormal;
+            uint32_t normalOffset;
+
+            uint32_t nbOfUvSets;
+            uint32_t uvOffsets[MaxNbOfUvSets];
+            bool isUvHalf[MaxNbOfUvSets];
+        };
+
+        /**
+         * @brief Vertex attributes as structure of arrays, one float array per component.
+         */
+        struct VertexStreams
+        {
+            struct UvSet
+            {
+                std::vector<float> u;
+                std::vector<float> v;
+            };
+
+            uint32_t nbOfVertices;
+
+            std::vector<float> positions[3]; // Empty when the vertices have no position
+            std::vector<float> normals[3];   // Empty when the vertices have no normal
+            std::vector<UvSet> uvSets;
+        };
+
+        struct Mesh
+        {
+            uint32_t materialIndex;
+            uint32_t vertexFormatFlags;
+
+            VertexStreams vertices;
+            std::vector<uint16_t> indices;
+        };
+
+        /**
+         * @brief Decodes the format flags of a vertex buffer.
+         *
+         * @param iFlags Flexible vertex format flags.
+         * @return VertexLayout Offsets of the attributes within a vertex.
+         * @throws gw2dt::exception::Exception If the flags hold unknown bits.
+         */
+        GW2DATTOOLS_API VertexLayout GW2DATTOOLS_APIENTRY decodeVertexFormat(uint32_t iFlags);
+
+        /**
+         * @brief De-interleaves the positions, normals and UVs of a vertex buffer.
+         *
+         * Half-float attributes are converted to floats.
+         *
+         * @param iLayout      Layout of the vertices.
+         * @param iNbVertices  Number of vertices.
+         * @param iSize        Size of the vertex buffer in bytes.
+         * @param iVertices    Vertex buffer.
+         * @param oStreams     Extracted attributes.
+         * @throws gw2dt::exception::Exception If the buffer is too small for the vertices.
+         */
+        GW2DATTOOLS_API void GW2DATTOOLS_APIENTRY extractVertices(const VertexLayout &iLayout,
+                                                                  uint32_t iNbVertices,
+                                                                  uint32_t iSize,
+                                                                  const uint8_t *iVertices,
+                                                                  VertexStreams &oStreams);
+
+        /**
+         * @brief Extracts the meshes of the GEOM chunk of a model PackFile.
+         *
+         * @param iPackFile Model file.
+         * @return std::vector<Mesh> Meshes of the model, empty if the file has no GEOM chunk.
+         * @throws gw2dt::exception::Exception If the chunk version is unknown or the chunk is malformed.
+         */
+        GW2DATTOOLS_API std::vector<Mesh> GW2DATTOOLS_APIENTRY extractMeshes(const format::PackFileView &iPackFile);
+
+    } // namespace mesh
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_MESH_MESHEXTRACTOR_H
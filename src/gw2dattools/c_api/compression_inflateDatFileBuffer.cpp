@@ -20,7 +20,7 @@ extern "C"
      */
     GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY compression_inflateDatFileBuffer(
         const uint32_t iInputSize,
-        uint8_t *iInputTab,
+        const uint8_t *iInputTab,
         uint32_t *ioOutputSize,
         uint8_t *ioOutputTab)
     {
@@ -48,6 +48,39 @@ extern "C"
         }
     }
 
+    /**
+     * @brief C API function to inflate a DAT file buffer into a buffer of an allocator.
+     *
+     * @param iInputSize   Size of the input buffer.
+     * @param iInputTab    Pointer to the input buffer to inflate.
+     * @param ioOutputSize Pointer to the size of the output buffer.
+     * @param iAllocator   Allocator of the output buffer.
+     * @return uint8_t*    Pointer to the inflated output buffer; returns NULL if decompression fails.
+     */
+    GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY compression_inflateDatFileBufferWithAllocator(
+        const uint32_t iInputSize,
+        const uint8_t *iInputTab,
+        uint32_t *ioOutputSize,
+        const compression_Allocator *iAllocator)
+    {
+        if (ioOutputSize == nullptr || iAllocator == nullptr)
+        {
+            printf("GW2DATTOOLS_C_API(compression_inflateDatFileBufferWithAllocator): ioOutputSize or iAllocator is NULL.\n");
+            return NULL;
+        }
+
+        try
+        {
+            gw2dt::compression::Allocator aAllocator = {iAllocator->allocate, iAllocator->release, iAllocator->context};
+            return gw2dt::compression::inflateDatFileBuffer(iInputSize, iInputTab, *ioOutputSize, aAllocator);
+        }
+        catch (const std::exception &e)
+        {
+            printf("GW2DATTOOLS_C_API(compression_inflateDatFileBufferWithAllocator): %s\n", e.what());
+            return NULL;
+        }
+    }
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include "gw2dattools/cache/ContentCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include "gw2dattools/integrity/ContentHash.h"
+
+#include "../format/Utils.h"
+#include "../index/FileProbe.h"
+
+namespace gw2dt
+{
+    namespace cache
+    {
+
+#pragma pack(push, 1)
+        struct ContentCacheEntryHeader
+        {
+            uint8_t magic[4];
+            uint32_t version;
+            uint32_t fileId;
+            uint32_t crc;        // MFT crc of the stored file the content was inflated from
+            uint32_t storedSize; // Size of the stored file
+            uint32_t contentSize;
+            uint64_t contentHash;
+        };
+#pragma pack(pop)
+
+        static const uint8_t sContentCacheMagic[4] = {'G', 'W', 'C', 'C'};
+        static const uint32_t sContentCacheVersion = 1;
+
+        namespace
+        {
+
+            void makeDirectory(const std::string &iPath)
+            {
+#ifdef _WIN32
+                _mkdir(iPath.c_str());
+#else
+                mkdir(iPath.c_str(), 0755);
+#endif
+            }
+
+            // Opens the entry of a file and checks its header, the stream is left at the start of the content
+            bool openEntry(const std::string &iPath, const datfile::ANDatInterface::FileRecord &iFileRecord, std::ifstream &oStream, ContentCacheEntryHeader &oHeader)
+            {
+                oStream.open(iPath, std::ios::binary | std::ios::ate);
+                if (!oStream)
+                {
+                    return false;
+                }
+
+                std::streamoff aEntrySize = oStream.tellg();
+                oStream.seekg(0);
+
+                format::readStructs(oStream, oHeader);
+
+                // An entry is the header followed by the content, a size that does not add up is not trusted
+                return oStream && std::equal(sContentCacheMagic, sContentCacheMagic + 4, oHeader.magic) && oHeader.version == sContentCacheVersion &&
+                       oHeader.fileId == iFileRecord.fileId && oHeader.crc == iFileRecord.crc && oHeader.storedSize == iFileRecord.size &&
+                       aEntrySize == static_cast<std::streamoff>(sizeof(oHeader) + static_cast<uint64_t>(oHeader.contentSize));
+            }
+
+        } // namespace
+
+        ContentCache::ContentCache(const char *iDirectory, uint32_t iMinContentSize) : _directory(iDirectory),
+                                                                                       _minContentSize(iMinContentSize),
+                                                                                       _nbOfHits(0),
+                                                                                       _nbOfMisses(0),
+                                                                                       _nbOfStores(0)
+        {
+            makeDirectory(_directory);
+            for (uint32_t aShard = 0; aShard < 256; ++aShard)
+            {
+                char aName[8];
+                snprintf(aName, sizeof(aName), "/%02x", aShard);
+                makeDirectory(_directory + aName);
+            }
+        }
+
+        bool ContentCache::isCacheable(const datfile::ANDatInterface::FileRecord &iFileRecord) const
+        {
+            return iFileRecord.isCompressed && iFileRecord.crc != 0;
+        }
+
+        bool ContentCache::peekContentSize(const datfile::ANDatInterface::FileRecord &iFileRecord, uint32_t &oContentSize) const
+        {
+            if (!isCacheable(iFileRecord))
+            {
+                return false;
+            }
+
+            std::ifstream aStream;
+            ContentCacheEntryHeader aHeader;
+            if (!openEntry(getPath(iFileRecord.fileId), iFileRecord, aStream, aHeader))
+            {
+                return false;
+            }
+
+            oContentSize = aHeader.contentSize;
+            return true;
+        }
+
+        bool ContentCache::lookup(const datfile::ANDatInterface::FileRecord &iFileRecord, std::vector<uint8_t> &ioContentBuffer, uint32_t &oContentSize)
+        {
+            if (!isCacheable(iFileRecord))
+            {
+                return false;
+            }
+
+            std::ifstream aStream;
+            ContentCacheEntryHeader aHeader;
+            if (!openEntry(getPath(iFileRecord.fileId), iFileRecord, aStream, aHeader))
+            {
+                ++_nbOfMisses;
+                return false;
+            }
+
+            if (ioContentBuffer.size() < aHeader.contentSize)
+            {
+                ioContentBuffer.resize(aHeader.contentSize);
+            }
+            aStream.read(reinterpret_cast<char *>(ioContentBuffer.data()), aHeader.contentSize);
+
+            if (!aStream || integrity::computeContentHash(aHeader.contentSize, ioContentBuffer.data()) != aHeader.contentHash)
+            {
+                ++_nbOfMisses;
+                return false;
+            }
+
+            oContentSize = aHeader.contentSize;
+            ++_nbOfHits;
+            return true;
+        }
+
+        bool ContentCache::store(const datfile::ANDatInterface::FileRecord &iFileRecord, uint32_t iContentSize, const uint8_t *iContent)
+        {
+            if (!isCacheable(iFileRecord) || iContentSize < _minContentSize)
+            {
+                return false;
+            }
+
+            ContentCacheEntryHeader aHeader;
+            std::copy(sContentCacheMagic, sContentCacheMagic + 4, aHeader.magic);
+            aHeader.version = sContentCacheVersion;
+            aHeader.fileId = iFileRecord.fileId;
+            aHeader.crc = iFileRecord.crc;
+            aHeader.storedSize = iFileRecord.size;
+            aHeader.contentSize = iContentSize;
+            aHeader.contentHash = integrity::computeContentHash(iContentSize, iContent);
+
+            // Written aside then renamed, so that readers never see a partial entry
+            std::string aPath = getPath(iFileRecord.fileId);
+            std::string aTemporaryPath = aPath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + "." +
+                                         std::to_string(_nbOfStores++) + ".tmp";
+            {
+                std::ofstream aStream(aTemporaryPath, std::ios::binary | std::ios::trunc);
+                aStream.write(reinterpret_cast<const char *>(&aHeader), sizeof(aHeader));
+                aStream.write(reinterpret_cast<const char *>(iContent), iContentSize);
+                aStream.close();
+                if (aStream.fail())
+                {
+                    std::remove(aTemporaryPath.c_str());
+                    return false;
+                }
+            }
+
+#ifdef _WIN32
+            std::remove(aPath.c_str());
+#endif
+            if (std::rename(aTemporaryPath.c_str(), aPath.c_str()) != 0)
+            {
+                std::remove(aTemporaryPath.c_str());
+                return false;
+            }
+            return true;
+        }
+
+        uint32_t ContentCache::readFileContent(datfile::ANDatInterface &iANDatInterface,
+                                               const datfile::ANDatInterface::FileRecord &iFileRecord,
+                                               std::vector<uint8_t> &ioInputBuffer,
+                                               std::vector<uint8_t> &ioContentBuffer)
+        {
+            uint32_t aContentSize = 0;
+            if (lookup(iFileRecord, ioContentBuffer, aContentSize))
+            {
+                return aContentSize;
+            }
+
+            aContentSize = index::readFileContent(iANDatInterface, iFileRecord, ioInputBuffer, ioContentBuffer);
+            store(iFileRecord, aContentSize, ioContentBuffer.data());
+            return aContentSize;
+        }
+
+        uint64_t ContentCache::getNbOfHits() const
+        {
+            return _nbOfHits;
+        }
+
+        uint64_t ContentCache::getNbOfMisses() const
+        {
+            return _nbOfMisses;
+        }
+
+        std::string ContentCache::getPath(uint32_t iFileId) const
+        {
+            char aName[24];
+            snprintf(aName, sizeof(aName), "/%02x/%u", iFileId & 0xFF, iFileId);
+            return _directory + aName;
+        }
+
+    } // namespace cache
+} // namespace gw2dt
@@ -0,0 +1,32 @@
+#include "gw2dattools/compression/Allocator.h"
+
+#include <cstdlib>
+
+namespace gw2dt
+{
+    namespace compression
+    {
+
+        namespace
+        {
+
+            void *allocateWithMalloc(void *, uint32_t iSize)
+            {
+                return malloc(iSize);
+            }
+
+            void releaseWithFree(void *, void *ipBuffer)
+            {
+                free(ipBuffer);
+            }
+
+        } // namespace
+
+        GW2DATTOOLS_API const Allocator &GW2DATTOOLS_APIENTRY getDefaultAllocator()
+        {
+            static const Allocator sDefaultAllocator = {&allocateWithMalloc, &releaseWithFree, nullptr};
+            return sDefaultAllocator;
+        }
+
+    } // namespace compression
+} // namespace gw2dt
@@ -19,9 +19,8 @@ namespace gw2dt
             _symbolValueArray.fill(0);
             _codeBitsArray.fill(0);
 
+            // The hashed symbols and their number of bits are only read when flagged as existing
             _symbolValueHashExistenceArray.fill(false);
-            _symbolValueHashArray.fill(0);
-            _codeBitsHashArray.fill(0);
         }
 
         template <typename SymbolType,
@@ -61,11 +60,9 @@ namespace gw2dt
                   uint16_t sMaxSymbolValue>
         void HuffmanTreeBuilder<SymbolType, sMaxCodeBitsLength, sMaxSymbolValue>::clear()
         {
+            // The lists are only followed through the symbols flagged as existing
             _symbolListByBitsHeadExistenceArray.fill(false);
-            _symbolListByBitsHeadArray.fill(0);
-
             _symbolListByBitsBodyExistenceArray.fill(false);
-            _symbolListByBitsBodyArray.fill(0);
         }
 
         template <typename SymbolType,
@@ -141,8 +138,12 @@ namespace gw2dt
                             ++aHashValue;
                         }
 
+                        // The body entry of the last symbol of a list is never written
                         anExistence = _symbolListByBitsBodyExistenceArray[aCurrentSymbol];
-                        aCurrentSymbol = _symbolListByBitsBodyArray[aCurrentSymbol];
+                        if (anExistence)
+                        {
+                            aCurrentSymbol = _symbolListByBitsBodyArray[aCurrentSymbol];
+                        }
                         --aCode;
                     }
                 }
@@ -170,7 +171,10 @@ namespace gw2dt
 
                         ++aSymbolOffset;
                         anExistence = _symbolListByBitsBodyExistenceArray[aCurrentSymbol];
-                        aCurrentSymbol = _symbolListByBitsBodyArray[aCurrentSymbol];
+                        if (anExistence)
+                        {
+                            aCurrentSymbol = _symbolListByBitsBodyArray[aCurrentSymbol];
+                        }
                         --aCode;
                     }
 
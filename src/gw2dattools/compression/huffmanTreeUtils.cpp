@@ -13,7 +13,16 @@ namespace gw2dt
                 throw exception::Exception("Trying to read code from an empty HuffmanTree.");
             }
 
-            needBits(ioState, MaxNbBitsHash);
+            // A single refill covers the longest code
+            if (ioState.bits < MaxCodeBitsLength)
+            {
+                refill(ioState);
+
+                if (ioState.bits < MaxNbBitsHash)
+                {
+                    throw exception::Exception("Reached end of input while trying to fetch a new byte.");
+                }
+            }
 
             uint32_t hash = readBits(ioState, MaxNbBitsHash);
             if (iHuffmanTree.symbolValueHashTab[hash] != -1)
@@ -32,6 +41,11 @@ namespace gw2dt
                 uint8_t aNbBits = iHuffmanTree.codeBitsTab[anIndex];
                 ioCode = iHuffmanTree.symbolValueTab[iHuffmanTree.symbolValueTabOffsetTab[anIndex] -
                                                      ((readBits(ioState, 32) - iHuffmanTree.codeCompTab[anIndex]) >> (32 - aNbBits))];
+
+                if (aNbBits > ioState.bits)
+                {
+                    throw exception::Exception("Tried to drop more bits than we have.");
+                }
                 dropBits(ioState, aNbBits);
             }
         }
@@ -125,12 +139,8 @@ namespace gw2dt
             }
             else
             {
-                int16_t aCurrentSymbol = ioWorkingBitTab[iBits];
-                while (aCurrentSymbol != -1)
-                {
-                    aCurrentSymbol = ioWorkingCodeTab[aCurrentSymbol];
-                }
-                ioWorkingCodeTab[aCurrentSymbol] = iSymbol;
+                ioWorkingCodeTab[iSymbol] = ioWorkingBitTab[iBits];
+                ioWorkingBitTab[iBits] = iSymbol;
             }
         }
     } // namespace compression
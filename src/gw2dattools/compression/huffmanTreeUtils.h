@@ -2,6 +2,7 @@
 #define GW2DATTOOLS_COMPRESSION_HUFFMANTREEUTILS_H
 
 #include "gw2dattools/exception/Exception.h"
+#include <cassert>
 #include <cstdint>
 #include <cstring> // For memset
 
@@ -27,14 +28,22 @@ namespace gw2dt
             bool isEmpty = true;
         };
 
+        // Every SkippedWordInterval-th word of a compressed stream is a check word that is not part of the data
+        static constexpr uint32_t SkippedWordInterval = 0x4000;
+
+        /**
+         * Bit reader state.
+         * Bits are accumulated left-aligned in a 64-bit buffer, refilled a whole word at a time.
+         * Bounds are only checked when refilling, needBits guarantees the bits that are then read and dropped.
+         */
         struct State
         {
             const uint32_t *input = nullptr;
             uint32_t inputSize = 0;
             uint32_t inputPos = 0;
+            uint32_t nextSkippedPos = SkippedWordInterval - 1;
 
-            uint32_t head = 0;
-            uint32_t buffer = 0;
+            uint64_t buffer = 0;
             uint8_t bits = 0;
 
             bool isEmpty = false;
@@ -45,91 +54,97 @@ namespace gw2dt
 
         void readCode(const HuffmanTree &iHuffmanTree, State &ioState, uint16_t &ioCode);
 
-        inline void pullByte(State &ioState)
+        inline void initializeState(State &ioState, const uint8_t *iInputTab, uint32_t iInputSize)
         {
-            if (ioState.bits >= 32)
-            {
-                throw exception::Exception("Tried to pull a value while we still have 32 bits available.");
-            }
+            ioState.input = reinterpret_cast<const uint32_t *>(iInputTab);
+            ioState.inputSize = iInputSize / 4;
+            ioState.inputPos = 0;
+            ioState.nextSkippedPos = SkippedWordInterval - 1;
 
-            if ((ioState.inputPos + 1) % 0x4000 == 0)
-            {
-                ++(ioState.inputPos);
-            }
+            ioState.buffer = 0;
+            ioState.bits = 0;
 
-            uint32_t aValue = 0;
+            ioState.isEmpty = false;
+        }
 
-            if (ioState.inputPos >= ioState.inputSize)
+        // Fills the buffer with as many words as it can hold, once the input is exhausted a single zero word is provided
+        inline void refill(State &ioState)
+        {
+            while (ioState.bits <= 32)
             {
-                if (ioState.isEmpty)
+                if (ioState.inputPos == ioState.nextSkippedPos)
                 {
-                    throw exception::Exception("Reached end of input while trying to fetch a new byte.");
+                    ++(ioState.inputPos);
+                    ioState.nextSkippedPos += SkippedWordInterval;
                 }
-                ioState.isEmpty = true;
-            }
-            else
-            {
-                aValue = ioState.input[ioState.inputPos];
-            }
 
-            if (ioState.bits == 0)
-            {
-                ioState.head = aValue;
-                ioState.buffer = 0;
+                uint64_t aValue = 0;
+
+                if (ioState.inputPos >= ioState.inputSize)
+                {
+                    if (ioState.isEmpty)
+                    {
+                        return;
+                    }
+                    ioState.isEmpty = true;
+                }
+                else
+                {
+                    aValue = ioState.input[ioState.inputPos];
+                }
+
+                ioState.buffer |= aValue << (32 - ioState.bits);
+                ioState.bits += 32;
+                ++(ioState.inputPos);
             }
-            else
+        }
+
+        // Gives back the whole words still in the buffer and drops the partially read one
+        inline void alignToWord(State &ioState)
+        {
+            uint8_t aNbWords = ioState.bits / 32;
+
+            while (aNbWords > 0)
             {
-                ioState.head |= (aValue >> ioState.bits);
-                ioState.buffer = (aValue << (32 - ioState.bits));
+                --(ioState.inputPos);
+                if (ioState.inputPos % SkippedWordInterval == SkippedWordInterval - 1)
+                {
+                    --(ioState.inputPos);
+                }
+                --aNbWords;
             }
 
-            ioState.bits += 32;
-            ++(ioState.inputPos);
+            ioState.nextSkippedPos = ioState.inputPos | (SkippedWordInterval - 1);
+            ioState.buffer = 0;
+            ioState.bits = 0;
         }
 
         inline void needBits(State &ioState, uint8_t iBits)
         {
-            if (iBits > 32)
-            {
-                throw exception::Exception("Tried to need more than 32 bits.");
-            }
+            assert(iBits <= 32);
 
             if (ioState.bits < iBits)
             {
-                pullByte(ioState);
+                refill(ioState);
+
+                if (ioState.bits < iBits)
+                {
+                    throw exception::Exception("Reached end of input while trying to fetch a new byte.");
+                }
             }
         }
 
         inline void dropBits(State &ioState, uint8_t iBits)
         {
-            if (iBits > 32)
-            {
-                throw exception::Exception("Tried to drop more than 32 bits.");
-            }
-
-            if (iBits > ioState.bits)
-            {
-                throw exception::Exception("Tried to drop more bits than we have.");
-            }
-
-            if (iBits == 32)
-            {
-                ioState.head = ioState.buffer;
-                ioState.buffer = 0;
-            }
-            else
-            {
-                ioState.head <<= iBits;
-                ioState.head |= (ioState.buffer) >> (32 - iBits);
-                ioState.buffer <<= iBits;
-            }
+            assert(iBits <= 32 && iBits <= ioState.bits);
 
+            ioState.buffer <<= iBits;
             ioState.bits -= iBits;
         }
 
         inline uint32_t readBits(const State &iState, uint8_t iBits)
         {
-            return (iState.head) >> (32 - iBits);
+            return static_cast<uint32_t>((iState.buffer) >> (64 - iBits));
         }
 
     } // namespace compression
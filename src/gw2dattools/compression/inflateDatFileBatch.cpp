@@ -0,0 +1,177 @@
+#include "gw2dattools/compression/inflateDatFileBatch.h"
+
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include "gw2dattools/compression/inflateDatFileBuffer.h"
+#include "gw2dattools/exception/Exception.h"
+
+#include "../utils/Parallel.h"
+
+namespace gw2dt
+{
+    namespace compression
+    {
+
+        // The compressed data starts with three words, the second one being the size of the content
+        static const uint32_t sCompressedHeaderSize = 12;
+
+        // Upper bound of the content size per byte of compressed data: a code takes at least two bits,
+        // one for the symbol and one for the offset of a copy, and copies at most 0xFF + 16 bytes
+        static const uint64_t sMaxContentPerInput = 4 * (0xFF + 16);
+
+        DecodedBatch::DecodedBatch(uint8_t *ipArena, uint32_t iArenaSize, const Allocator &iAllocator, std::vector<Span> iSpanVect) : _pArena(ipArena),
+                                                                                                                                      _arenaSize(iArenaSize),
+                                                                                                                                      _allocator(iAllocator),
+                                                                                                                                      _spanVect(std::move(iSpanVect))
+        {
+        }
+
+        DecodedBatch::DecodedBatch(DecodedBatch &&ioBatch) : _pArena(ioBatch._pArena),
+                                                             _arenaSize(ioBatch._arenaSize),
+                                                             _allocator(ioBatch._allocator),
+                                                             _spanVect(std::move(ioBatch._spanVect))
+        {
+            ioBatch._pArena = nullptr;
+            ioBatch._arenaSize = 0;
+        }
+
+        DecodedBatch &DecodedBatch::operator=(DecodedBatch &&ioBatch)
+        {
+            if (this != &ioBatch)
+            {
+                if (_pArena != nullptr)
+                {
+                    _allocator.release(_allocator.context, _pArena);
+                }
+
+                _pArena = ioBatch._pArena;
+                _arenaSize = ioBatch._arenaSize;
+                _allocator = ioBatch._allocator;
+                _spanVect = std::move(ioBatch._spanVect);
+
+                ioBatch._pArena = nullptr;
+                ioBatch._arenaSize = 0;
+            }
+            return *this;
+        }
+
+        DecodedBatch::~DecodedBatch()
+        {
+            if (_pArena != nullptr)
+            {
+                _allocator.release(_allocator.context, _pArena);
+            }
+        }
+
+        const std::vector<DecodedBatch::Span> &DecodedBatch::getSpanVect() const
+        {
+            return _spanVect;
+        }
+
+        const uint8_t *DecodedBatch::getContent(uint32_t iIndex) const
+        {
+            return _pArena + _spanVect[iIndex].offset;
+        }
+
+        uint32_t DecodedBatch::getArenaSize() const
+        {
+            return _arenaSize;
+        }
+
+        GW2DATTOOLS_API DecodedBatch GW2DATTOOLS_APIENTRY inflateDatFileBatch(const std::vector<BatchInput> &iInputVect, uint32_t iNbThreads, const Allocator &iAllocator)
+        {
+            // Sizes first, from the headers
+            std::vector<DecodedBatch::Span> aSpanVect(iInputVect.size());
+            uint64_t aArenaSize = 0;
+
+            for (size_t aIndex = 0; aIndex < iInputVect.size(); ++aIndex)
+            {
+                const BatchInput &aInput = iInputVect[aIndex];
+                DecodedBatch::Span &aSpan = aSpanVect[aIndex];
+
+                aSpan.size = 0;
+                aSpan.isDecoded = false;
+                if (aInput.data != nullptr && aInput.size >= sCompressedHeaderSize)
+                {
+                    memcpy(&aSpan.size, aInput.data + sizeof(uint32_t), sizeof(aSpan.size));
+
+                    // Sizes the data cannot expand to are corrupt, the file is flagged without room in the arena
+                    if (aSpan.size > aInput.size * sMaxContentPerInput)
+                    {
+                        aSpan.size = 0;
+                    }
+                    else
+                    {
+                        aSpan.isDecoded = aSpan.size == 0;
+                    }
+                }
+
+                aSpan.offset = static_cast<uint32_t>(aArenaSize);
+                aArenaSize += (uint64_t(aSpan.size) + DecodedBatch::BatchAlignment - 1) & ~uint64_t(DecodedBatch::BatchAlignment - 1);
+                if (aArenaSize > 0xFFFFFFFF - (DecodedBatch::BatchAlignment - 1))
+                {
+                    throw exception::Exception("The contents of the batch exceed 4 GB.");
+                }
+            }
+
+            // The allocator may return any alignment, the slices start at the first aligned byte
+            uint8_t *pArena = nullptr;
+            if (aArenaSize != 0)
+            {
+                aArenaSize += DecodedBatch::BatchAlignment - 1;
+                pArena = static_cast<uint8_t *>(iAllocator.allocate(iAllocator.context, static_cast<uint32_t>(aArenaSize)));
+                if (pArena == nullptr)
+                {
+                    throw std::bad_alloc();
+                }
+
+                uint32_t aAlignmentOffset = static_cast<uint32_t>(-reinterpret_cast<uintptr_t>(pArena) & (DecodedBatch::BatchAlignment - 1));
+                for (DecodedBatch::Span &aSpan : aSpanVect)
+                {
+                    aSpan.offset += aAlignmentOffset;
+                }
+            }
+
+            std::atomic<size_t> aNextIndex(0);
+            try
+            {
+                utils::runWorkers(iNbThreads, [&](uint32_t)
+                {
+                    for (size_t aIndex = aNextIndex++; aIndex < iInputVect.size(); aIndex = aNextIndex++)
+                    {
+                        DecodedBatch::Span &aSpan = aSpanVect[aIndex];
+                        if (aSpan.size == 0)
+                        {
+                            continue;
+                        }
+
+                        try
+                        {
+                            uint32_t aSize = aSpan.size;
+                            inflateDatFileBuffer(iInputVect[aIndex].size, iInputVect[aIndex].data, aSize, pArena + aSpan.offset);
+                            aSpan.isDecoded = true;
+                        }
+                        catch (std::exception &)
+                        {
+                            aSpan.isDecoded = false;
+                        }
+                    }
+                });
+            }
+            catch (...)
+            {
+                if (pArena != nullptr)
+                {
+                    iAllocator.release(iAllocator.context, pArena);
+                }
+                throw;
+            }
+
+            return DecodedBatch(pArena, static_cast<uint32_t>(aArenaSize), iAllocator, std::move(aSpanVect));
+        }
+
+    } // namespace compression
+} // namespace gw2dt
@@ -1,8 +1,8 @@
 #include "gw2dattools/compression/inflateDatFileBuffer.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <memory.h>
-#include <iostream>
 
 #include "gw2dattools/exception/Exception.h"
 
@@ -29,6 +29,14 @@ namespace gw2dt
             // Static Huffman tree dictionary
             static DatFileHuffmanTree huffmanTreeDictionary;
 
+            // Decoding tables, rebuilt for each block of a buffer
+            struct Scratch
+            {
+                DatFileHuffmanTree huffmanTreeSymbol;
+                DatFileHuffmanTree huffmanTreeCopy;
+                DatFileHuffmanTreeBuilder huffmanTreeBuilder;
+            };
+
             // Parse and build a Huffman tree from input data
             bool parseHuffmanTree(DatFileBitArray &inputBitArray, DatFileHuffmanTree &huffmanTree, DatFileHuffmanTreeBuilder &huffmanTreeBuilder)
             {
@@ -71,8 +79,19 @@ namespace gw2dt
                 return huffmanTreeBuilder.buildHuffmanTree(huffmanTree);
             }
 
+            // Ensures that writing up to outputEnd only overwrites compressed data already loaded by the bit array
+            inline void checkInPlaceWrite(const DatFileBitArray &inputBitArray, uint32_t inputOffset, uint32_t outputEnd)
+            {
+                if (outputEnd > inputOffset + inputBitArray.getNbOfLoadedBytes())
+                {
+                    throw exception::Exception("Output would overwrite compressed data not read yet.");
+                }
+            }
+
             // Inflate data from a compressed bit array into an output buffer
-            void inflateData(DatFileBitArray &inputBitArray, uint32_t outputSize, uint8_t *outputBuffer)
+            // In place, the compressed data lies in the output buffer at inputOffset and every write is checked against it
+            template <bool isInPlace>
+            void inflateData(DatFileBitArray &inputBitArray, uint32_t outputSize, uint8_t *outputBuffer, Scratch &scratch, uint32_t inputOffset)
             {
                 uint32_t outputPos = 0;
 
@@ -84,8 +103,9 @@ namespace gw2dt
                 inputBitArray.drop<4>();
 
                 // Huffman trees for symbols and copy operations
-                DatFileHuffmanTree huffmanTreeSymbol, huffmanTreeCopy;
-                DatFileHuffmanTreeBuilder huffmanTreeBuilder;
+                DatFileHuffmanTree &huffmanTreeSymbol = scratch.huffmanTreeSymbol;
+                DatFileHuffmanTree &huffmanTreeCopy = scratch.huffmanTreeCopy;
+                DatFileHuffmanTreeBuilder &huffmanTreeBuilder = scratch.huffmanTreeBuilder;
 
                 while (outputPos < outputSize)
                 {
@@ -114,6 +134,11 @@ namespace gw2dt
 
                         if (symbol < 0x100)
                         {
+                            if (isInPlace)
+                            {
+                                checkInPlaceWrite(inputBitArray, inputOffset, outputPos + 1);
+                            }
+
                             // Directly write the symbol as a byte
                             outputBuffer[outputPos++] = static_cast<uint8_t>(symbol);
                             continue;
@@ -157,6 +182,11 @@ namespace gw2dt
                         }
                         writeOffset += 1;
 
+                        if (isInPlace)
+                        {
+                            checkInPlaceWrite(inputBitArray, inputOffset, std::min(outputPos + writeSize, outputSize));
+                        }
+
                         // Copy the data to the output buffer
                         for (uint32_t i = 0; i < writeSize && outputPos < outputSize; ++i)
                         {
@@ -169,11 +199,14 @@ namespace gw2dt
 
         }
 
-        GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY inflateDatFileBuffer(
+        // Inflates into the output buffer if given, or into a buffer of the allocator
+        static uint8_t *inflateDatFileBufferImpl(
             uint32_t inputSize,
             const uint8_t *inputBuffer,
             uint32_t &outputSize,
-            uint8_t *outputBuffer)
+            uint8_t *outputBuffer,
+            const Allocator &allocator,
+            dat::Scratch &scratch)
         {
             if (inputBuffer == nullptr)
             {
@@ -194,8 +227,6 @@ namespace gw2dt
                 inputBitArray.drop<uint32_t>(); // Skip header
                 uint32_t uncompressedSize;
                 inputBitArray.read(uncompressedSize);
-                std::cout << "\nUncompressed Size: " << uncompressedSize << "\n\n"
-                          << std::endl;
 
                 inputBitArray.drop<uint32_t>(); // Skip another header part
 
@@ -208,7 +239,7 @@ namespace gw2dt
 
                 if (outputBuffer == nullptr)
                 {
-                    finalOutputBuffer = static_cast<uint8_t *>(malloc(uncompressedSize));
+                    finalOutputBuffer = static_cast<uint8_t *>(allocator.allocate(allocator.context, uncompressedSize));
                     if (finalOutputBuffer == nullptr)
                     {
                         throw std::bad_alloc();
@@ -220,7 +251,7 @@ namespace gw2dt
                     finalOutputBuffer = outputBuffer;
                 }
 
-                dat::inflateData(inputBitArray, uncompressedSize, finalOutputBuffer);
+                dat::inflateData<false>(inputBitArray, uncompressedSize, finalOutputBuffer, scratch, 0);
 
                 return finalOutputBuffer;
             }
@@ -228,12 +259,114 @@ namespace gw2dt
             {
                 if (ownsBuffer && finalOutputBuffer != nullptr)
                 {
-                    free(finalOutputBuffer);
+                    allocator.release(allocator.context, finalOutputBuffer);
                 }
                 throw; // Rethrow any exception
             }
         }
 
+        // Bounds of the compressed data still to be read when the output is written in place. A byte of output
+        // takes at most a copy of a single byte: two codes of 31 bits and 20 extra bits. The trees of a block
+        // take at most 9160 bits, shared by at least 0x1000 codes unless it is the last block, and the check
+        // words one word every 0x4000, which makes less than sInPlaceMaxInputPerOutput bytes for each byte of
+        // output still to write. The trees of the last block, a check word and up to 64 bytes of padding after
+        // the last code make less than sInPlaceTailSize bytes more.
+        static const uint32_t sInPlaceMaxInputPerOutput = 11;
+        static const uint32_t sInPlaceTailSize = 1280;
+
+        // Inflates the compressed data ending the buffer into the start of the same buffer
+        static void inflateDatFileBufferInPlaceImpl(
+            uint32_t bufferSize,
+            uint8_t *buffer,
+            uint32_t inputSize,
+            uint32_t &outputSize,
+            dat::Scratch &scratch)
+        {
+            if (buffer == nullptr)
+            {
+                throw exception::Exception("Buffer is null.");
+            }
+
+            if (inputSize > bufferSize)
+            {
+                throw exception::Exception("Compressed data is larger than the buffer.");
+            }
+
+            // A trailing partial word is ignored, as when inflating into another buffer
+            uint32_t inputOffset = bufferSize - inputSize;
+            dat::DatFileBitArray inputBitArray(buffer + inputOffset, inputSize & ~3u, 16384);
+            inputBitArray.drop<uint32_t>(); // Skip header
+            uint32_t uncompressedSize;
+            inputBitArray.read(uncompressedSize);
+
+            inputBitArray.drop<uint32_t>(); // Skip another header part
+
+            if (outputSize != 0)
+            {
+                uncompressedSize = std::min(uncompressedSize, outputSize);
+            }
+
+            if (uncompressedSize > bufferSize)
+            {
+                throw exception::Exception("Buffer is too small for the output.");
+            }
+
+            outputSize = uncompressedSize;
+
+            dat::inflateData<true>(inputBitArray, uncompressedSize, buffer, scratch, inputOffset);
+        }
+
+        GW2DATTOOLS_API uint32_t GW2DATTOOLS_APIENTRY getInPlaceBufferSize(uint32_t inputSize, uint32_t outputSize)
+        {
+            // Writing w bytes leaves at most min(input size, sInPlaceMaxInputPerOutput * (output size - w) + tail)
+            // bytes to read behind them, which peaks where both terms meet
+            uint64_t bufferSize = uint64_t(outputSize) + inputSize;
+            uint32_t alignedInputSize = inputSize & ~3u;
+            if (alignedInputSize > sInPlaceTailSize)
+            {
+                bufferSize -= (alignedInputSize - sInPlaceTailSize) / sInPlaceMaxInputPerOutput;
+            }
+            bufferSize = std::max<uint64_t>(bufferSize, inputSize);
+
+            // Keeps the compressed data aligned on a word when placed at the end of an aligned buffer
+            bufferSize = inputSize + ((bufferSize - inputSize + 3) & ~uint64_t(3));
+            if (bufferSize > 0xFFFFFFFF)
+            {
+                throw exception::Exception("Buffer size exceeds 4 GB.");
+            }
+            return static_cast<uint32_t>(bufferSize);
+        }
+
+        GW2DATTOOLS_API void GW2DATTOOLS_APIENTRY inflateDatFileBufferInPlace(
+            uint32_t bufferSize,
+            uint8_t *buffer,
+            uint32_t inputSize,
+            uint32_t &outputSize)
+        {
+            dat::Scratch scratch;
+            inflateDatFileBufferInPlaceImpl(bufferSize, buffer, inputSize, outputSize, scratch);
+        }
+
+        GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY inflateDatFileBuffer(
+            uint32_t inputSize,
+            const uint8_t *inputBuffer,
+            uint32_t &outputSize,
+            uint8_t *outputBuffer)
+        {
+            dat::Scratch scratch;
+            return inflateDatFileBufferImpl(inputSize, inputBuffer, outputSize, outputBuffer, getDefaultAllocator(), scratch);
+        }
+
+        GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY inflateDatFileBuffer(
+            uint32_t inputSize,
+            const uint8_t *inputBuffer,
+            uint32_t &outputSize,
+            const Allocator &allocator)
+        {
+            dat::Scratch scratch;
+            return inflateDatFileBufferImpl(inputSize, inputBuffer, outputSize, nullptr, allocator, scratch);
+        }
+
         class DatFileHuffmanTreeDictStaticInitializer
         {
         public:
@@ -265,14 +398,14 @@ namespace gw2dt
                                         0x2F, 0x21, 0x1F, 0x1E, 0x1D, 0x1C, 0x1B, 0x1A, 0x19, 0x18, 0x17, 0x16, 0x15, 0x14, 0x13,
                                         0x12};
             std::vector<int> bitLengths = {3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7, 8, 8, 8, 8,
-                                           8, 8, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-                                           1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-                                           1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-                                           1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-                                           1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-                                           1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-                                           1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-                                           1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+                                           8, 8, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 11, 11,
+                                           11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 12, 12, 12, 12, 12, 12, 12, 13, 13, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15,
+                                           15, 15, 15, 15, 15, 15, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+                                           16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+                                           16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+                                           16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+                                           16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+                                           16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16};
 
             // Add each symbol with its corresponding bit length
             for (size_t i = 0; i < symbols.size(); ++i)
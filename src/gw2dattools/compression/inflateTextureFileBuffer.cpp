@@ -2,10 +2,12 @@
 
 #include <cstdlib>
 #include <memory.h>
+#include <new>
 
 #include "gw2dattools/exception/Exception.h"
 
 #include "huffmanTreeUtils.h"
+#include "textureRunFill.h"
 
 #include <iostream>
 #include <vector>
@@ -17,24 +19,6 @@ namespace gw2dt
         namespace texture
         {
 
-            struct Format
-            {
-                uint16_t flags;
-                uint16_t pixelSizeInBits;
-            };
-
-            struct FullFormat
-            {
-                Format format;
-                uint32_t nbObPixelBlocks;
-                uint32_t bytesPerPixelBlock;
-                uint32_t bytesPerComponent;
-                bool hasTwoComponents;
-
-                uint16_t width;
-                uint16_t height;
-            };
-
             enum FormatFlags
             {
                 FF_COLOR = 0x10,
@@ -52,44 +36,106 @@ namespace gw2dt
                 CF_DECODE_PLAIN_COLOR = 0x08
             };
 
-            // Static Values
-            HuffmanTree sHuffmanTreeDict;
-            Format sFormats[9];
-            bool sStaticValuesInitialized(false);
+            /**
+             * Compile-time description of a texture format.
+             * All the per-block layout values are derived from the flags and the pixel size,
+             * so that the decoding helpers instantiated for a format get them as constants.
+             * @tparam sFlags Combination of FormatFlags.
+             * @tparam sPixelSizeInBits Number of bits per pixel.
+             */
+            template <uint16_t sFlags, uint16_t sPixelSizeInBits>
+            struct FormatTraits
+            {
+                static const uint16_t flags = sFlags;
+                static const uint16_t pixelSizeInBits = sPixelSizeInBits;
+
+                static const uint32_t bytesPerPixelBlock = (sPixelSizeInBits * 4 * 4) / 8;
+                static const bool hasTwoComponents =
+                    ((sFlags & (FF_PLAINCOMP | FF_COLOR | FF_ALPHA)) == (FF_PLAINCOMP | FF_COLOR | FF_ALPHA)) || ((sFlags & FF_BICOLORCOMP) != 0);
+                static const uint32_t bytesPerComponent = bytesPerPixelBlock / (hasTwoComponents ? 2 : 1);
+
+                // Offset of the color component inside a pixel block
+                static const uint32_t colorComponentOffset = hasTwoComponents ? bytesPerComponent : 0;
+                // Constant values are at most 64 bits wide
+                static const uint32_t bytesPerConstantValue = bytesPerComponent < sizeof(uint64_t) ? bytesPerComponent : sizeof(uint64_t);
+
+                static const bool hasPlainAlpha = (((sFlags & FF_ALPHA) != 0) && ((sFlags & FF_DEDUCEDALPHACOMP) == 0)) || ((sFlags & FF_BICOLORCOMP) != 0);
+                static const bool hasPlainColor = ((sFlags & FF_COLOR) != 0) || ((sFlags & FF_BICOLORCOMP) != 0);
+            };
+
+            typedef FormatTraits<FF_COLOR | FF_ALPHA | FF_DEDUCEDALPHACOMP, 4> Dxt1FormatTraits;
+            typedef FormatTraits<FF_COLOR | FF_ALPHA | FF_PLAINCOMP, 8> Dxt5FormatTraits; // DXT2, DXT3, DXT4 and DXT5
+            typedef FormatTraits<FF_ALPHA | FF_PLAINCOMP, 4> DxtAFormatTraits;
+            typedef FormatTraits<FF_COLOR, 8> DxtLFormatTraits;
+            typedef FormatTraits<FF_BICOLORCOMP, 8> DxtNFormatTraits; // DXTN and 3DCX
+
+            struct FullFormat;
 
-            void initializeStaticValues()
+            // Bitmaps of the blocks already decoded, kept by a TextureInflater between textures
+            struct Scratch
             {
-                // Formats
-                {
-                    Format &aDxt1Format = sFormats[0];
-                    aDxt1Format.flags = FF_COLOR | FF_ALPHA | FF_DEDUCEDALPHACOMP;
-                    aDxt1Format.pixelSizeInBits = 4;
+                BlockBitmap colorBitmap;
+                BlockBitmap alphaBitmap;
+            };
 
-                    Format &aDxt2Format = sFormats[1];
-                    aDxt2Format.flags = FF_COLOR | FF_ALPHA | FF_PLAINCOMP;
-                    aDxt2Format.pixelSizeInBits = 8;
+            typedef void (*InflateDataFunction)(State &iState, const FullFormat &iFullFormat, uint32_t ioOutputSize, uint8_t *ioOutputTab, Scratch &ioScratch);
 
-                    sFormats[2] = sFormats[1];
-                    sFormats[3] = sFormats[1];
-                    sFormats[4] = sFormats[1];
+            struct Format
+            {
+                uint16_t flags;
+                uint16_t pixelSizeInBits;
 
-                    Format &aDxtAFormat = sFormats[5];
-                    aDxtAFormat.flags = FF_ALPHA | FF_PLAINCOMP;
-                    aDxtAFormat.pixelSizeInBits = 4;
+                // Decoding path specialized for this format
+                InflateDataFunction inflateData;
+            };
 
-                    Format &aDxtLFormat = sFormats[6];
-                    aDxtLFormat.flags = FF_COLOR;
-                    aDxtLFormat.pixelSizeInBits = 8;
+            struct FullFormat
+            {
+                Format format;
+                uint32_t nbObPixelBlocks;
+
+                uint16_t width;
+                uint16_t height;
+            };
+
+            // Releases the output buffer allocated for a call unless the decoding went through
+            class OwnedOutputTab
+            {
+            public:
+                explicit OwnedOutputTab(const Allocator &iAllocator) : _allocator(iAllocator),
+                                                                       _pOutputTab(nullptr)
+                {
+                }
+
+                ~OwnedOutputTab()
+                {
+                    if (_pOutputTab != nullptr)
+                    {
+                        _allocator.release(_allocator.context, _pOutputTab);
+                    }
+                }
 
-                    Format &aDxtNFormat = sFormats[7];
-                    aDxtNFormat.flags = FF_BICOLORCOMP;
-                    aDxtNFormat.pixelSizeInBits = 8;
+                OwnedOutputTab(const OwnedOutputTab &) = delete;
+                OwnedOutputTab &operator=(const OwnedOutputTab &) = delete;
 
-                    Format &a3dcxFormat = sFormats[8];
-                    a3dcxFormat.flags = FF_BICOLORCOMP;
-                    a3dcxFormat.pixelSizeInBits = 8;
+                void reset(uint8_t *ipOutputTab)
+                {
+                    _pOutputTab = ipOutputTab;
+                }
+
+                void dismiss()
+                {
+                    _pOutputTab = nullptr;
                 }
 
+            private:
+                const Allocator &_allocator;
+                uint8_t *_pOutputTab;
+            };
+
+            HuffmanTree buildHuffmanTreeDict()
+            {
+                HuffmanTree aHuffmanTreeDict;
                 int16_t aWorkingBitTab[MaxCodeBitsLength];
                 int16_t aWorkingCodeTab[MaxSymbolValue];
 
@@ -105,46 +151,19 @@ namespace gw2dt
                     fillWorkingTabsHelper(bitLengths[i], symbols[i], &aWorkingBitTab[0], &aWorkingCodeTab[0]);
                 }
 
-                return buildHuffmanTree(sHuffmanTreeDict, &aWorkingBitTab[0], &aWorkingCodeTab[0]);
+                buildHuffmanTree(aHuffmanTreeDict, &aWorkingBitTab[0], &aWorkingCodeTab[0]);
+                return aHuffmanTreeDict;
             }
 
-            Format deduceFormat(uint32_t iFourCC)
+            // Shared by all the calls, built on first use and never modified afterwards
+            const HuffmanTree &getHuffmanTreeDict()
             {
-                switch (iFourCC)
-                {
-                case 0x31545844: // DXT1
-                    return sFormats[0];
-
-                case 0x32545844: // DXT2
-                    return sFormats[1];
-
-                case 0x33545844: // DXT3
-                    return sFormats[2];
-
-                case 0x34545844: // DXT4
-                    return sFormats[3];
-
-                case 0x35545844: // DXT5
-                    return sFormats[4];
-
-                case 0x41545844: // DXTA
-                    return sFormats[5];
-
-                case 0x4C545844: // DXTL
-                    return sFormats[6];
-
-                case 0x4E545844: // DXTN
-                    return sFormats[7];
-
-                case 0x58434433: // 3DCX
-                    return sFormats[8];
-
-                default:
-                    throw exception::Exception("Unknown format.");
-                }
+                static const HuffmanTree sHuffmanTreeDict(buildHuffmanTreeDict());
+                return sHuffmanTreeDict;
             }
 
-            void decodeWhiteColor(State &ioState, std::vector<bool> &ioAlphaBitMap, std::vector<bool> &ioColorBitMap, const FullFormat &iFullFormat, uint8_t *ioOutputTab)
+            template <typename FormatTraitsType>
+            void decodeWhiteColor(const HuffmanTree &iHuffmanTreeDict, State &ioState, BlockBitmap &ioAlphaBitMap, BlockBitmap &ioColorBitMap, const FullFormat &iFullFormat, uint8_t *ioOutputTab)
             {
                 uint32_t aPixelBlockPos = 0;
 
@@ -152,36 +171,20 @@ namespace gw2dt
                 {
                     // Reading next code
                     uint16_t aCode = 0;
-                    readCode(sHuffmanTreeDict, ioState, aCode);
+                    readCode(iHuffmanTreeDict, ioState, aCode);
 
                     needBits(ioState, 1);
                     uint32_t aValue = readBits(ioState, 1);
                     dropBits(ioState, 1);
 
-                    while (aCode > 0)
-                    {
-                        if (!ioColorBitMap[aPixelBlockPos])
-                        {
-                            if (aValue)
-                            {
-                                *reinterpret_cast<int64_t *>(&(ioOutputTab[iFullFormat.bytesPerPixelBlock * (aPixelBlockPos)])) = 0xFFFFFFFFFFFFFFFE;
-
-                                ioAlphaBitMap[aPixelBlockPos] = true;
-                                ioColorBitMap[aPixelBlockPos] = true;
-                            }
-                            --aCode;
-                        }
-                        ++aPixelBlockPos;
-                    }
-
-                    while (aPixelBlockPos < iFullFormat.nbObPixelBlocks && ioColorBitMap[aPixelBlockPos])
-                    {
-                        ++aPixelBlockPos;
-                    }
+                    aPixelBlockPos = applyRun<FormatTraitsType::bytesPerPixelBlock, sizeof(uint64_t)>(ioColorBitMap, &ioAlphaBitMap, aPixelBlockPos, aCode, aValue != 0,
+                                                                                                       0xFFFFFFFFFFFFFFFE, ioOutputTab);
+                    aPixelBlockPos = ioColorBitMap.findNextUnset(aPixelBlockPos, iFullFormat.nbObPixelBlocks);
                 }
             }
 
-            void decodeConstantAlphaFrom4Bits(State &ioState, std::vector<bool> &ioAlphaBitMap, const FullFormat &iFullFormat, uint8_t *ioOutputTab)
+            template <typename FormatTraitsType>
+            void decodeConstantAlphaFrom4Bits(const HuffmanTree &iHuffmanTreeDict, State &ioState, BlockBitmap &ioAlphaBitMap, const FullFormat &iFullFormat, uint8_t *ioOutputTab)
             {
                 needBits(ioState, 4);
                 uint8_t aAlphaValueByte = static_cast<uint8_t>(readBits(ioState, 4));
@@ -193,13 +196,12 @@ namespace gw2dt
                 uint32_t aIntermediateWord = aIntermediateByte | (aIntermediateByte << 8);
                 uint64_t aIntermediateDWord = aIntermediateWord | (aIntermediateWord << 16);
                 uint64_t aAlphaValue = aIntermediateDWord | (aIntermediateDWord << 32);
-                uint64_t zero = 0;
 
                 while (aPixelBlockPos < iFullFormat.nbObPixelBlocks)
                 {
                     // Reading next code
                     uint16_t aCode = 0;
-                    readCode(sHuffmanTreeDict, ioState, aCode);
+                    readCode(iHuffmanTreeDict, ioState, aCode);
 
                     needBits(ioState, 2);
                     uint32_t aValue = readBits(ioState, 1);
@@ -210,28 +212,14 @@ namespace gw2dt
                     {
                         dropBits(ioState, 1);
                     }
-                    while (aCode > 0)
-                    {
-                        if (!ioAlphaBitMap[aPixelBlockPos])
-                        {
-                            if (aValue)
-                            {
-                                memcpy(&(ioOutputTab[iFullFormat.bytesPerPixelBlock * (aPixelBlockPos)]), isNotNull ? &aAlphaValue : &zero, iFullFormat.bytesPerComponent);
-                                ioAlphaBitMap[aPixelBlockPos] = true;
-                            }
-                            --aCode;
-                        }
-                        ++aPixelBlockPos;
-                    }
-
-                    while (aPixelBlockPos < iFullFormat.nbObPixelBlocks && ioAlphaBitMap[aPixelBlockPos])
-                    {
-                        ++aPixelBlockPos;
-                    }
+                    aPixelBlockPos = applyRun<FormatTraitsType::bytesPerPixelBlock, FormatTraitsType::bytesPerConstantValue>(ioAlphaBitMap, nullptr, aPixelBlockPos, aCode, aValue != 0,
+                                                                                                                              isNotNull ? aAlphaValue : 0, ioOutputTab);
+                    aPixelBlockPos = ioAlphaBitMap.findNextUnset(aPixelBlockPos, iFullFormat.nbObPixelBlocks);
                 }
             }
 
-            void decodeConstantAlphaFrom8Bits(State &ioState, std::vector<bool> &ioAlphaBitMap, const FullFormat &iFullFormat, uint8_t *ioOutputTab)
+            template <typename FormatTraitsType>
+            void decodeConstantAlphaFrom8Bits(const HuffmanTree &iHuffmanTreeDict, State &ioState, BlockBitmap &ioAlphaBitMap, const FullFormat &iFullFormat, uint8_t *ioOutputTab)
             {
                 needBits(ioState, 8);
                 uint8_t aAlphaValueByte = static_cast<uint8_t>(readBits(ioState, 8));
@@ -240,13 +228,12 @@ namespace gw2dt
                 uint32_t aPixelBlockPos = 0;
 
                 uint64_t aAlphaValue = aAlphaValueByte | (aAlphaValueByte << 8);
-                uint64_t zero = 0;
 
                 while (aPixelBlockPos < iFullFormat.nbObPixelBlocks)
                 {
                     // Reading next code
                     uint16_t aCode = 0;
-                    readCode(sHuffmanTreeDict, ioState, aCode);
+                    readCode(iHuffmanTreeDict, ioState, aCode);
 
                     needBits(ioState, 2);
                     uint32_t aValue = readBits(ioState, 1);
@@ -257,28 +244,14 @@ namespace gw2dt
                     {
                         dropBits(ioState, 1);
                     }
-                    while (aCode > 0)
-                    {
-                        if (!ioAlphaBitMap[aPixelBlockPos])
-                        {
-                            if (aValue)
-                            {
-                                memcpy(&(ioOutputTab[iFullFormat.bytesPerPixelBlock * (aPixelBlockPos)]), isNotNull ? &aAlphaValue : &zero, iFullFormat.bytesPerComponent);
-                                ioAlphaBitMap[aPixelBlockPos] = true;
-                            }
-                            --aCode;
-                        }
-                        ++aPixelBlockPos;
-                    }
-
-                    while (aPixelBlockPos < iFullFormat.nbObPixelBlocks && ioAlphaBitMap[aPixelBlockPos])
-                    {
-                        ++aPixelBlockPos;
-                    }
+                    aPixelBlockPos = applyRun<FormatTraitsType::bytesPerPixelBlock, FormatTraitsType::bytesPerConstantValue>(ioAlphaBitMap, nullptr, aPixelBlockPos, aCode, aValue != 0,
+                                                                                                                              isNotNull ? aAlphaValue : 0, ioOutputTab);
+                    aPixelBlockPos = ioAlphaBitMap.findNextUnset(aPixelBlockPos, iFullFormat.nbObPixelBlocks);
                 }
             }
 
-            void decodePlainColor(State &ioState, std::vector<bool> &ioColorBitMap, const FullFormat &iFullFormat, uint8_t *ioOutputTab)
+            template <typename FormatTraitsType>
+            void decodePlainColor(const HuffmanTree &iHuffmanTreeDict, State &ioState, BlockBitmap &ioColorBitMap, const FullFormat &iFullFormat, uint8_t *ioOutputTab)
             {
                 needBits(ioState, 24);
                 uint16_t aBlue = static_cast<uint16_t>(readBits(ioState, 8));
@@ -438,7 +411,7 @@ namespace gw2dt
                     aTempValue1 = (aTempValue1 + (aTempValue2 / 2)) / aTempValue2;
                 }
 
-                bool aDxt1SpecialCase = (iFullFormat.format.flags & FF_DEDUCEDALPHACOMP) && (aTempValue1 == 5 || aTempValue1 == 6 || aTempValue2 != 0);
+                bool aDxt1SpecialCase = ((FormatTraitsType::flags & FF_DEDUCEDALPHACOMP) != 0) && (aTempValue1 == 5 || aTempValue1 == 6 || aTempValue2 != 0);
 
                 if (aTempValue2 > 0 && !aDxt1SpecialCase)
                 {
@@ -501,47 +474,23 @@ namespace gw2dt
                 {
                     // Reading next code
                     uint16_t aCode = 0;
-                    readCode(sHuffmanTreeDict, ioState, aCode);
+                    readCode(iHuffmanTreeDict, ioState, aCode);
 
                     needBits(ioState, 1);
                     uint32_t aValue = readBits(ioState, 1);
                     dropBits(ioState, 1);
 
-                    while (aCode > 0)
-                    {
-                        if (!ioColorBitMap[aPixelBlockPos])
-                        {
-                            if (aValue)
-                            {
-                                uint32_t aOffset = iFullFormat.bytesPerPixelBlock * (aPixelBlockPos) + (iFullFormat.hasTwoComponents ? iFullFormat.bytesPerComponent : 0);
-                                memcpy(&(ioOutputTab[aOffset]), &aFinalValue, iFullFormat.bytesPerComponent);
-                                ioColorBitMap[aPixelBlockPos] = true;
-                            }
-                            --aCode;
-                        }
-                        ++aPixelBlockPos;
-                    }
-
-                    while (aPixelBlockPos < iFullFormat.nbObPixelBlocks && ioColorBitMap[aPixelBlockPos])
-                    {
-                        ++aPixelBlockPos;
-                    }
+                    aPixelBlockPos = applyRun<FormatTraitsType::bytesPerPixelBlock, FormatTraitsType::bytesPerConstantValue>(ioColorBitMap, nullptr, aPixelBlockPos, aCode, aValue != 0,
+                                                                                                                              aFinalValue, ioOutputTab + FormatTraitsType::colorComponentOffset);
+                    aPixelBlockPos = ioColorBitMap.findNextUnset(aPixelBlockPos, iFullFormat.nbObPixelBlocks);
                 }
             }
 
-            void inflateData(State &iState, const FullFormat &iFullFormat, uint32_t ioOutputSize, uint8_t *ioOutputTab)
+            template <typename FormatTraitsType>
+            void inflateData(State &iState, const FullFormat &iFullFormat, uint32_t ioOutputSize, uint8_t *ioOutputTab, Scratch &ioScratch)
             {
-                // Bitmaps
-                std::vector<bool> aColorBitmap;
-                std::vector<bool> aAlphaBitmap;
-
-                uint32_t aChunkStartPosition = iState.inputPos;
-
-                iState.inputPos = aChunkStartPosition;
-
-                iState.head = 0;
-                iState.bits = 0;
-                iState.buffer = 0;
+                // Compressed data starts on a word boundary
+                alignToWord(iState);
 
                 // Getting size of compressed data
                 needBits(iState, 32);
@@ -553,71 +502,74 @@ namespace gw2dt
                 uint32_t aCompressionFlags = readBits(iState, 32);
                 dropBits(iState, 32);
 
-                aColorBitmap.assign(iFullFormat.nbObPixelBlocks, false);
-                aAlphaBitmap.assign(iFullFormat.nbObPixelBlocks, false);
+                const HuffmanTree &aHuffmanTreeDict = getHuffmanTreeDict();
+
+                // Bitmaps of the blocks already decoded
+                BlockBitmap &aColorBitmap = ioScratch.colorBitmap;
+                BlockBitmap &aAlphaBitmap = ioScratch.alphaBitmap;
+                aColorBitmap.reset(iFullFormat.nbObPixelBlocks);
+                aAlphaBitmap.reset(iFullFormat.nbObPixelBlocks);
 
                 if (aCompressionFlags & CF_DECODE_WHITE_COLOR)
                 {
-                    decodeWhiteColor(iState, aAlphaBitmap, aColorBitmap, iFullFormat, ioOutputTab);
+                    decodeWhiteColor<FormatTraitsType>(aHuffmanTreeDict, iState, aAlphaBitmap, aColorBitmap, iFullFormat, ioOutputTab);
                 }
 
                 if (aCompressionFlags & CF_DECODE_CONSTANT_ALPHA_FROM4BITS)
                 {
-                    decodeConstantAlphaFrom4Bits(iState, aAlphaBitmap, iFullFormat, ioOutputTab);
+                    decodeConstantAlphaFrom4Bits<FormatTraitsType>(aHuffmanTreeDict, iState, aAlphaBitmap, iFullFormat, ioOutputTab);
                 }
 
                 if (aCompressionFlags & CF_DECODE_CONSTANT_ALPHA_FROM8BITS)
                 {
-                    decodeConstantAlphaFrom8Bits(iState, aAlphaBitmap, iFullFormat, ioOutputTab);
+                    decodeConstantAlphaFrom8Bits<FormatTraitsType>(aHuffmanTreeDict, iState, aAlphaBitmap, iFullFormat, ioOutputTab);
                 }
 
                 if (aCompressionFlags & CF_DECODE_PLAIN_COLOR)
                 {
-                    decodePlainColor(iState, aColorBitmap, iFullFormat, ioOutputTab);
+                    decodePlainColor<FormatTraitsType>(aHuffmanTreeDict, iState, aColorBitmap, iFullFormat, ioOutputTab);
                 }
 
                 uint32_t aLoopIndex;
 
-                if (iState.bits >= 32)
-                {
-                    --iState.inputPos;
-                }
+                // Plain data follows on the next word boundary
+                alignToWord(iState);
 
-                if ((((iFullFormat.format.flags) & FF_ALPHA) && !((iFullFormat.format.flags) & FF_DEDUCEDALPHACOMP)) || (iFullFormat.format.flags) & FF_BICOLORCOMP)
+                if (FormatTraitsType::hasPlainAlpha)
                 {
-                    for (aLoopIndex = 0; aLoopIndex < aAlphaBitmap.size() && iState.inputPos < iState.inputSize; ++aLoopIndex)
+                    for (aLoopIndex = 0; aLoopIndex < aAlphaBitmap.getSize() && iState.inputPos < iState.inputSize; ++aLoopIndex)
                     {
-                        if (!aAlphaBitmap[aLoopIndex])
+                        if (!aAlphaBitmap.test(aLoopIndex))
                         {
-                            (*reinterpret_cast<uint32_t *>(&(ioOutputTab[iFullFormat.bytesPerPixelBlock * aLoopIndex]))) = iState.input[iState.inputPos];
+                            (*reinterpret_cast<uint32_t *>(&(ioOutputTab[FormatTraitsType::bytesPerPixelBlock * aLoopIndex]))) = iState.input[iState.inputPos];
                             ++iState.inputPos;
-                            if (iFullFormat.bytesPerComponent > 4)
+                            if (FormatTraitsType::bytesPerComponent > 4 && iState.inputPos < iState.inputSize)
                             {
-                                (*reinterpret_cast<uint32_t *>(&(ioOutputTab[iFullFormat.bytesPerPixelBlock * aLoopIndex + 4]))) = iState.input[iState.inputPos];
+                                (*reinterpret_cast<uint32_t *>(&(ioOutputTab[FormatTraitsType::bytesPerPixelBlock * aLoopIndex + 4]))) = iState.input[iState.inputPos];
                                 ++iState.inputPos;
                             }
                         }
                     }
                 }
 
-                if ((iFullFormat.format.flags) & FF_COLOR || (iFullFormat.format.flags) & FF_BICOLORCOMP)
+                if (FormatTraitsType::hasPlainColor)
                 {
-                    for (aLoopIndex = 0; aLoopIndex < aColorBitmap.size() && iState.inputPos < iState.inputSize; ++aLoopIndex)
+                    for (aLoopIndex = 0; aLoopIndex < aColorBitmap.getSize() && iState.inputPos < iState.inputSize; ++aLoopIndex)
                     {
-                        if (!aColorBitmap[aLoopIndex])
+                        if (!aColorBitmap.test(aLoopIndex))
                         {
-                            uint32_t aOffset = iFullFormat.bytesPerPixelBlock * aLoopIndex + (iFullFormat.hasTwoComponents ? iFullFormat.bytesPerComponent : 0);
+                            uint32_t aOffset = FormatTraitsType::bytesPerPixelBlock * aLoopIndex + FormatTraitsType::colorComponentOffset;
                             (*reinterpret_cast<uint32_t *>(&(ioOutputTab[aOffset]))) = iState.input[iState.inputPos];
                             ++iState.inputPos;
                         }
                     }
-                    if (iFullFormat.bytesPerComponent > 4)
+                    if (FormatTraitsType::bytesPerComponent > 4)
                     {
-                        for (aLoopIndex = 0; aLoopIndex < aColorBitmap.size() && iState.inputPos < iState.inputSize; ++aLoopIndex)
+                        for (aLoopIndex = 0; aLoopIndex < aColorBitmap.getSize() && iState.inputPos < iState.inputSize; ++aLoopIndex)
                         {
-                            if (!aColorBitmap[aLoopIndex])
+                            if (!aColorBitmap.test(aLoopIndex))
                             {
-                                uint32_t aOffset = iFullFormat.bytesPerPixelBlock * aLoopIndex + 4 + (iFullFormat.hasTwoComponents ? iFullFormat.bytesPerComponent : 0);
+                                uint32_t aOffset = FormatTraitsType::bytesPerPixelBlock * aLoopIndex + 4 + FormatTraitsType::colorComponentOffset;
                                 (*reinterpret_cast<uint32_t *>(&(ioOutputTab[aOffset]))) = iState.input[iState.inputPos];
                                 ++iState.inputPos;
                             }
@@ -625,9 +577,50 @@ namespace gw2dt
                     }
                 }
             }
+
+            template <typename FormatTraitsType>
+            Format makeFormat()
+            {
+                Format aFormat;
+                aFormat.flags = FormatTraitsType::flags;
+                aFormat.pixelSizeInBits = FormatTraitsType::pixelSizeInBits;
+                aFormat.inflateData = &inflateData<FormatTraitsType>;
+                return aFormat;
+            }
+
+            // Selects the decoding path instantiated for the given format
+            Format deduceFormat(uint32_t iFourCC)
+            {
+                switch (iFourCC)
+                {
+                case 0x31545844: // DXT1
+                    return makeFormat<Dxt1FormatTraits>();
+
+                case 0x32545844: // DXT2
+                case 0x33545844: // DXT3
+                case 0x34545844: // DXT4
+                case 0x35545844: // DXT5
+                    return makeFormat<Dxt5FormatTraits>();
+
+                case 0x41545844: // DXTA
+                    return makeFormat<DxtAFormatTraits>();
+
+                case 0x4C545844: // DXTL
+                    return makeFormat<DxtLFormatTraits>();
+
+                case 0x4E545844: // DXTN
+                case 0x58434433: // 3DCX
+                    return makeFormat<DxtNFormatTraits>();
+
+                default:
+                    throw exception::Exception("Unknown format.");
+                }
+            }
         }
 
-        GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY inflateTextureFileBuffer(uint32_t iInputSize, const uint8_t *iInputTab, uint32_t &ioOutputSize, uint8_t *ioOutputTab)
+        // Inflates into the output buffer if given, or into a buffer of the allocator
+        static uint8_t *inflateTextureFileBufferImpl(uint32_t iInputSize, const uint8_t *iInputTab, uint32_t &ioOutputSize, uint8_t *ioOutputTab,
+                                                     const Allocator &iAllocator, texture::Scratch &ioScratch)
         {
             if (iInputTab == nullptr)
             {
@@ -639,99 +632,112 @@ namespace gw2dt
                 throw exception::Exception("Output buffer is not null and outputSize is not defined.");
             }
 
-            uint8_t *anOutputTab(nullptr);
-            bool isOutputTabOwned(true);
-
-            try
-            {
-                if (!texture::sStaticValuesInitialized)
-                {
-                    texture::initializeStaticValues();
-                    texture::sStaticValuesInitialized = true;
-                }
-
-                // Initialize state
-                State aState;
-                aState.input = reinterpret_cast<const uint32_t *>(iInputTab);
-                aState.inputSize = iInputSize / 4;
-                aState.inputPos = 0;
+            // Initialize state
+            State aState;
+            initializeState(aState, iInputTab, iInputSize);
 
-                aState.head = 0;
-                aState.bits = 0;
-                aState.buffer = 0;
+            // Skipping header
+            needBits(aState, 32);
+            dropBits(aState, 32);
 
-                aState.isEmpty = false;
+            // Format
+            needBits(aState, 32);
+            uint32_t aFormatFourCc = readBits(aState, 32);
+            dropBits(aState, 32);
 
-                // Skipping header
-                needBits(aState, 32);
-                dropBits(aState, 32);
+            texture::FullFormat aFullFormat;
 
-                // Format
-                needBits(aState, 32);
-                uint32_t aFormatFourCc = readBits(aState, 32);
-                dropBits(aState, 32);
+            aFullFormat.format = texture::deduceFormat(aFormatFourCc);
 
-                texture::FullFormat aFullFormat;
+            // Getting width/height
+            needBits(aState, 32);
+            aFullFormat.width = static_cast<uint16_t>(readBits(aState, 16));
+            dropBits(aState, 16);
+            aFullFormat.height = static_cast<uint16_t>(readBits(aState, 16));
+            dropBits(aState, 16);
 
-                aFullFormat.format = texture::deduceFormat(aFormatFourCc);
+            aFullFormat.nbObPixelBlocks = ((aFullFormat.width + 3) / 4) * ((aFullFormat.height + 3) / 4);
 
-                // Getting width/height
-                needBits(aState, 32);
-                aFullFormat.width = static_cast<uint16_t>(readBits(aState, 16));
-                dropBits(aState, 16);
-                aFullFormat.height = static_cast<uint16_t>(readBits(aState, 16));
-                dropBits(aState, 16);
+            uint32_t anOutputSize = ((aFullFormat.format.pixelSizeInBits * 4 * 4) / 8) * aFullFormat.nbObPixelBlocks;
 
-                aFullFormat.nbObPixelBlocks = ((aFullFormat.width + 3) / 4) * ((aFullFormat.height + 3) / 4);
-                aFullFormat.bytesPerPixelBlock = (aFullFormat.format.pixelSizeInBits * 4 * 4) / 8;
-                aFullFormat.hasTwoComponents =
-                    ((aFullFormat.format.flags & (texture::FF_PLAINCOMP | texture::FF_COLOR | texture::FF_ALPHA)) == (texture::FF_PLAINCOMP | texture::FF_COLOR | texture::FF_ALPHA)) || (aFullFormat.format.flags & texture::FF_BICOLORCOMP);
+            if (ioOutputSize != 0 && ioOutputSize < anOutputSize)
+            {
+                throw exception::Exception("Output buffer is too small.");
+            }
 
-                aFullFormat.bytesPerComponent = aFullFormat.bytesPerPixelBlock / (aFullFormat.hasTwoComponents ? 2 : 1);
+            ioOutputSize = anOutputSize;
 
-                uint32_t anOutputSize = aFullFormat.bytesPerPixelBlock * aFullFormat.nbObPixelBlocks;
+            uint8_t *anOutputTab(ioOutputTab);
+            texture::OwnedOutputTab anOwnedOutputTab(iAllocator);
 
-                if (ioOutputSize != 0 && ioOutputSize < anOutputSize)
+            if (ioOutputTab == nullptr)
+            {
+                anOutputTab = static_cast<uint8_t *>(iAllocator.allocate(iAllocator.context, anOutputSize));
+                if (anOutputTab == nullptr)
                 {
-                    throw exception::Exception("Output buffer is too small.");
+                    throw std::bad_alloc();
                 }
+                anOwnedOutputTab.reset(anOutputTab);
+            }
 
-                ioOutputSize = anOutputSize;
+            aFullFormat.format.inflateData(aState, aFullFormat, ioOutputSize, anOutputTab, ioScratch);
 
-                if (ioOutputTab == nullptr)
-                {
-                    anOutputTab = static_cast<uint8_t *>(malloc(sizeof(uint8_t) * anOutputSize));
-                }
-                else
-                {
-                    isOutputTabOwned = false;
-                    anOutputTab = ioOutputTab;
-                }
+            anOwnedOutputTab.dismiss();
+            return anOutputTab;
+        }
+
+        GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY inflateTextureFileBuffer(uint32_t iInputSize, const uint8_t *iInputTab, uint32_t &ioOutputSize, uint8_t *ioOutputTab)
+        {
+            texture::Scratch aScratch;
+            return inflateTextureFileBufferImpl(iInputSize, iInputTab, ioOutputSize, ioOutputTab, getDefaultAllocator(), aScratch);
+        }
 
-                texture::inflateData(aState, aFullFormat, ioOutputSize, anOutputTab);
+        GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY inflateTextureFileBuffer(uint32_t iInputSize, const uint8_t *iInputTab, uint32_t &ioOutputSize,
+                                                                               const Allocator &iAllocator)
+        {
+            texture::Scratch aScratch;
+            return inflateTextureFileBufferImpl(iInputSize, iInputTab, ioOutputSize, nullptr, iAllocator, aScratch);
+        }
 
-                return anOutputTab;
+        GW2DATTOOLS_API bool GW2DATTOOLS_APIENTRY readTextureFileHeader(uint32_t iInputSize, const uint8_t *iInputTab, uint32_t &oMagic, uint32_t &oFormatFourCc,
+                                                                        uint16_t &oWidth, uint16_t &oHeight)
+        {
+            if (iInputTab == nullptr)
+            {
+                throw exception::Exception("Input buffer is null.");
             }
-            catch (exception::Exception &iException)
+
+            if (iInputSize < 12)
             {
-                if (isOutputTabOwned)
-                {
-                    free(anOutputTab);
-                }
-                throw iException; // Rethrow exception
+                return false;
             }
-            catch (std::exception &iException)
+
+            const uint32_t *aHeader = reinterpret_cast<const uint32_t *>(iInputTab);
+
+            switch (aHeader[0])
             {
-                if (isOutputTabOwned)
-                {
-                    free(anOutputTab);
-                }
-                throw iException; // Rethrow exception
+            case 0x58455441: // ATEX
+            case 0x58545441: // ATTX
+            case 0x43455441: // ATEC
+            case 0x50455441: // ATEP
+            case 0x55455441: // ATEU
+            case 0x54455441: // ATET
+                break;
+
+            default:
+                return false;
             }
+
+            oMagic = aHeader[0];
+            oFormatFourCc = aHeader[1];
+            oWidth = static_cast<uint16_t>(aHeader[2] & 0xFFFF);
+            oHeight = static_cast<uint16_t>(aHeader[2] >> 16);
+
+            return true;
         }
 
-        GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY inflateTextureBlockBuffer(uint16_t iWidth, uint16_t iHeight, uint32_t iFormatFourCc, uint32_t iInputSize, const uint8_t *iInputTab,
-                                                                                uint32_t &ioOutputSize, uint8_t *ioOutputTab)
+        static uint8_t *inflateTextureBlockBufferImpl(uint16_t iWidth, uint16_t iHeight, uint32_t iFormatFourCc, uint32_t iInputSize, const uint8_t *iInputTab,
+                                                      uint32_t &ioOutputSize, uint8_t *ioOutputTab, const Allocator &iAllocator, texture::Scratch &ioScratch)
         {
             if (iInputTab == nullptr)
             {
@@ -743,83 +749,87 @@ namespace gw2dt
                 throw exception::Exception("Output buffer is not null and outputSize is not defined.");
             }
 
-            uint8_t *anOutputTab(nullptr);
-            bool isOutputTabOwned(true);
-
-            try
-            {
-                if (!texture::sStaticValuesInitialized)
-                {
-                    texture::initializeStaticValues();
-                    texture::sStaticValuesInitialized = true;
-                }
-
-                // Initialize format
-                texture::FullFormat aFullFormat;
+            // Initialize format
+            texture::FullFormat aFullFormat;
 
-                aFullFormat.format = texture::deduceFormat(iFormatFourCc);
-                aFullFormat.width = iWidth;
-                aFullFormat.height = iHeight;
+            aFullFormat.format = texture::deduceFormat(iFormatFourCc);
+            aFullFormat.width = iWidth;
+            aFullFormat.height = iHeight;
 
-                aFullFormat.nbObPixelBlocks = ((aFullFormat.width + 3) / 4) * ((aFullFormat.height + 3) / 4);
-                aFullFormat.bytesPerPixelBlock = (aFullFormat.format.pixelSizeInBits * 4 * 4) / 8;
-                aFullFormat.hasTwoComponents =
-                    ((aFullFormat.format.flags & (texture::FF_PLAINCOMP | texture::FF_COLOR | texture::FF_ALPHA)) == (texture::FF_PLAINCOMP | texture::FF_COLOR | texture::FF_ALPHA)) || (aFullFormat.format.flags & texture::FF_BICOLORCOMP);
+            aFullFormat.nbObPixelBlocks = ((aFullFormat.width + 3) / 4) * ((aFullFormat.height + 3) / 4);
 
-                aFullFormat.bytesPerComponent = aFullFormat.bytesPerPixelBlock / (aFullFormat.hasTwoComponents ? 2 : 1);
+            // Initialize state
+            State aState;
+            initializeState(aState, iInputTab, iInputSize);
 
-                // Initialize state
-                State aState;
-                aState.input = reinterpret_cast<const uint32_t *>(iInputTab);
-                aState.inputSize = iInputSize / 4;
-                aState.inputPos = 0;
+            // Allocate output buffer
+            uint32_t anOutputSize = ((aFullFormat.format.pixelSizeInBits * 4 * 4) / 8) * aFullFormat.nbObPixelBlocks;
 
-                aState.head = 0;
-                aState.bits = 0;
-                aState.buffer = 0;
+            if (ioOutputSize != 0 && ioOutputSize < anOutputSize)
+            {
+                throw exception::Exception("Output buffer is too small.");
+            }
 
-                aState.isEmpty = false;
+            ioOutputSize = anOutputSize;
 
-                // Allocate output buffer
-                uint32_t anOutputSize = aFullFormat.bytesPerPixelBlock * aFullFormat.nbObPixelBlocks;
+            uint8_t *anOutputTab(ioOutputTab);
+            texture::OwnedOutputTab anOwnedOutputTab(iAllocator);
 
-                if (ioOutputSize != 0 && ioOutputSize < anOutputSize)
+            if (ioOutputTab == nullptr)
+            {
+                anOutputTab = static_cast<uint8_t *>(iAllocator.allocate(iAllocator.context, anOutputSize));
+                if (anOutputTab == nullptr)
                 {
-                    throw exception::Exception("Output buffer is too small.");
+                    throw std::bad_alloc();
                 }
+                anOwnedOutputTab.reset(anOutputTab);
+            }
 
-                ioOutputSize = anOutputSize;
+            aFullFormat.format.inflateData(aState, aFullFormat, ioOutputSize, anOutputTab, ioScratch);
 
-                if (ioOutputTab == nullptr)
-                {
-                    anOutputTab = static_cast<uint8_t *>(malloc(sizeof(uint8_t) * anOutputSize));
-                }
-                else
-                {
-                    isOutputTabOwned = false;
-                    anOutputTab = ioOutputTab;
-                }
+            anOwnedOutputTab.dismiss();
+            return anOutputTab;
+        }
+
+        GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY inflateTextureBlockBuffer(uint16_t iWidth, uint16_t iHeight, uint32_t iFormatFourCc, uint32_t iInputSize, const uint8_t *iInputTab,
+                                                                                uint32_t &ioOutputSize, uint8_t *ioOutputTab)
+        {
+            texture::Scratch aScratch;
+            return inflateTextureBlockBufferImpl(iWidth, iHeight, iFormatFourCc, iInputSize, iInputTab, ioOutputSize, ioOutputTab, getDefaultAllocator(), aScratch);
+        }
 
-                texture::inflateData(aState, aFullFormat, ioOutputSize, anOutputTab);
+        GW2DATTOOLS_API uint8_t *GW2DATTOOLS_APIENTRY inflateTextureBlockBuffer(uint16_t iWidth, uint16_t iHeight, uint32_t iFormatFourCc, uint32_t iInputSize, const uint8_t *iInputTab,
+                                                                                uint32_t &ioOutputSize, const Allocator &iAllocator)
+        {
+            texture::Scratch aScratch;
+            return inflateTextureBlockBufferImpl(iWidth, iHeight, iFormatFourCc, iInputSize, iInputTab, ioOutputSize, nullptr, iAllocator, aScratch);
+        }
 
-                return anOutputTab;
-            }
-            catch (exception::Exception &iException)
-            {
-                if (isOutputTabOwned)
-                {
-                    free(anOutputTab);
-                }
-                throw iException; // Rethrow exception
-            }
-            catch (std::exception &iException)
-            {
-                if (isOutputTabOwned)
-                {
-                    free(anOutputTab);
-                }
-                throw iException; // Rethrow exception
-            }
+        struct TextureInflater::Context
+        {
+            texture::Scratch scratch;
+            Allocator allocator;
+        };
+
+        TextureInflater::TextureInflater(const Allocator &iAllocator) : _pContext(new Context)
+        {
+            _pContext->allocator = iAllocator;
+        }
+
+        TextureInflater::~TextureInflater()
+        {
+        }
+
+        uint8_t *TextureInflater::inflate(uint32_t iInputSize, const uint8_t *iInputTab, uint32_t &ioOutputSize, uint8_t *ioOutputTab)
+        {
+            return inflateTextureFileBufferImpl(iInputSize, iInputTab, ioOutputSize, ioOutputTab, _pContext->allocator, _pContext->scratch);
+        }
+
+        uint8_t *TextureInflater::inflateBlocks(uint16_t iWidth, uint16_t iHeight, uint32_t iFormatFourCc, uint32_t iInputSize, const uint8_t *iInputTab,
+                                                uint32_t &ioOutputSize, uint8_t *ioOutputTab)
+        {
+            return inflateTextureBlockBufferImpl(iWidth, iHeight, iFormatFourCc, iInputSize, iInputTab, ioOutputSize, ioOutputTab, _pContext->allocator,
+                                                 _pContext->scratch);
         }
 
     }
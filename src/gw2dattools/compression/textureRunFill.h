@@ -0,0 +1,223 @@
+#ifndef GW2DATTOOLS_COMPRESSION_TEXTURERUNFILL_H
+#define GW2DATTOOLS_COMPRESSION_TEXTURERUNFILL_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GW2DATTOOLS_RUNFILL_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace gw2dt
+{
+    namespace compression
+    {
+        namespace texture
+        {
+
+            inline uint32_t countTrailingZeros(uint64_t iValue)
+            {
+#if defined(_MSC_VER) && defined(_M_X64)
+                unsigned long aIndex;
+                _BitScanForward64(&aIndex, iValue);
+                return static_cast<uint32_t>(aIndex);
+#elif defined(_MSC_VER)
+                unsigned long aIndex;
+                if (_BitScanForward(&aIndex, static_cast<uint32_t>(iValue)))
+                {
+                    return static_cast<uint32_t>(aIndex);
+                }
+                _BitScanForward(&aIndex, static_cast<uint32_t>(iValue >> 32));
+                return static_cast<uint32_t>(aIndex) + 32;
+#else
+                return static_cast<uint32_t>(__builtin_ctzll(iValue));
+#endif
+            }
+
+            /**
+             * One bit per pixel block, stored in 64-bit words so that runs of blocks
+             * can be searched and marked a word at a time.
+             */
+            class BlockBitmap
+            {
+            public:
+                explicit BlockBitmap(uint32_t iSize = 0) : _wordVect((iSize + 63) / 64, 0), _size(iSize)
+                {
+                }
+
+                // Resizes the bitmap and unsets every bit, keeping the storage already allocated
+                void reset(uint32_t iSize)
+                {
+                    _wordVect.assign((iSize + 63) / 64, 0);
+                    _size = iSize;
+                }
+
+                uint32_t getSize() const
+                {
+                    return _size;
+                }
+
+                bool test(uint32_t iPos) const
+                {
+                    return (_wordVect[iPos >> 6] >> (iPos & 63)) & 1;
+                }
+
+                // Returns the position of the first set bit in [iPos, iEnd), or iEnd if there is none
+                uint32_t findNextSet(uint32_t iPos, uint32_t iEnd) const
+                {
+                    return findNext(iPos, iEnd, 0);
+                }
+
+                // Returns the position of the first unset bit in [iPos, iEnd), or iEnd if there is none
+                uint32_t findNextUnset(uint32_t iPos, uint32_t iEnd) const
+                {
+                    return findNext(iPos, iEnd, ~uint64_t(0));
+                }
+
+                // Sets every bit in [iBegin, iEnd)
+                void setRange(uint32_t iBegin, uint32_t iEnd)
+                {
+                    if (iBegin >= iEnd)
+                    {
+                        return;
+                    }
+
+                    uint32_t aFirstWord = iBegin >> 6;
+                    uint32_t aLastWord = (iEnd - 1) >> 6;
+                    uint64_t aFirstMask = ~uint64_t(0) << (iBegin & 63);
+                    uint64_t aLastMask = ~uint64_t(0) >> (63 - ((iEnd - 1) & 63));
+
+                    if (aFirstWord == aLastWord)
+                    {
+                        _wordVect[aFirstWord] |= aFirstMask & aLastMask;
+                        return;
+                    }
+
+                    _wordVect[aFirstWord] |= aFirstMask;
+                    for (uint32_t aWordIndex = aFirstWord + 1; aWordIndex < aLastWord; ++aWordIndex)
+                    {
+                        _wordVect[aWordIndex] = ~uint64_t(0);
+                    }
+                    _wordVect[aLastWord] |= aLastMask;
+                }
+
+            private:
+                // Looks for the first bit that differs from iSkippedPattern
+                uint32_t findNext(uint32_t iPos, uint32_t iEnd, uint64_t iSkippedPattern) const
+                {
+                    if (iPos >= iEnd)
+                    {
+                        return iEnd;
+                    }
+
+                    uint32_t aWordIndex = iPos >> 6;
+                    uint64_t aWord = (_wordVect[aWordIndex] ^ iSkippedPattern) & (~uint64_t(0) << (iPos & 63));
+                    uint32_t aLastWord = (iEnd - 1) >> 6;
+
+                    while (aWord == 0)
+                    {
+                        if (++aWordIndex > aLastWord)
+                        {
+                            return iEnd;
+                        }
+                        aWord = _wordVect[aWordIndex] ^ iSkippedPattern;
+                    }
+
+                    uint32_t aFoundPos = (aWordIndex << 6) + countTrailingZeros(aWord);
+                    return aFoundPos < iEnd ? aFoundPos : iEnd;
+                }
+
+                std::vector<uint64_t> _wordVect;
+                uint32_t _size;
+            };
+
+            /**
+             * Writes a 64-bit pattern at the start of each pixel block of a span.
+             * @tparam sBytesPerPixelBlock Distance between two consecutive blocks.
+             * @tparam sBytesPerValue Number of bytes of the pattern to write, at most 8.
+             * @param ioOutputTab Address of the value in the first block of the span.
+             * @param iNbBlocks Number of blocks in the span.
+             * @param iValue Pattern to write, in native byte order.
+             */
+            template <uint32_t sBytesPerPixelBlock, uint32_t sBytesPerValue>
+            inline void fillBlocks(uint8_t *ioOutputTab, uint32_t iNbBlocks, uint64_t iValue)
+            {
+                uint32_t aBlockIndex = 0;
+
+                // Blocks are back to back: the span is one contiguous repetition of the pattern
+                if (sBytesPerPixelBlock == sizeof(uint64_t) && sBytesPerValue == sizeof(uint64_t))
+                {
+#ifdef GW2DATTOOLS_RUNFILL_SSE2
+                    __m128i aPattern = _mm_set1_epi64x(static_cast<long long>(iValue));
+                    for (; aBlockIndex + 8 <= iNbBlocks; aBlockIndex += 8)
+                    {
+                        __m128i *aDestination = reinterpret_cast<__m128i *>(ioOutputTab + aBlockIndex * sizeof(uint64_t));
+                        _mm_storeu_si128(aDestination, aPattern);
+                        _mm_storeu_si128(aDestination + 1, aPattern);
+                        _mm_storeu_si128(aDestination + 2, aPattern);
+                        _mm_storeu_si128(aDestination + 3, aPattern);
+                    }
+                    for (; aBlockIndex + 2 <= iNbBlocks; aBlockIndex += 2)
+                    {
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(ioOutputTab + aBlockIndex * sizeof(uint64_t)), aPattern);
+                    }
+#endif
+                }
+
+                for (; aBlockIndex < iNbBlocks; ++aBlockIndex)
+                {
+                    memcpy(ioOutputTab + aBlockIndex * sBytesPerPixelBlock, &iValue, sBytesPerValue);
+                }
+            }
+
+            /**
+             * Consumes a run of iCount blocks not yet marked in ioBitmap, starting at iPos.
+             * Blocks already marked are skipped without being counted. When iFill is set, the
+             * consumed blocks get iValue and are marked in ioBitmap and, if given, in ioOtherBitmap.
+             * @return Position following the last consumed block.
+             */
+            template <uint32_t sBytesPerPixelBlock, uint32_t sBytesPerValue>
+            inline uint32_t applyRun(BlockBitmap &ioBitmap, BlockBitmap *ioOtherBitmap, uint32_t iPos, uint32_t iCount, bool iFill,
+                                     uint64_t iValue, uint8_t *ioOutputTab)
+            {
+                const uint32_t aNbBlocks = ioBitmap.getSize();
+
+                while (iCount > 0)
+                {
+                    iPos = ioBitmap.findNextUnset(iPos, aNbBlocks);
+                    if (iPos == aNbBlocks)
+                    {
+                        break;
+                    }
+
+                    uint32_t aSpanLimit = (aNbBlocks - iPos) < iCount ? aNbBlocks : iPos + iCount;
+                    uint32_t aSpanEnd = ioBitmap.findNextSet(iPos, aSpanLimit);
+
+                    if (iFill)
+                    {
+                        fillBlocks<sBytesPerPixelBlock, sBytesPerValue>(ioOutputTab + sBytesPerPixelBlock * iPos, aSpanEnd - iPos, iValue);
+                        ioBitmap.setRange(iPos, aSpanEnd);
+                        if (ioOtherBitmap != nullptr)
+                        {
+                            ioOtherBitmap->setRange(iPos, aSpanEnd);
+                        }
+                    }
+
+                    iCount -= aSpanEnd - iPos;
+                    iPos = aSpanEnd;
+                }
+
+                return iPos;
+            }
+
+        }
+    }
+}
+
+#endif // GW2DATTOOLS_COMPRESSION_TEXTURERUNFILL_H
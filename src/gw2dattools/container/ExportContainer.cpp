@@ -0,0 +1,251 @@
+#include "gw2dattools/container/ExportContainer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "gw2dattools/exception/Exception.h"
+
+#include "../format/Utils.h"
+
+namespace gw2dt
+{
+    namespace container
+    {
+
+#pragma pack(push, 1)
+        struct ContainerFileHeader
+        {
+            uint8_t magic[4];
+            uint32_t version;
+            uint32_t reserved[2];
+        };
+
+        struct ContainerEntryHeader
+        {
+            uint32_t fileId;
+            uint32_t size;
+            uint32_t flags;
+            uint32_t reserved;
+        };
+
+        struct ContainerTrailer
+        {
+            uint64_t indexOffset;
+            uint32_t nbOfEntries;
+            uint32_t version;
+            uint8_t magic[4];
+            uint32_t reserved;
+        };
+#pragma pack(pop)
+
+        static const uint8_t sContainerMagic[4] = {'G', 'W', 'C', 'T'};
+        static const uint8_t sContainerIndexMagic[4] = {'G', 'W', 'C', 'I'};
+        static const uint32_t sContainerVersion = 1;
+        static const uint8_t sPadding[ContainerAlignment] = {};
+
+        ContainerWriter::ContainerWriter(const char *iPath, uint32_t iBufferSize) : _bufferUsedSize(0),
+                                                                                    _size(0),
+                                                                                    _isFinished(false)
+        {
+            _bufferSize = std::max(4096u, (iBufferSize + 4095) & ~4095u);
+            _pBuffer.reset(new uint8_t[_bufferSize]);
+
+            // The buffer of the stream would only add a copy
+            _stream.rdbuf()->pubsetbuf(nullptr, 0);
+            _stream.open(iPath, std::ios::binary | std::ios::trunc);
+            if (!_stream)
+            {
+                throw exception::Exception("Unable to open the container file for writing.");
+            }
+
+            ContainerFileHeader aHeader = {};
+            std::copy(sContainerMagic, sContainerMagic + 4, aHeader.magic);
+            aHeader.version = sContainerVersion;
+            append(sizeof(aHeader), reinterpret_cast<const uint8_t *>(&aHeader));
+        }
+
+        void ContainerWriter::add(uint32_t iFileId, uint32_t iFlags, uint32_t iSize, const uint8_t *iData)
+        {
+            if (iData == nullptr && iSize != 0)
+            {
+                throw exception::Exception("Input buffer is null.");
+            }
+
+            std::lock_guard<std::mutex> aLock(_mutex);
+            if (_isFinished)
+            {
+                throw exception::Exception("The container is finished.");
+            }
+
+            ContainerEntryHeader aHeader = {iFileId, iSize, iFlags, 0};
+            append(sizeof(aHeader), reinterpret_cast<const uint8_t *>(&aHeader));
+
+            ContainerEntry aEntry = {_size, iFileId, iSize, iFlags, 0};
+            append(iSize, iData);
+            append((ContainerAlignment - iSize % ContainerAlignment) % ContainerAlignment, sPadding);
+
+            _entryVect.push_back(aEntry);
+        }
+
+        void ContainerWriter::finish()
+        {
+            std::lock_guard<std::mutex> aLock(_mutex);
+            if (_isFinished)
+            {
+                return;
+            }
+
+            std::sort(_entryVect.begin(), _entryVect.end(), [](const ContainerEntry &iLeft, const ContainerEntry &iRight)
+            {
+                return iLeft.fileId < iRight.fileId;
+            });
+
+            ContainerTrailer aTrailer = {};
+            aTrailer.indexOffset = _size;
+            aTrailer.nbOfEntries = static_cast<uint32_t>(_entryVect.size());
+            aTrailer.version = sContainerVersion;
+            std::copy(sContainerIndexMagic, sContainerIndexMagic + 4, aTrailer.magic);
+
+            append(static_cast<uint32_t>(sizeof(ContainerEntry) * _entryVect.size()), reinterpret_cast<const uint8_t *>(_entryVect.data()));
+            append(sizeof(aTrailer), reinterpret_cast<const uint8_t *>(&aTrailer));
+            flush();
+
+            _stream.close();
+            if (!_stream)
+            {
+                throw exception::Exception("Unable to write the container file.");
+            }
+            _isFinished = true;
+        }
+
+        uint64_t ContainerWriter::getSize() const
+        {
+            std::lock_guard<std::mutex> aLock(_mutex);
+            return _size;
+        }
+
+        void ContainerWriter::append(uint32_t iSize, const uint8_t *iData)
+        {
+            while (iSize != 0)
+            {
+                uint32_t aCopySize = std::min(iSize, _bufferSize - _bufferUsedSize);
+                memcpy(_pBuffer.get() + _bufferUsedSize, iData, aCopySize);
+
+                _bufferUsedSize += aCopySize;
+                _size += aCopySize;
+                iData += aCopySize;
+                iSize -= aCopySize;
+
+                if (_bufferUsedSize == _bufferSize)
+                {
+                    flush();
+                }
+            }
+        }
+
+        void ContainerWriter::flush()
+        {
+            _stream.write(reinterpret_cast<const char *>(_pBuffer.get()), _bufferUsedSize);
+            _bufferUsedSize = 0;
+            if (!_stream)
+            {
+                throw exception::Exception("Unable to write the container file.");
+            }
+        }
+
+        ContainerReader::ContainerReader(const char *iPath)
+        {
+            _stream.open(iPath, std::ios::binary);
+            if (!_stream)
+            {
+                throw exception::Exception("Unable to open the container file.");
+            }
+
+            ContainerFileHeader aHeader;
+            format::readStructs(_stream, aHeader);
+            if (!_stream || !std::equal(sContainerMagic, sContainerMagic + 4, aHeader.magic))
+            {
+                throw exception::Exception("Not a container file.");
+            }
+            if (aHeader.version != sContainerVersion)
+            {
+                throw exception::Exception("Unsupported container version.");
+            }
+
+            ContainerTrailer aTrailer;
+            _stream.seekg(-static_cast<std::streamoff>(sizeof(aTrailer)), std::ios::end);
+            uint64_t aTrailerOffset = static_cast<uint64_t>(_stream.tellg());
+            format::readStructs(_stream, aTrailer);
+            if (!_stream || !std::equal(sContainerIndexMagic, sContainerIndexMagic + 4, aTrailer.magic))
+            {
+                throw exception::Exception("The container has no index, it was not finished.");
+            }
+            if (aTrailer.indexOffset + uint64_t(aTrailer.nbOfEntries) * sizeof(ContainerEntry) != aTrailerOffset)
+            {
+                throw exception::Exception("Malformed container index.");
+            }
+
+            _entryVect.resize(aTrailer.nbOfEntries);
+            _stream.seekg(aTrailer.indexOffset);
+            format::readStructVect(_stream, _entryVect);
+            if (!_stream)
+            {
+                throw exception::Exception("Truncated container index.");
+            }
+
+            for (uint32_t aIndex = 0; aIndex < _entryVect.size(); ++aIndex)
+            {
+                const ContainerEntry &aEntry = _entryVect[aIndex];
+                if (aEntry.offset < sizeof(aHeader) + sizeof(ContainerEntryHeader) || aEntry.offset > aTrailer.indexOffset ||
+                    aEntry.size > aTrailer.indexOffset - aEntry.offset)
+                {
+                    throw exception::Exception("Container entry exceeds the data.");
+                }
+                // findEntry searches the index by dichotomy
+                if (aIndex != 0 && _entryVect[aIndex - 1].fileId > aEntry.fileId)
+                {
+                    throw exception::Exception("Container index is not sorted.");
+                }
+            }
+        }
+
+        const std::vector<ContainerEntry> &ContainerReader::getEntryVect() const
+        {
+            return _entryVect;
+        }
+
+        const ContainerEntry *ContainerReader::findEntry(uint32_t iFileId) const
+        {
+            auto itEntry = std::lower_bound(_entryVect.begin(), _entryVect.end(), iFileId, [](const ContainerEntry &iEntry, uint32_t iValue)
+            {
+                return iEntry.fileId < iValue;
+            });
+
+            if (itEntry == _entryVect.end() || itEntry->fileId != iFileId)
+            {
+                return nullptr;
+            }
+            return &(*itEntry);
+        }
+
+        void ContainerReader::getBuffer(const ContainerEntry &iEntry, uint32_t &ioOutputSize, uint8_t *ioBuffer)
+        {
+            if (ioBuffer == nullptr && ioOutputSize != 0)
+            {
+                throw exception::Exception("Output buffer is null.");
+            }
+
+            ioOutputSize = std::min(ioOutputSize, iEntry.size);
+
+            std::lock_guard<std::mutex> aLock(_mutex);
+            _stream.seekg(iEntry.offset);
+            _stream.read(reinterpret_cast<char *>(ioBuffer), ioOutputSize);
+            if (!_stream)
+            {
+                _stream.clear();
+                throw exception::Exception("Unable to read the container file.");
+            }
+        }
+
+    } // namespace container
+} // namespace gw2dt
@@ -0,0 +1,143 @@
+#include "gw2dattools/format/PackFileView.h"
+
+#include <cstring>
+
+#include "gw2dattools/exception/Exception.h"
+
+namespace gw2dt
+{
+    namespace format
+    {
+
+#pragma pack(push, 1)
+        struct PackFileHeader
+        {
+            uint8_t magic[2];
+            uint16_t version;
+            uint16_t zero;
+            uint16_t headerSize;
+            uint32_t type;
+        };
+
+        struct PackFileChunkHeader
+        {
+            uint32_t magic;
+            uint32_t chunkSize;
+            uint16_t version;
+            uint16_t headerSize;
+            uint32_t offsetToOffsetTable;
+        };
+#pragma pack(pop)
+
+        PackFileView::PackFileView(uint32_t iSize, const uint8_t *iBuffer) : _version(0), _type(0)
+        {
+            if (iBuffer == nullptr)
+            {
+                throw exception::Exception("Input buffer is null.");
+            }
+
+            if (!isPackFile(iSize, iBuffer))
+            {
+                throw exception::Exception("Buffer is not a PackFile.");
+            }
+
+            PackFileHeader aHeader;
+            memcpy(&aHeader, iBuffer, sizeof(aHeader));
+
+            _version = aHeader.version;
+            _type = aHeader.type;
+
+            uint32_t aPos = aHeader.headerSize < sizeof(PackFileHeader) ? sizeof(PackFileHeader) : aHeader.headerSize;
+
+            while (aPos <= iSize && iSize - aPos >= sizeof(PackFileChunkHeader))
+            {
+                PackFileChunkHeader aChunkHeader;
+                memcpy(&aChunkHeader, iBuffer + aPos, sizeof(aChunkHeader));
+
+                // chunkSize does not count the magic and the chunkSize fields themselves
+                uint64_t aChunkTotalSize = static_cast<uint64_t>(aChunkHeader.chunkSize) + 8;
+                if (aChunkHeader.chunkSize < sizeof(PackFileChunkHeader) - 8 || aChunkTotalSize > iSize - aPos)
+                {
+                    throw exception::Exception("PackFile chunk exceeds the buffer.");
+                }
+
+                Chunk aChunk;
+                aChunk.magic = aChunkHeader.magic;
+                aChunk.version = aChunkHeader.version;
+                aChunk.headerSize = aChunkHeader.headerSize;
+                aChunk.begin = iBuffer + aPos;
+                aChunk.size = static_cast<uint32_t>(aChunkTotalSize);
+                aChunk.data = aChunk.begin + sizeof(PackFileChunkHeader);
+                aChunk.dataSize = aChunk.size - sizeof(PackFileChunkHeader);
+                aChunk.offsetTab = nullptr;
+                aChunk.nbOfOffsets = 0;
+
+                if (aChunkHeader.offsetToOffsetTable != 0)
+                {
+                    uint32_t aMaxOffset = aChunk.dataSize;
+                    if (aChunkHeader.offsetToOffsetTable > aMaxOffset || aMaxOffset - aChunkHeader.offsetToOffsetTable < sizeof(uint32_t))
+                    {
+                        throw exception::Exception("PackFile offset table exceeds its chunk.");
+                    }
+
+                    uint32_t aNbOfOffsets;
+                    memcpy(&aNbOfOffsets, aChunk.data + aChunkHeader.offsetToOffsetTable, sizeof(aNbOfOffsets));
+
+                    uint32_t aAvailableOffsets = (aMaxOffset - aChunkHeader.offsetToOffsetTable - sizeof(uint32_t)) / sizeof(uint32_t);
+                    if (aNbOfOffsets > aAvailableOffsets)
+                    {
+                        throw exception::Exception("PackFile offset table exceeds its chunk.");
+                    }
+
+                    aChunk.dataSize = aChunkHeader.offsetToOffsetTable;
+                    aChunk.offsetTab = aChunk.data + aChunkHeader.offsetToOffsetTable + sizeof(uint32_t);
+                    aChunk.nbOfOffsets = aNbOfOffsets;
+                }
+
+                // Keeps the first chunk when a magic appears several times
+                _chunkIndexMap.insert(std::make_pair(aChunk.magic, static_cast<uint32_t>(_chunkVect.size())));
+                _chunkVect.push_back(aChunk);
+
+                aPos += aChunk.size;
+            }
+        }
+
+        uint32_t PackFileView::Chunk::getOffset(uint32_t iIndex) const
+        {
+            uint32_t aOffset;
+            memcpy(&aOffset, offsetTab + iIndex * sizeof(uint32_t), sizeof(aOffset));
+            return aOffset;
+        }
+
+        bool PackFileView::isPackFile(uint32_t iSize, const uint8_t *iBuffer)
+        {
+            return iBuffer != nullptr && iSize >= sizeof(PackFileHeader) && iBuffer[0] == 'P' && iBuffer[1] == 'F';
+        }
+
+        uint16_t PackFileView::getVersion() const
+        {
+            return _version;
+        }
+
+        uint32_t PackFileView::getType() const
+        {
+            return _type;
+        }
+
+        const std::vector<PackFileView::Chunk> &PackFileView::getChunkVect() const
+        {
+            return _chunkVect;
+        }
+
+        const PackFileView::Chunk *PackFileView::findChunk(uint32_t iMagic) const
+        {
+            auto itChunkIndex = _chunkIndexMap.find(iMagic);
+            if (itChunkIndex == _chunkIndexMap.end())
+            {
+                return nullptr;
+            }
+            return &_chunkVect[itChunkIndex->second];
+        }
+
+    } // namespace format
+} // namespace gw2dt
@@ -0,0 +1,311 @@
+#include "gw2dattools/index/AssetManifest.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "gw2dattools/anstructs/MFST_PackAssetManifest.h"
+#include "gw2dattools/exception/Exception.h"
+
+#include "SidecarFile.h"
+
+namespace gw2dt
+{
+    namespace index
+    {
+
+#pragma pack(push, 1)
+        struct AssetManifestFileHeader
+        {
+            uint8_t magic[4];
+            uint32_t version;
+            uint32_t buildId;
+            uint32_t nbOfRecords;
+            uint32_t nbOfStreams;
+        };
+#pragma pack(pop)
+
+        static const uint8_t sAssetManifestMagic[4] = {'G', 'A', 'M', 'F'};
+        static const uint32_t sAssetManifestVersion = 1;
+
+        namespace
+        {
+
+            template <typename Type>
+            void checkArray(const anstructs::Bounds &iBounds, const anstructs::ArrayView<Type> &iArray)
+            {
+                if (!iBounds.contains(iArray.getData(), anstructs::ArrayView<Type>::structSize) ||
+                    (iArray.size() != 0 && !iBounds.contains(iArray.getElements(), uint64_t(iArray.size()) * anstructs::ElementTraits<Type>::size)))
+                {
+                    throw exception::Exception("MFST chunk array exceeds the chunk.");
+                }
+            }
+
+            // The overloads taking a long are picked for the versions without the field
+            template <typename RecordView>
+            auto readFlags(const RecordView &iRecord, int) -> decltype(iRecord.flags())
+            {
+                return iRecord.flags();
+            }
+
+            template <typename RecordView>
+            uint32_t readFlags(const RecordView &, long)
+            {
+                return 0;
+            }
+
+            template <typename Root>
+            auto readStreams(const anstructs::Bounds &iBounds, const Root &iRoot, std::vector<AssetManifest::Stream> &oStreamVect, int)
+                -> decltype(iRoot.streams(), void())
+            {
+                auto aStreamArray = iRoot.streams();
+                checkArray(iBounds, aStreamArray);
+
+                oStreamVect.resize(aStreamArray.size());
+                for (uint32_t aStreamIndex = 0; aStreamIndex < aStreamArray.size(); ++aStreamIndex)
+                {
+                    auto aStream = aStreamArray[aStreamIndex];
+                    oStreamVect[aStreamIndex].parentBaseId = aStream.parentBaseId();
+                    oStreamVect[aStreamIndex].streamBaseId = aStream.streamBaseId();
+                }
+            }
+
+            template <typename Root>
+            void readStreams(const anstructs::Bounds &, const Root &, std::vector<AssetManifest::Stream> &, long)
+            {
+            }
+
+            struct ManifestVisitor
+            {
+                const anstructs::Bounds &bounds;
+                uint32_t &buildId;
+                std::vector<AssetManifest::Record> &recordVect;
+                std::vector<AssetManifest::Stream> &streamVect;
+
+                template <typename Root>
+                void operator()(const Root &iRoot) const
+                {
+                    if (!bounds.contains(iRoot.getData(), Root::structSize))
+                    {
+                        throw exception::Exception("MFST chunk exceeds its data.");
+                    }
+
+                    buildId = iRoot.buildId();
+
+                    auto aRecordArray = iRoot.records();
+                    checkArray(bounds, aRecordArray);
+
+                    recordVect.resize(aRecordArray.size());
+                    for (uint32_t aRecordIndex = 0; aRecordIndex < aRecordArray.size(); ++aRecordIndex)
+                    {
+                        auto aRecordView = aRecordArray[aRecordIndex];
+                        AssetManifest::Record &aRecord = recordVect[aRecordIndex];
+                        aRecord.baseId = aRecordView.baseId();
+                        aRecord.fileId = aRecordView.fileId();
+                        aRecord.size = aRecordView.size();
+                        aRecord.flags = readFlags(aRecordView, 0);
+                        aRecord.crc = 0;
+                    }
+
+                    readStreams(bounds, iRoot, streamVect, 0);
+                }
+            };
+
+            // A null flags or crc field is unknown, MFST chunks have no crc and archives no flags
+            bool isFieldDifferent(uint32_t iLeft, uint32_t iRight)
+            {
+                return iLeft != 0 && iRight != 0 && iLeft != iRight;
+            }
+
+            bool isRecordDifferent(const AssetManifest::Record &iLeft, const AssetManifest::Record &iRight)
+            {
+                return iLeft.fileId != iRight.fileId || iLeft.size != iRight.size || isFieldDifferent(iLeft.flags, iRight.flags) ||
+                       isFieldDifferent(iLeft.crc, iRight.crc);
+            }
+
+        } // namespace
+
+        AssetManifest::AssetManifest(uint32_t iBuildId, std::vector<Record> iRecordVect, std::vector<Stream> iStreamVect)
+            : _buildId(iBuildId), _recordVect(std::move(iRecordVect)), _streamVect(std::move(iStreamVect))
+        {
+            // Latest version of an asset last, so that it is the one kept
+            std::sort(_recordVect.begin(), _recordVect.end(), [](const Record &iLeft, const Record &iRight)
+            {
+                return iLeft.baseId != iRight.baseId ? iLeft.baseId < iRight.baseId : iLeft.fileId < iRight.fileId;
+            });
+
+            auto itLast = std::unique(_recordVect.rbegin(), _recordVect.rend(), [](const Record &iLeft, const Record &iRight)
+            {
+                return iLeft.baseId == iRight.baseId;
+            });
+            _recordVect.erase(_recordVect.begin(), itLast.base());
+
+            std::sort(_streamVect.begin(), _streamVect.end(), [](const Stream &iLeft, const Stream &iRight)
+            {
+                return iLeft.parentBaseId != iRight.parentBaseId ? iLeft.parentBaseId < iRight.parentBaseId
+                                                                 : iLeft.streamBaseId < iRight.streamBaseId;
+            });
+        }
+
+        uint32_t AssetManifest::getBuildId() const
+        {
+            return _buildId;
+        }
+
+        const std::vector<AssetManifest::Record> &AssetManifest::getRecordVect() const
+        {
+            return _recordVect;
+        }
+
+        const std::vector<AssetManifest::Stream> &AssetManifest::getStreamVect() const
+        {
+            return _streamVect;
+        }
+
+        const AssetManifest::Record *AssetManifest::findRecord(uint32_t iBaseId) const
+        {
+            auto itRecord = std::lower_bound(_recordVect.begin(), _recordVect.end(), iBaseId, [](const Record &iRecord, uint32_t iValue)
+            {
+                return iRecord.baseId < iValue;
+            });
+
+            if (itRecord == _recordVect.end() || itRecord->baseId != iBaseId)
+            {
+                return nullptr;
+            }
+            return &(*itRecord);
+        }
+
+        void AssetManifest::save(const char *iPath) const
+        {
+            SidecarWriter aWriter(iPath, "asset manifest");
+
+            AssetManifestFileHeader aHeader;
+            aHeader.buildId = _buildId;
+            aHeader.nbOfRecords = static_cast<uint32_t>(_recordVect.size());
+            aHeader.nbOfStreams = static_cast<uint32_t>(_streamVect.size());
+
+            aWriter.writeHeader(aHeader, sAssetManifestMagic, sAssetManifestVersion);
+            aWriter.writeVect(_recordVect);
+            aWriter.writeVect(_streamVect);
+            aWriter.close();
+        }
+
+        GW2DATTOOLS_API std::unique_ptr<AssetManifest> GW2DATTOOLS_APIENTRY parseAssetManifest(const format::PackFileView &iPackFile)
+        {
+            const format::PackFileView::Chunk *pChunk = iPackFile.findChunk(anstructs::MFST_PackAssetManifest::Magic);
+            if (pChunk == nullptr)
+            {
+                throw exception::Exception("PackFile has no MFST chunk.");
+            }
+
+            uint32_t aBuildId = 0;
+            std::vector<AssetManifest::Record> aRecordVect;
+            std::vector<AssetManifest::Stream> aStreamVect;
+
+            anstructs::Bounds aBounds(pChunk->data, pChunk->dataSize);
+            if (!anstructs::MFST_PackAssetManifest::dispatch(*pChunk, ManifestVisitor{aBounds, aBuildId, aRecordVect, aStreamVect}))
+            {
+                throw exception::Exception("Unsupported MFST chunk version.");
+            }
+
+            return std::unique_ptr<AssetManifest>(new AssetManifest(aBuildId, std::move(aRecordVect), std::move(aStreamVect)));
+        }
+
+        GW2DATTOOLS_API std::unique_ptr<AssetManifest> GW2DATTOOLS_APIENTRY buildArchiveManifest(const datfile::ANDatInterface &iANDatInterface)
+        {
+            const std::vector<datfile::ANDatInterface::FileRecord> &aFileRecordVect = iANDatInterface.getFileRecordVect();
+
+            std::vector<AssetManifest::Record> aRecordVect(aFileRecordVect.size());
+            for (size_t aIndex = 0; aIndex < aFileRecordVect.size(); ++aIndex)
+            {
+                const datfile::ANDatInterface::FileRecord &aFileRecord = aFileRecordVect[aIndex];
+                AssetManifest::Record &aRecord = aRecordVect[aIndex];
+
+                // Files with a single id have a null baseId
+                aRecord.baseId = aFileRecord.baseId != 0 ? aFileRecord.baseId : aFileRecord.fileId;
+                aRecord.fileId = aFileRecord.fileId;
+                aRecord.size = aFileRecord.size;
+                aRecord.flags = 0;
+                aRecord.crc = aFileRecord.crc;
+            }
+
+            return std::unique_ptr<AssetManifest>(new AssetManifest(0, std::move(aRecordVect), std::vector<AssetManifest::Stream>()));
+        }
+
+        GW2DATTOOLS_API std::unique_ptr<AssetManifest> GW2DATTOOLS_APIENTRY loadAssetManifest(const char *iPath)
+        {
+            SidecarReader aReader(iPath, "asset manifest");
+
+            AssetManifestFileHeader aHeader;
+            aReader.readHeader(aHeader, sAssetManifestMagic, sAssetManifestVersion);
+
+            std::vector<AssetManifest::Record> aRecordVect;
+            std::vector<AssetManifest::Stream> aStreamVect;
+            aReader.readVect(aHeader.nbOfRecords, aRecordVect);
+            aReader.readVect(aHeader.nbOfStreams, aStreamVect);
+
+            return std::unique_ptr<AssetManifest>(new AssetManifest(aHeader.buildId, std::move(aRecordVect), std::move(aStreamVect)));
+        }
+
+        GW2DATTOOLS_API ManifestDiff GW2DATTOOLS_APIENTRY diffManifests(const AssetManifest &iOldManifest, const AssetManifest &iNewManifest)
+        {
+            const std::vector<AssetManifest::Record> &aOldRecordVect = iOldManifest.getRecordVect();
+            const std::vector<AssetManifest::Record> &aNewRecordVect = iNewManifest.getRecordVect();
+
+            ManifestDiff aDiff;
+            aDiff.nbOfAdded = 0;
+            aDiff.nbOfRemoved = 0;
+            aDiff.nbOfModified = 0;
+            aDiff.downloadSize = 0;
+
+            uint32_t aOldIndex = 0;
+            uint32_t aNewIndex = 0;
+
+            while (aOldIndex < aOldRecordVect.size() || aNewIndex < aNewRecordVect.size())
+            {
+                ManifestDiff::Change aChange;
+
+                if (aNewIndex == aNewRecordVect.size() ||
+                    (aOldIndex < aOldRecordVect.size() && aOldRecordVect[aOldIndex].baseId < aNewRecordVect[aNewIndex].baseId))
+                {
+                    aChange.baseId = aOldRecordVect[aOldIndex].baseId;
+                    aChange.kind = ManifestDiff::CK_REMOVED;
+                    aChange.oldRecordIndex = aOldIndex++;
+                    aChange.newRecordIndex = ManifestDiff::NoRecord;
+                    ++aDiff.nbOfRemoved;
+                }
+                else if (aOldIndex == aOldRecordVect.size() || aNewRecordVect[aNewIndex].baseId < aOldRecordVect[aOldIndex].baseId)
+                {
+                    aChange.baseId = aNewRecordVect[aNewIndex].baseId;
+                    aChange.kind = ManifestDiff::CK_ADDED;
+                    aChange.oldRecordIndex = ManifestDiff::NoRecord;
+                    aChange.newRecordIndex = aNewIndex++;
+                    ++aDiff.nbOfAdded;
+                    aDiff.downloadSize += aNewRecordVect[aChange.newRecordIndex].size;
+                }
+                else
+                {
+                    bool aIsModified = isRecordDifferent(aOldRecordVect[aOldIndex], aNewRecordVect[aNewIndex]);
+                    ++aOldIndex;
+                    ++aNewIndex;
+                    if (!aIsModified)
+                    {
+                        continue;
+                    }
+
+                    aChange.baseId = aNewRecordVect[aNewIndex - 1].baseId;
+                    aChange.kind = ManifestDiff::CK_MODIFIED;
+                    aChange.oldRecordIndex = aOldIndex - 1;
+                    aChange.newRecordIndex = aNewIndex - 1;
+                    ++aDiff.nbOfModified;
+                    aDiff.downloadSize += aNewRecordVect[aChange.newRecordIndex].size;
+                }
+
+                aDiff.changeVect.push_back(aChange);
+            }
+
+            return aDiff;
+        }
+
+    } // namespace index
+} // namespace gw2dt
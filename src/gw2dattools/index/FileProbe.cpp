@@ -0,0 +1,102 @@
+#include "FileProbe.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "gw2dattools/compression/inflateDatFileBuffer.h"
+#include "gw2dattools/exception/Exception.h"
+
+namespace gw2dt
+{
+    namespace index
+    {
+        // Compressed bytes read on the first attempt, enough to hold the Huffman trees and the first symbols
+        static const uint32_t sCompressedPrefixSize = 4096;
+
+        uint32_t readFileHead(datfile::ANDatInterface &iANDatInterface,
+                              const datfile::ANDatInterface::FileRecord &iFileRecord,
+                              uint32_t iHeadSize,
+                              uint8_t *oHead,
+                              std::vector<uint8_t> &ioScratchBuffer)
+        {
+            if (!iFileRecord.isCompressed)
+            {
+                uint32_t aHeadSize = std::min(iHeadSize, iFileRecord.size);
+                iANDatInterface.getBuffer(iFileRecord, aHeadSize, oHead);
+                return aHeadSize;
+            }
+
+            uint32_t aRequestedSize = std::min(iFileRecord.size, sCompressedPrefixSize);
+
+            while (true)
+            {
+                ioScratchBuffer.resize(aRequestedSize);
+                uint32_t aInputSize = aRequestedSize;
+                iANDatInterface.getBuffer(iFileRecord, aInputSize, ioScratchBuffer.data());
+                if (aInputSize < aRequestedSize)
+                {
+                    throw exception::Exception("Truncated file.");
+                }
+
+                try
+                {
+                    uint32_t aHeadSize = iHeadSize;
+                    compression::inflateDatFileBuffer(aInputSize & ~3u, ioScratchBuffer.data(), aHeadSize, oHead);
+                    return aHeadSize;
+                }
+                catch (std::exception &)
+                {
+                    // The prefix was not enough, retrying with the whole file
+                    if (aRequestedSize >= iFileRecord.size)
+                    {
+                        throw;
+                    }
+                    aRequestedSize = iFileRecord.size;
+                }
+            }
+        }
+
+        uint32_t readFileContent(datfile::ANDatInterface &iANDatInterface,
+                                 const datfile::ANDatInterface::FileRecord &iFileRecord,
+                                 std::vector<uint8_t> &ioInputBuffer,
+                                 std::vector<uint8_t> &ioContentBuffer)
+        {
+            std::vector<uint8_t> &aRawBuffer = iFileRecord.isCompressed ? ioInputBuffer : ioContentBuffer;
+
+            uint32_t aRawSize = iFileRecord.size;
+            if (aRawBuffer.size() < aRawSize)
+            {
+                aRawBuffer.resize(aRawSize);
+            }
+            iANDatInterface.getBuffer(iFileRecord, aRawSize, aRawBuffer.data());
+            if (aRawSize < iFileRecord.size)
+            {
+                throw exception::Exception("Truncated file.");
+            }
+
+            if (!iFileRecord.isCompressed)
+            {
+                return aRawSize;
+            }
+
+            // The uncompressed size follows the first word of the compressed stream
+            uint32_t aContentSize = 0;
+            if (aRawSize >= 2 * sizeof(uint32_t))
+            {
+                memcpy(&aContentSize, aRawBuffer.data() + sizeof(uint32_t), sizeof(aContentSize));
+            }
+            if (aContentSize == 0)
+            {
+                return 0;
+            }
+
+            if (ioContentBuffer.size() < aContentSize)
+            {
+                ioContentBuffer.resize(aContentSize);
+            }
+            compression::inflateDatFileBuffer(aRawSize & ~3u, aRawBuffer.data(), aContentSize, ioContentBuffer.data());
+            return aContentSize;
+        }
+
+    } // namespace index
+} // namespace gw2dt
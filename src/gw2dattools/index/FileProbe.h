@@ -0,0 +1,93 @@
+#ifndef GW2DATTOOLS_INDEX_FILEPROBE_H
+#define GW2DATTOOLS_INDEX_FILEPROBE_H
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <vector>
+
+#include "gw2dattools/interface/ANDatInterface.h"
+
+#include "../utils/Parallel.h"
+
+namespace gw2dt
+{
+    namespace index
+    {
+
+        /**
+         * Reads the first bytes of a file content, inflating only as much as needed.
+         * Only a prefix of the compressed data is read, the whole file is used as a fallback when
+         * the prefix does not hold enough data to decode the requested bytes.
+         * @param iANDatInterface Archive to read from.
+         * @param iFileRecord File to read.
+         * @param iHeadSize Number of bytes requested.
+         * @param oHead Output buffer, at least iHeadSize bytes long.
+         * @param ioScratchBuffer Buffer receiving the raw data, reused between calls.
+         * @return Number of bytes written in oHead, may be less than iHeadSize for small files.
+         * @throws gw2dt::exception::Exception If the archive ends before the compressed data of the file.
+         */
+        uint32_t readFileHead(datfile::ANDatInterface &iANDatInterface,
+                              const datfile::ANDatInterface::FileRecord &iFileRecord,
+                              uint32_t iHeadSize,
+                              uint8_t *oHead,
+                              std::vector<uint8_t> &ioScratchBuffer);
+
+        /**
+         * Reads the whole content of a file, inflating it if needed.
+         * @param iANDatInterface Archive to read from.
+         * @param iFileRecord File to read.
+         * @param ioInputBuffer Buffer receiving the raw data, reused between calls.
+         * @param ioContentBuffer Buffer receiving the content, reused between calls.
+         * @return Size of the content, the buffer may be larger.
+         * @throws gw2dt::exception::Exception If the archive ends before the data of the file.
+         */
+        uint32_t readFileContent(datfile::ANDatInterface &iANDatInterface,
+                                 const datfile::ANDatInterface::FileRecord &iFileRecord,
+                                 std::vector<uint8_t> &ioInputBuffer,
+                                 std::vector<uint8_t> &ioContentBuffer);
+
+        // Buffers of a scanning thread, reused between the files it handles
+        struct ScanBuffers
+        {
+            std::vector<uint8_t> inputBuffer;
+            std::vector<uint8_t> contentBuffer;
+        };
+
+        /**
+         * Visits every file record of an archive, the records being shared out between several threads.
+         * A file whose visit throws a std::exception is handed to iOnFailure, which lets the caller reset
+         * what the visit left; the scan goes on with the other files.
+         * @param iANDatInterface Archive to scan.
+         * @param iNbThreads Number of threads, 0 to use one per hardware thread.
+         * @param iVisitor Function called as iVisitor(ScanBuffers &ioBuffers, size_t iRecordIndex).
+         * @param iOnFailure Function called as iOnFailure(size_t iRecordIndex).
+         */
+        template <typename Visitor, typename FailureHandler>
+        void scanFiles(const datfile::ANDatInterface &iANDatInterface, uint32_t iNbThreads, Visitor iVisitor, FailureHandler iOnFailure)
+        {
+            const size_t aNbOfRecords = iANDatInterface.getFileRecordVect().size();
+            std::atomic<size_t> aNextIndex(0);
+
+            utils::runWorkers(iNbThreads, [&](uint32_t)
+            {
+                ScanBuffers aBuffers;
+
+                for (size_t aIndex = aNextIndex++; aIndex < aNbOfRecords; aIndex = aNextIndex++)
+                {
+                    try
+                    {
+                        iVisitor(aBuffers, aIndex);
+                    }
+                    catch (std::exception &)
+                    {
+                        iOnFailure(aIndex);
+                    }
+                }
+            });
+        }
+
+    } // namespace index
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_INDEX_FILEPROBE_H
@@ -0,0 +1,65 @@
+#include "FileReferences.h"
+
+#include <algorithm>
+
+#include "gw2dattools/anstructs/ANStructs.h"
+#include "gw2dattools/format/PackFileView.h"
+
+namespace gw2dt
+{
+    namespace index
+    {
+
+        FileIdDict buildFileIdDict(const datfile::ANDatInterface &iANDatInterface)
+        {
+            const std::vector<datfile::ANDatInterface::FileRecord> &aFileRecordVect = iANDatInterface.getFileRecordVect();
+
+            // filename fields hold the base id of a file, which is its only id when it has no other one
+            FileIdDict aFileIdDict;
+            aFileIdDict.rehash(aFileRecordVect.size() * 2);
+
+            for (auto &itFileRecord : aFileRecordVect)
+            {
+                aFileIdDict.insert(std::make_pair(itFileRecord.fileId, itFileRecord.fileId));
+                if (itFileRecord.baseId != 0)
+                {
+                    aFileIdDict.insert(std::make_pair(itFileRecord.baseId, itFileRecord.fileId));
+                }
+            }
+
+            return aFileIdDict;
+        }
+
+        void collectFileReferences(uint32_t iFileId,
+                                   uint32_t iSize,
+                                   const uint8_t *iContent,
+                                   const FileIdDict &iFileIdDict,
+                                   std::vector<uint32_t> &oReferenceVect)
+        {
+            oReferenceVect.clear();
+
+            if (!format::PackFileView::isPackFile(iSize, iContent))
+            {
+                return;
+            }
+
+            format::PackFileView aPackFileView(iSize, iContent);
+
+            for (auto &itChunk : aPackFileView.getChunkVect())
+            {
+                anstructs::visitChunkFilenames(aPackFileView.getType(), itChunk, [&](uint32_t iBaseId)
+                {
+                    auto itFileId = iFileIdDict.find(iBaseId);
+                    if (itFileId != iFileIdDict.end() && itFileId->second != iFileId)
+                    {
+                        oReferenceVect.push_back(itFileId->second);
+                    }
+                });
+            }
+
+            std::sort(oReferenceVect.begin(), oReferenceVect.end());
+            oReferenceVect.erase(std::unique(oReferenceVect.begin(), oReferenceVect.end()), oReferenceVect.end());
+        }
+
+    } // namespace index
+} // namespace gw2dt
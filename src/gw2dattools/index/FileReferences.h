@@ -0,0 +1,40 @@
+#ifndef GW2DATTOOLS_INDEX_FILEREFERENCES_H
+#define GW2DATTOOLS_INDEX_FILEREFERENCES_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "gw2dattools/interface/ANDatInterface.h"
+
+namespace gw2dt
+{
+    namespace index
+    {
+
+        // Maps the base ids and the fileIds of an archive to the fileIds of its records
+        typedef std::unordered_map<uint32_t, uint32_t> FileIdDict;
+
+        FileIdDict buildFileIdDict(const datfile::ANDatInterface &iANDatInterface);
+
+        /**
+         * Collects the files referenced by the filename fields of a PackFile.
+         * Nothing is collected if the content is not a PackFile. Chunks sharing their magic with other
+         * structures are skipped when the pack type of the file does not tell which one they use.
+         * @param iFileId File the content belongs to, references to itself are dropped.
+         * @param iSize Size of the content.
+         * @param iContent Inflated content of the file.
+         * @param iFileIdDict Ids of the archive, references to other files are dropped.
+         * @param oReferenceVect Referenced fileIds, sorted and unique.
+         * @throws gw2dt::exception::Exception If the PackFile is malformed.
+         */
+        void collectFileReferences(uint32_t iFileId,
+                                   uint32_t iSize,
+                                   const uint8_t *iContent,
+                                   const FileIdDict &iFileIdDict,
+                                   std::vector<uint32_t> &oReferenceVect);
+
+    } // namespace index
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_INDEX_FILEREFERENCES_H
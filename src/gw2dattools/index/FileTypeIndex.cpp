@@ -0,0 +1,132 @@
+#include "gw2dattools/index/FileTypeIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "gw2dattools/format/PackFileView.h"
+
+#include "FileProbe.h"
+#include "SidecarFile.h"
+
+namespace gw2dt
+{
+    namespace index
+    {
+
+#pragma pack(push, 1)
+        struct FileTypeIndexFileHeader
+        {
+            uint8_t magic[4];
+            uint32_t version;
+            uint32_t nbOfEntries;
+        };
+#pragma pack(pop)
+
+        static const uint8_t sFileTypeIndexMagic[4] = {'G', 'F', 'T', 'I'};
+        static const uint32_t sFileTypeIndexVersion = 1;
+
+        // The PackFile header is the largest header read
+        static const uint32_t sFileHeadSize = 12;
+        static const uint32_t sPackFileTypeOffset = 8;
+
+        static bool compareEntries(const FileTypeIndex::Entry &iLeft, const FileTypeIndex::Entry &iRight)
+        {
+            if (iLeft.magic != iRight.magic)
+            {
+                return iLeft.magic < iRight.magic;
+            }
+            if (iLeft.packType != iRight.packType)
+            {
+                return iLeft.packType < iRight.packType;
+            }
+            return iLeft.fileId < iRight.fileId;
+        }
+
+        FileTypeIndex::FileTypeIndex(std::vector<Entry> iEntryVect) : _entryVect(std::move(iEntryVect))
+        {
+            std::sort(_entryVect.begin(), _entryVect.end(), compareEntries);
+        }
+
+        std::vector<FileTypeIndex::Entry> FileTypeIndex::findFiles(uint32_t iMagic, uint32_t iPackType) const
+        {
+            Entry aLowerBound = {0, iMagic, iPackType};
+            Entry aUpperBound = {UINT32_MAX, iMagic, iPackType == 0 ? UINT32_MAX : iPackType};
+
+            auto itBegin = std::lower_bound(_entryVect.begin(), _entryVect.end(), aLowerBound, compareEntries);
+            auto itEnd = std::upper_bound(itBegin, _entryVect.end(), aUpperBound, compareEntries);
+
+            return std::vector<Entry>(itBegin, itEnd);
+        }
+
+        std::vector<FileTypeIndex::Entry> FileTypeIndex::findPackFiles(uint32_t iPackType) const
+        {
+            return findFiles(PackFileMagic, iPackType);
+        }
+
+        const std::vector<FileTypeIndex::Entry> &FileTypeIndex::getEntryVect() const
+        {
+            return _entryVect;
+        }
+
+        void FileTypeIndex::save(const char *iPath) const
+        {
+            SidecarWriter aWriter(iPath, "file type index");
+
+            FileTypeIndexFileHeader aHeader;
+            aHeader.nbOfEntries = static_cast<uint32_t>(_entryVect.size());
+
+            aWriter.writeHeader(aHeader, sFileTypeIndexMagic, sFileTypeIndexVersion);
+            aWriter.writeVect(_entryVect);
+            aWriter.close();
+        }
+
+        GW2DATTOOLS_API std::unique_ptr<FileTypeIndex> GW2DATTOOLS_APIENTRY buildFileTypeIndex(datfile::ANDatInterface &iANDatInterface, uint32_t iNbThreads)
+        {
+            const std::vector<datfile::ANDatInterface::FileRecord> &aFileRecordVect = iANDatInterface.getFileRecordVect();
+
+            std::vector<FileTypeIndex::Entry> aEntryVect(aFileRecordVect.size(), FileTypeIndex::Entry());
+
+            scanFiles(iANDatInterface, iNbThreads, [&](ScanBuffers &ioBuffers, size_t iIndex)
+            {
+                const datfile::ANDatInterface::FileRecord &aFileRecord = aFileRecordVect[iIndex];
+                FileTypeIndex::Entry &aEntry = aEntryVect[iIndex];
+
+                aEntry.fileId = aFileRecord.fileId;
+
+                uint8_t aHead[sFileHeadSize] = {};
+                uint32_t aHeadSize = readFileHead(iANDatInterface, aFileRecord, sizeof(aHead), aHead, ioBuffers.inputBuffer);
+
+                if (format::PackFileView::isPackFile(aHeadSize, aHead))
+                {
+                    aEntry.magic = FileTypeIndex::PackFileMagic;
+                    memcpy(&aEntry.packType, aHead + sPackFileTypeOffset, sizeof(aEntry.packType));
+                }
+                else
+                {
+                    memcpy(&aEntry.magic, aHead, sizeof(aEntry.magic));
+                }
+            },
+            [](size_t)
+            {
+                // Files that fail to inflate keep a null magic
+            });
+
+            return std::unique_ptr<FileTypeIndex>(new FileTypeIndex(std::move(aEntryVect)));
+        }
+
+        GW2DATTOOLS_API std::unique_ptr<FileTypeIndex> GW2DATTOOLS_APIENTRY loadFileTypeIndex(const char *iPath)
+        {
+            SidecarReader aReader(iPath, "file type index");
+
+            FileTypeIndexFileHeader aHeader;
+            aReader.readHeader(aHeader, sFileTypeIndexMagic, sFileTypeIndexVersion);
+
+            std::vector<FileTypeIndex::Entry> aEntryVect;
+            aReader.readVect(aHeader.nbOfEntries, aEntryVect);
+
+            return std::unique_ptr<FileTypeIndex>(new FileTypeIndex(std::move(aEntryVect)));
+        }
+
+    } // namespace index
+} // namespace gw2dt
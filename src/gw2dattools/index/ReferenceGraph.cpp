@@ -0,0 +1,232 @@
+#include "gw2dattools/index/ReferenceGraph.h"
+
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+
+#include "gw2dattools/exception/Exception.h"
+#include "gw2dattools/format/PackFileView.h"
+#include "gw2dattools/index/FileTypeIndex.h"
+
+#include "FileProbe.h"
+#include "FileReferences.h"
+#include "SidecarFile.h"
+
+namespace gw2dt
+{
+    namespace index
+    {
+
+#pragma pack(push, 1)
+        struct ReferenceGraphFileHeader
+        {
+            uint8_t magic[4];
+            uint32_t version;
+            uint32_t nbOfFiles;
+            uint32_t nbOfReferences;
+        };
+#pragma pack(pop)
+
+        static const uint8_t sReferenceGraphMagic[4] = {'G', 'R', 'E', 'F'};
+        static const uint32_t sReferenceGraphVersion = 1;
+
+        static const uint32_t sPackFileHeadSize = 12;
+
+        ReferenceGraph::ReferenceGraph(std::vector<uint32_t> iFileIdVect, std::vector<uint32_t> iOffsetVect, std::vector<uint32_t> iReferenceVect)
+            : _fileIdVect(std::move(iFileIdVect)), _offsetVect(std::move(iOffsetVect)), _referenceVect(std::move(iReferenceVect))
+        {
+            if (_offsetVect.size() != _fileIdVect.size() + 1 || _offsetVect.front() != 0 || _offsetVect.back() != _referenceVect.size())
+            {
+                throw exception::Exception("Inconsistent reference graph.");
+            }
+
+            for (size_t aIndex = 1; aIndex < _offsetVect.size(); ++aIndex)
+            {
+                if (_offsetVect[aIndex] < _offsetVect[aIndex - 1])
+                {
+                    throw exception::Exception("Inconsistent reference graph.");
+                }
+            }
+
+            // getReferences looks the rows up by binary search
+            for (size_t aIndex = 1; aIndex < _fileIdVect.size(); ++aIndex)
+            {
+                if (_fileIdVect[aIndex] <= _fileIdVect[aIndex - 1])
+                {
+                    throw exception::Exception("Inconsistent reference graph.");
+                }
+            }
+        }
+
+        const uint32_t *ReferenceGraph::getReferences(uint32_t iFileId, uint32_t &oNbOfReferences) const
+        {
+            oNbOfReferences = 0;
+
+            auto itFileId = std::lower_bound(_fileIdVect.begin(), _fileIdVect.end(), iFileId);
+            if (itFileId == _fileIdVect.end() || *itFileId != iFileId)
+            {
+                return nullptr;
+            }
+
+            size_t aRow = itFileId - _fileIdVect.begin();
+            oNbOfReferences = _offsetVect[aRow + 1] - _offsetVect[aRow];
+            return _referenceVect.data() + _offsetVect[aRow];
+        }
+
+        std::vector<uint32_t> ReferenceGraph::getDependencyClosure(uint32_t iFileId) const
+        {
+            std::vector<uint32_t> aClosureVect;
+            std::unordered_set<uint32_t> aVisitedSet;
+            aVisitedSet.insert(iFileId);
+
+            // aClosureVect doubles as the queue of the breadth-first search
+            uint32_t aNbOfReferences;
+            const uint32_t *pReferences = getReferences(iFileId, aNbOfReferences);
+
+            for (size_t aQueuePos = 0;; ++aQueuePos)
+            {
+                for (uint32_t aIndex = 0; aIndex < aNbOfReferences; ++aIndex)
+                {
+                    if (aVisitedSet.insert(pReferences[aIndex]).second)
+                    {
+                        aClosureVect.push_back(pReferences[aIndex]);
+                    }
+                }
+
+                if (aQueuePos >= aClosureVect.size())
+                {
+                    break;
+                }
+                pReferences = getReferences(aClosureVect[aQueuePos], aNbOfReferences);
+            }
+
+            return aClosureVect;
+        }
+
+        const std::vector<uint32_t> &ReferenceGraph::getFileIdVect() const
+        {
+            return _fileIdVect;
+        }
+
+        const std::vector<uint32_t> &ReferenceGraph::getOffsetVect() const
+        {
+            return _offsetVect;
+        }
+
+        const std::vector<uint32_t> &ReferenceGraph::getReferenceVect() const
+        {
+            return _referenceVect;
+        }
+
+        void ReferenceGraph::save(const char *iPath) const
+        {
+            SidecarWriter aWriter(iPath, "reference graph");
+
+            ReferenceGraphFileHeader aHeader;
+            aHeader.nbOfFiles = static_cast<uint32_t>(_fileIdVect.size());
+            aHeader.nbOfReferences = static_cast<uint32_t>(_referenceVect.size());
+
+            aWriter.writeHeader(aHeader, sReferenceGraphMagic, sReferenceGraphVersion);
+            aWriter.writeVect(_fileIdVect);
+            aWriter.writeVect(_offsetVect);
+            aWriter.writeVect(_referenceVect);
+            aWriter.close();
+        }
+
+        GW2DATTOOLS_API std::unique_ptr<ReferenceGraph> GW2DATTOOLS_APIENTRY buildReferenceGraph(datfile::ANDatInterface &iANDatInterface,
+                                                                                                const FileTypeIndex *ipFileTypeIndex,
+                                                                                                uint32_t iNbThreads)
+        {
+            const std::vector<datfile::ANDatInterface::FileRecord> &aFileRecordVect = iANDatInterface.getFileRecordVect();
+
+            FileIdDict aFileIdDict = buildFileIdDict(iANDatInterface);
+
+            std::unordered_set<uint32_t> aPackFileIdSet;
+            if (ipFileTypeIndex != nullptr)
+            {
+                for (auto &itEntry : ipFileTypeIndex->findFiles(FileTypeIndex::PackFileMagic))
+                {
+                    aPackFileIdSet.insert(itEntry.fileId);
+                }
+            }
+
+            // References of each record, sorted and unique
+            std::vector<std::vector<uint32_t>> aReferencesVect(aFileRecordVect.size());
+
+            scanFiles(iANDatInterface, iNbThreads, [&](ScanBuffers &ioBuffers, size_t iIndex)
+            {
+                const datfile::ANDatInterface::FileRecord &aFileRecord = aFileRecordVect[iIndex];
+
+                if (ipFileTypeIndex != nullptr)
+                {
+                    if (aPackFileIdSet.count(aFileRecord.fileId) == 0)
+                    {
+                        return;
+                    }
+                }
+                else
+                {
+                    uint8_t aHead[sPackFileHeadSize];
+                    uint32_t aHeadSize = readFileHead(iANDatInterface, aFileRecord, sizeof(aHead), aHead, ioBuffers.inputBuffer);
+                    if (!format::PackFileView::isPackFile(aHeadSize, aHead))
+                    {
+                        return;
+                    }
+                }
+
+                uint32_t aContentSize = readFileContent(iANDatInterface, aFileRecord, ioBuffers.inputBuffer, ioBuffers.contentBuffer);
+                collectFileReferences(aFileRecord.fileId, aContentSize, ioBuffers.contentBuffer.data(), aFileIdDict, aReferencesVect[iIndex]);
+            },
+            [&](size_t iIndex)
+            {
+                // Files that fail to inflate or to parse have no reference
+                aReferencesVect[iIndex].clear();
+            });
+
+            // Rows are sorted by fileId
+            std::vector<size_t> aRecordIndexVect;
+            for (size_t aIndex = 0; aIndex < aFileRecordVect.size(); ++aIndex)
+            {
+                if (!aReferencesVect[aIndex].empty())
+                {
+                    aRecordIndexVect.push_back(aIndex);
+                }
+            }
+            std::sort(aRecordIndexVect.begin(), aRecordIndexVect.end(), [&](size_t iLeft, size_t iRight)
+            {
+                return aFileRecordVect[iLeft].fileId < aFileRecordVect[iRight].fileId;
+            });
+
+            std::vector<uint32_t> aFileIdVect;
+            std::vector<uint32_t> aOffsetVect(1, 0);
+            std::vector<uint32_t> aReferenceVect;
+
+            for (size_t aRecordIndex : aRecordIndexVect)
+            {
+                aFileIdVect.push_back(aFileRecordVect[aRecordIndex].fileId);
+                aReferenceVect.insert(aReferenceVect.end(), aReferencesVect[aRecordIndex].begin(), aReferencesVect[aRecordIndex].end());
+                aOffsetVect.push_back(static_cast<uint32_t>(aReferenceVect.size()));
+            }
+
+            return std::unique_ptr<ReferenceGraph>(new ReferenceGraph(std::move(aFileIdVect), std::move(aOffsetVect), std::move(aReferenceVect)));
+        }
+
+        GW2DATTOOLS_API std::unique_ptr<ReferenceGraph> GW2DATTOOLS_APIENTRY loadReferenceGraph(const char *iPath)
+        {
+            SidecarReader aReader(iPath, "reference graph");
+
+            ReferenceGraphFileHeader aHeader;
+            aReader.readHeader(aHeader, sReferenceGraphMagic, sReferenceGraphVersion);
+
+            std::vector<uint32_t> aFileIdVect;
+            std::vector<uint32_t> aOffsetVect;
+            std::vector<uint32_t> aReferenceVect;
+            aReader.readVect(aHeader.nbOfFiles, aFileIdVect);
+            aReader.readVect(uint64_t(aHeader.nbOfFiles) + 1, aOffsetVect);
+            aReader.readVect(aHeader.nbOfReferences, aReferenceVect);
+
+            return std::unique_ptr<ReferenceGraph>(new ReferenceGraph(std::move(aFileIdVect), std::move(aOffsetVect), std::move(aReferenceVect)));
+        }
+
+    } // namespace index
+} // namespace gw2dt
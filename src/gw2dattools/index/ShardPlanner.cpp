@@ -0,0 +1,182 @@
+#include "gw2dattools/index/ShardPlanner.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "gw2dattools/exception/Exception.h"
+#include "gw2dattools/integrity/ContentHash.h"
+
+#include "SidecarFile.h"
+
+namespace gw2dt
+{
+    namespace index
+    {
+
+#pragma pack(push, 1)
+        struct ShardManifestFileHeader
+        {
+            uint8_t magic[4];
+            uint32_t version;
+            uint32_t index;
+            uint32_t nbOfShards;
+            uint64_t beginOffset;
+            uint64_t endOffset;
+            uint64_t size;
+            uint64_t archiveHash;
+            uint32_t nbOfFiles;
+        };
+
+        // Fields of a file record hashed to identify an archive
+        struct HashedFileRecord
+        {
+            uint64_t offset;
+            uint32_t size;
+            uint32_t baseId;
+            uint32_t fileId;
+            uint32_t crc;
+            uint8_t isCompressed;
+        };
+#pragma pack(pop)
+
+        static const uint8_t sShardManifestMagic[4] = {'G', 'S', 'H', 'M'};
+        static const uint32_t sShardManifestVersion = 2;
+
+        namespace
+        {
+
+            // Any change to the file table, as made by an update of the archive, changes the hash
+            uint64_t computeArchiveHash(const datfile::ANDatInterface &iANDatInterface)
+            {
+                const std::vector<datfile::ANDatInterface::FileRecord> &aFileRecordVect = iANDatInterface.getFileRecordVect();
+
+                std::vector<HashedFileRecord> aHashedRecordVect(aFileRecordVect.size());
+                for (size_t aIndex = 0; aIndex < aFileRecordVect.size(); ++aIndex)
+                {
+                    const datfile::ANDatInterface::FileRecord &aFileRecord = aFileRecordVect[aIndex];
+                    HashedFileRecord &aHashedRecord = aHashedRecordVect[aIndex];
+                    aHashedRecord.offset = aFileRecord.offset;
+                    aHashedRecord.size = aFileRecord.size;
+                    aHashedRecord.baseId = aFileRecord.baseId;
+                    aHashedRecord.fileId = aFileRecord.fileId;
+                    aHashedRecord.crc = aFileRecord.crc;
+                    aHashedRecord.isCompressed = aFileRecord.isCompressed ? 1 : 0;
+                }
+
+                return integrity::computeContentHash(static_cast<uint32_t>(aHashedRecordVect.size() * sizeof(HashedFileRecord)),
+                                                     reinterpret_cast<const uint8_t *>(aHashedRecordVect.data()));
+            }
+
+        } // namespace
+
+        GW2DATTOOLS_API std::vector<Shard> GW2DATTOOLS_APIENTRY planShards(const datfile::ANDatInterface &iANDatInterface, uint32_t iNbOfShards)
+        {
+            if (iNbOfShards == 0)
+            {
+                throw exception::Exception("The number of shards is null.");
+            }
+
+            const std::vector<datfile::ANDatInterface::FileRecord> &aFileRecordVect = iANDatInterface.getFileRecordVect();
+
+            std::vector<uint32_t> aOrderVect(aFileRecordVect.size());
+            std::iota(aOrderVect.begin(), aOrderVect.end(), 0);
+            std::sort(aOrderVect.begin(), aOrderVect.end(), [&](uint32_t iLeft, uint32_t iRight)
+            {
+                return aFileRecordVect[iLeft].offset < aFileRecordVect[iRight].offset;
+            });
+
+            uint64_t aArchiveHash = computeArchiveHash(iANDatInterface);
+
+            uint64_t aTotalSize = 0;
+            for (const datfile::ANDatInterface::FileRecord &aFileRecord : aFileRecordVect)
+            {
+                aTotalSize += aFileRecord.size;
+            }
+
+            std::vector<Shard> aShardVect(iNbOfShards);
+            uint64_t aPrefixSize = 0;
+            size_t aOrderIndex = 0;
+
+            for (uint32_t aShardIndex = 0; aShardIndex < iNbOfShards; ++aShardIndex)
+            {
+                Shard &aShard = aShardVect[aShardIndex];
+                aShard.index = aShardIndex;
+                aShard.nbOfShards = iNbOfShards;
+                aShard.beginOffset = 0;
+                aShard.endOffset = 0;
+                aShard.size = 0;
+                aShard.archiveHash = aArchiveHash;
+
+                bool aIsLast = aShardIndex + 1 == iNbOfShards;
+                uint64_t aTargetSize = aTotalSize / iNbOfShards * (aShardIndex + 1) + aTotalSize % iNbOfShards * (aShardIndex + 1) / iNbOfShards;
+
+                for (; aOrderIndex < aOrderVect.size(); ++aOrderIndex)
+                {
+                    const datfile::ANDatInterface::FileRecord &aFileRecord = aFileRecordVect[aOrderVect[aOrderIndex]];
+                    uint64_t aNextPrefixSize = aPrefixSize + aFileRecord.size;
+
+                    // The file straddling the target goes to the side of the boundary it mostly lies on
+                    if (!aIsLast && aNextPrefixSize > aTargetSize &&
+                        (aPrefixSize >= aTargetSize || aNextPrefixSize - aTargetSize >= aTargetSize - aPrefixSize))
+                    {
+                        break;
+                    }
+
+                    if (aShard.fileIdVect.empty())
+                    {
+                        aShard.beginOffset = aFileRecord.offset;
+                    }
+                    aShard.endOffset = std::max(aShard.endOffset, aFileRecord.offset + aFileRecord.size);
+                    aShard.size += aFileRecord.size;
+                    aShard.fileIdVect.push_back(aFileRecord.fileId);
+                    aPrefixSize = aNextPrefixSize;
+                }
+            }
+
+            return aShardVect;
+        }
+
+        GW2DATTOOLS_API void GW2DATTOOLS_APIENTRY saveShardManifest(const Shard &iShard, const char *iPath)
+        {
+            SidecarWriter aWriter(iPath, "shard manifest");
+
+            ShardManifestFileHeader aHeader;
+            aHeader.index = iShard.index;
+            aHeader.nbOfShards = iShard.nbOfShards;
+            aHeader.beginOffset = iShard.beginOffset;
+            aHeader.endOffset = iShard.endOffset;
+            aHeader.size = iShard.size;
+            aHeader.archiveHash = iShard.archiveHash;
+            aHeader.nbOfFiles = static_cast<uint32_t>(iShard.fileIdVect.size());
+
+            aWriter.writeHeader(aHeader, sShardManifestMagic, sShardManifestVersion);
+            aWriter.writeVect(iShard.fileIdVect);
+            aWriter.close();
+        }
+
+        GW2DATTOOLS_API Shard GW2DATTOOLS_APIENTRY loadShardManifest(const char *iPath, const datfile::ANDatInterface &iANDatInterface)
+        {
+            SidecarReader aReader(iPath, "shard manifest");
+
+            ShardManifestFileHeader aHeader;
+            aReader.readHeader(aHeader, sShardManifestMagic, sShardManifestVersion);
+
+            if (aHeader.archiveHash != computeArchiveHash(iANDatInterface))
+            {
+                throw exception::Exception("The shard manifest was planned on another archive or another version of it.");
+            }
+
+            Shard aShard;
+            aShard.index = aHeader.index;
+            aShard.nbOfShards = aHeader.nbOfShards;
+            aShard.beginOffset = aHeader.beginOffset;
+            aShard.endOffset = aHeader.endOffset;
+            aShard.size = aHeader.size;
+            aShard.archiveHash = aHeader.archiveHash;
+            aReader.readVect(aHeader.nbOfFiles, aShard.fileIdVect);
+
+            return aShard;
+        }
+
+    } // namespace index
+} // namespace gw2dt
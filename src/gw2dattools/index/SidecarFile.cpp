@@ -0,0 +1,62 @@
+#include "SidecarFile.h"
+
+#include "gw2dattools/exception/Exception.h"
+
+namespace gw2dt
+{
+    namespace index
+    {
+
+        SidecarWriter::SidecarWriter(const char *iPath, const char *iName) : _stream(iPath, std::ios::binary),
+                                                                             _name(iName)
+        {
+            if (!_stream)
+            {
+                throw exception::Exception(("Unable to open the " + _name + " file for writing.").c_str());
+            }
+        }
+
+        void SidecarWriter::close()
+        {
+            _stream.close();
+            if (!_stream)
+            {
+                throw exception::Exception(("Unable to write the " + _name + " file.").c_str());
+            }
+        }
+
+        SidecarReader::SidecarReader(const char *iPath, const char *iName) : _stream(iPath, std::ios::binary | std::ios::ate),
+                                                                             _name(iName),
+                                                                             _remainingSize(0)
+        {
+            if (!_stream)
+            {
+                throw exception::Exception(("Unable to open the " + _name + " file.").c_str());
+            }
+
+            _remainingSize = static_cast<uint64_t>(_stream.tellg());
+            _stream.seekg(0);
+        }
+
+        void SidecarReader::throwError(const char *iPrefix, const char *iSuffix) const
+        {
+            throw exception::Exception((iPrefix + _name + iSuffix).c_str());
+        }
+
+        void SidecarReader::read(void *oData, uint64_t iSize)
+        {
+            if (iSize > _remainingSize)
+            {
+                throwError("Truncated ", " file.");
+            }
+
+            _stream.read(static_cast<char *>(oData), static_cast<std::streamsize>(iSize));
+            if (!_stream)
+            {
+                throwError("Unable to read the ", " file.");
+            }
+            _remainingSize -= iSize;
+        }
+
+    } // namespace index
+} // namespace gw2dt
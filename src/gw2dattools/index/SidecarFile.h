@@ -0,0 +1,106 @@
+#ifndef GW2DATTOOLS_INDEX_SIDECARFILE_H
+#define GW2DATTOOLS_INDEX_SIDECARFILE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace gw2dt
+{
+    namespace index
+    {
+
+        /**
+         * Writes a sidecar file: a packed header starting with a magic and a version, followed by
+         * arrays of packed structs whose counts are stored in the header.
+         */
+        class SidecarWriter
+        {
+        public:
+            /**
+             * @param iPath Path of the file to write.
+             * @param iName Name of the file kind used in the error messages, e.g. "texture catalog".
+             * @throws gw2dt::exception::Exception If the file cannot be opened.
+             */
+            SidecarWriter(const char *iPath, const char *iName);
+
+            template <typename Header>
+            void writeHeader(Header &ioHeader, const uint8_t (&iMagic)[4], uint32_t iVersion)
+            {
+                std::copy(iMagic, iMagic + 4, ioHeader.magic);
+                ioHeader.version = iVersion;
+                _stream.write(reinterpret_cast<const char *>(&ioHeader), sizeof(ioHeader));
+            }
+
+            template <typename Struct>
+            void writeVect(const std::vector<Struct> &iStructVect)
+            {
+                _stream.write(reinterpret_cast<const char *>(iStructVect.data()), sizeof(Struct) * iStructVect.size());
+            }
+
+            // @throws gw2dt::exception::Exception If a write failed.
+            void close();
+
+        private:
+            std::ofstream _stream;
+            std::string _name;
+        };
+
+        /**
+         * Reads a sidecar file written by SidecarWriter. The counts read from the header are checked
+         * against the size of the file before anything is allocated.
+         */
+        class SidecarReader
+        {
+        public:
+            /**
+             * @param iPath Path of the file to read.
+             * @param iName Name of the file kind used in the error messages, e.g. "texture catalog".
+             * @throws gw2dt::exception::Exception If the file cannot be opened.
+             */
+            SidecarReader(const char *iPath, const char *iName);
+
+            // @throws gw2dt::exception::Exception If the file is truncated or its magic or version differ.
+            template <typename Header>
+            void readHeader(Header &oHeader, const uint8_t (&iMagic)[4], uint32_t iVersion)
+            {
+                read(&oHeader, sizeof(oHeader));
+                if (!std::equal(iMagic, iMagic + 4, oHeader.magic))
+                {
+                    throwError("Not a valid ", " file.");
+                }
+                if (oHeader.version != iVersion)
+                {
+                    throwError("Unsupported ", " version.");
+                }
+            }
+
+            // @throws gw2dt::exception::Exception If the rest of the file is shorter than iCount structs.
+            template <typename Struct>
+            void readVect(uint64_t iCount, std::vector<Struct> &oStructVect)
+            {
+                if (iCount > _remainingSize / sizeof(Struct))
+                {
+                    throwError("Truncated ", " file.");
+                }
+                oStructVect.resize(static_cast<size_t>(iCount));
+                read(oStructVect.data(), sizeof(Struct) * oStructVect.size());
+            }
+
+            // @throws gw2dt::exception::Exception With the message iPrefix + name + iSuffix.
+            [[noreturn]] void throwError(const char *iPrefix, const char *iSuffix) const;
+
+        private:
+            void read(void *oData, uint64_t iSize);
+
+            std::ifstream _stream;
+            std::string _name;
+            uint64_t _remainingSize;
+        };
+
+    } // namespace index
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_INDEX_SIDECARFILE_H
@@ -0,0 +1,136 @@
+#include "gw2dattools/index/TextureCatalog.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "gw2dattools/compression/inflateTextureFileBuffer.h"
+
+#include "FileProbe.h"
+#include "SidecarFile.h"
+
+namespace gw2dt
+{
+    namespace index
+    {
+
+#pragma pack(push, 1)
+        struct TextureCatalogFileHeader
+        {
+            uint8_t magic[4];
+            uint32_t version;
+            uint32_t nbOfEntries;
+        };
+#pragma pack(pop)
+
+        static const uint8_t sTextureCatalogMagic[4] = {'G', 'T', 'X', 'C'};
+        static const uint32_t sTextureCatalogVersion = 1;
+
+        static bool compareEntries(const TextureCatalog::Entry &iLeft, const TextureCatalog::Entry &iRight)
+        {
+            if (iLeft.formatFourCc != iRight.formatFourCc)
+            {
+                return iLeft.formatFourCc < iRight.formatFourCc;
+            }
+            return iLeft.fileId < iRight.fileId;
+        }
+
+        TextureCatalog::TextureCatalog(std::vector<Entry> iEntryVect) : _entryVect(std::move(iEntryVect))
+        {
+            std::sort(_entryVect.begin(), _entryVect.end(), compareEntries);
+        }
+
+        std::vector<TextureCatalog::Entry> TextureCatalog::findTextures(uint32_t iFormatFourCc, uint16_t iMinWidth, uint16_t iMinHeight) const
+        {
+            auto itBegin = _entryVect.begin();
+            auto itEnd = _entryVect.end();
+
+            if (iFormatFourCc != 0)
+            {
+                Entry aLowerBound = {0, 0, iFormatFourCc, 0, 0};
+                Entry aUpperBound = {UINT32_MAX, 0, iFormatFourCc, 0, 0};
+                itBegin = std::lower_bound(itBegin, itEnd, aLowerBound, compareEntries);
+                itEnd = std::upper_bound(itBegin, itEnd, aUpperBound, compareEntries);
+            }
+
+            std::vector<Entry> aResultVect;
+
+            for (auto it = itBegin; it != itEnd; ++it)
+            {
+                if (it->width >= iMinWidth && it->height >= iMinHeight)
+                {
+                    aResultVect.push_back(*it);
+                }
+            }
+
+            return aResultVect;
+        }
+
+        const std::vector<TextureCatalog::Entry> &TextureCatalog::getEntryVect() const
+        {
+            return _entryVect;
+        }
+
+        void TextureCatalog::save(const char *iPath) const
+        {
+            SidecarWriter aWriter(iPath, "texture catalog");
+
+            TextureCatalogFileHeader aHeader;
+            aHeader.nbOfEntries = static_cast<uint32_t>(_entryVect.size());
+
+            aWriter.writeHeader(aHeader, sTextureCatalogMagic, sTextureCatalogVersion);
+            aWriter.writeVect(_entryVect);
+            aWriter.close();
+        }
+
+        GW2DATTOOLS_API std::unique_ptr<TextureCatalog> GW2DATTOOLS_APIENTRY buildTextureCatalog(datfile::ANDatInterface &iANDatInterface, uint32_t iNbThreads)
+        {
+            const std::vector<datfile::ANDatInterface::FileRecord> &aFileRecordVect = iANDatInterface.getFileRecordVect();
+
+            // One slot per record, fileId stays at 0 for files which are not textures
+            std::vector<TextureCatalog::Entry> aSlotVect(aFileRecordVect.size(), TextureCatalog::Entry());
+
+            scanFiles(iANDatInterface, iNbThreads, [&](ScanBuffers &ioBuffers, size_t iIndex)
+            {
+                const datfile::ANDatInterface::FileRecord &aFileRecord = aFileRecordVect[iIndex];
+                TextureCatalog::Entry &aEntry = aSlotVect[iIndex];
+
+                uint8_t aHead[12];
+                uint32_t aHeadSize = readFileHead(iANDatInterface, aFileRecord, sizeof(aHead), aHead, ioBuffers.inputBuffer);
+
+                if (compression::readTextureFileHeader(aHeadSize, aHead, aEntry.magic, aEntry.formatFourCc, aEntry.width, aEntry.height))
+                {
+                    aEntry.fileId = aFileRecord.fileId;
+                }
+            },
+            [](size_t)
+            {
+                // Files that fail to inflate are not part of the catalog
+            });
+
+            std::vector<TextureCatalog::Entry> aEntryVect;
+            for (auto &itSlot : aSlotVect)
+            {
+                if (itSlot.fileId != 0)
+                {
+                    aEntryVect.push_back(itSlot);
+                }
+            }
+
+            return std::unique_ptr<TextureCatalog>(new TextureCatalog(std::move(aEntryVect)));
+        }
+
+        GW2DATTOOLS_API std::unique_ptr<TextureCatalog> GW2DATTOOLS_APIENTRY loadTextureCatalog(const char *iPath)
+        {
+            SidecarReader aReader(iPath, "texture catalog");
+
+            TextureCatalogFileHeader aHeader;
+            aReader.readHeader(aHeader, sTextureCatalogMagic, sTextureCatalogVersion);
+
+            std::vector<TextureCatalog::Entry> aEntryVect;
+            aReader.readVect(aHeader.nbOfEntries, aEntryVect);
+
+            return std::unique_ptr<TextureCatalog>(new TextureCatalog(std::move(aEntryVect)));
+        }
+
+    } // namespace index
+} // namespace gw2dt
@@ -0,0 +1,112 @@
+#include "gw2dattools/integrity/ContentHash.h"
+
+#include <cstring>
+
+namespace gw2dt
+{
+    namespace integrity
+    {
+
+        namespace
+        {
+
+            const uint64_t sPrime1 = 0x9E3779B185EBCA87ull;
+            const uint64_t sPrime2 = 0xC2B2AE3D27D4EB4Full;
+            const uint64_t sPrime3 = 0x165667B19E3779F9ull;
+            const uint64_t sPrime4 = 0x85EBCA77C2B2AE63ull;
+            const uint64_t sPrime5 = 0x27D4EB2F165667C5ull;
+
+            inline uint64_t rotateLeft(uint64_t iValue, uint32_t iCount)
+            {
+                return (iValue << iCount) | (iValue >> (64 - iCount));
+            }
+
+            inline uint64_t read64(const uint8_t *iBuffer)
+            {
+                uint64_t aValue;
+                memcpy(&aValue, iBuffer, sizeof(aValue));
+                return aValue;
+            }
+
+            inline uint32_t read32(const uint8_t *iBuffer)
+            {
+                uint32_t aValue;
+                memcpy(&aValue, iBuffer, sizeof(aValue));
+                return aValue;
+            }
+
+            inline uint64_t hashRound(uint64_t iAccumulator, uint64_t iInput)
+            {
+                iAccumulator += iInput * sPrime2;
+                return rotateLeft(iAccumulator, 31) * sPrime1;
+            }
+
+            inline uint64_t mergeRound(uint64_t iAccumulator, uint64_t iValue)
+            {
+                iAccumulator ^= hashRound(0, iValue);
+                return iAccumulator * sPrime1 + sPrime4;
+            }
+
+        } // namespace
+
+        GW2DATTOOLS_API uint64_t GW2DATTOOLS_APIENTRY computeContentHash(uint32_t iSize, const uint8_t *iBuffer, uint64_t iSeed)
+        {
+            const uint8_t *pEnd = iBuffer + iSize;
+            uint64_t aHash;
+
+            if (iSize >= 32)
+            {
+                // Four independent lanes over 32-byte stripes
+                uint64_t aLane1 = iSeed + sPrime1 + sPrime2;
+                uint64_t aLane2 = iSeed + sPrime2;
+                uint64_t aLane3 = iSeed;
+                uint64_t aLane4 = iSeed - sPrime1;
+
+                for (; pEnd - iBuffer >= 32; iBuffer += 32)
+                {
+                    aLane1 = hashRound(aLane1, read64(iBuffer));
+                    aLane2 = hashRound(aLane2, read64(iBuffer + 8));
+                    aLane3 = hashRound(aLane3, read64(iBuffer + 16));
+                    aLane4 = hashRound(aLane4, read64(iBuffer + 24));
+                }
+
+                aHash = rotateLeft(aLane1, 1) + rotateLeft(aLane2, 7) + rotateLeft(aLane3, 12) + rotateLeft(aLane4, 18);
+                aHash = mergeRound(aHash, aLane1);
+                aHash = mergeRound(aHash, aLane2);
+                aHash = mergeRound(aHash, aLane3);
+                aHash = mergeRound(aHash, aLane4);
+            }
+            else
+            {
+                aHash = iSeed + sPrime5;
+            }
+
+            aHash += iSize;
+
+            for (; pEnd - iBuffer >= 8; iBuffer += 8)
+            {
+                aHash ^= hashRound(0, read64(iBuffer));
+                aHash = rotateLeft(aHash, 27) * sPrime1 + sPrime4;
+            }
+            if (pEnd - iBuffer >= 4)
+            {
+                aHash ^= read32(iBuffer) * sPrime1;
+                aHash = rotateLeft(aHash, 23) * sPrime2 + sPrime3;
+                iBuffer += 4;
+            }
+            for (; iBuffer < pEnd; ++iBuffer)
+            {
+                aHash ^= *iBuffer * sPrime5;
+                aHash = rotateLeft(aHash, 11) * sPrime1;
+            }
+
+            aHash ^= aHash >> 33;
+            aHash *= sPrime2;
+            aHash ^= aHash >> 29;
+            aHash *= sPrime3;
+            aHash ^= aHash >> 32;
+            return aHash;
+        }
+
+    } // namespace integrity
+} // namespace gw2dt
@@ -3,6 +3,7 @@
 #include <fstream>
 #include <unordered_map>
 #include <algorithm>
+#include <mutex>
 
 #include "gw2dattools/exception/Exception.h"
 
@@ -33,6 +34,7 @@ namespace gw2dt
 
         private:
             std::ifstream _datStream;
+            std::mutex _datStreamMutex;
 
             // Helper data structures
             std::unordered_map<uint32_t, FileRecord *> _fileIdDict;
@@ -58,9 +60,16 @@ namespace gw2dt
 
         void ANDatInterfaceImpl::getBuffer(const ANDatInterface::FileRecord &iFileRecord, uint32_t &ioOutputSize, uint8_t *ioBuffer)
         {
+            std::lock_guard<std::mutex> aLock(_datStreamMutex);
+
+            // A short read of a previous call leaves the stream failed, which would stop the seek
+            _datStream.clear();
             _datStream.seekg(iFileRecord.offset);
-            ioOutputSize = std::min(ioOutputSize, iFileRecord.size);
-            format::readStructs(_datStream, *ioBuffer, ioOutputSize);
+            format::readStructs(_datStream, *ioBuffer, std::min(ioOutputSize, iFileRecord.size));
+
+            // Less than requested when the archive is truncated
+            ioOutputSize = static_cast<uint32_t>(std::max<std::streamsize>(_datStream.gcount(), 0));
+            _datStream.clear();
         }
 
         const ANDatInterface::FileRecord &ANDatInterfaceImpl::getFileRecordForFileId(const uint32_t &iFileId) const
@@ -158,6 +167,8 @@ namespace gw2dt
 
                         aFileRecord.isCompressed = (aMftEntry.compressionFlag != 0);
 
+                        aFileRecord.crc = aMftEntry.crc;
+
                         aMftIndexDictHelper.insert(std::make_pair(itMapping.mftIndex, &aFileRecord));
                     }
                 }
@@ -0,0 +1,228 @@
+#include "gw2dattools/loader/DependencyLoader.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+
+#include "gw2dattools/exception/Exception.h"
+#include "gw2dattools/index/ReferenceGraph.h"
+
+#include "../index/FileProbe.h"
+#include "../index/FileReferences.h"
+#include "../utils/Parallel.h"
+
+namespace gw2dt
+{
+    namespace loader
+    {
+
+        namespace
+        {
+
+            struct PendingFile
+            {
+                uint32_t fileId;
+                uint32_t depth;
+            };
+
+            // State shared by the workers and the delivering thread
+            struct LoadState
+            {
+                std::mutex mutex;
+                std::condition_variable workerCondition;
+                std::condition_variable deliveryCondition;
+
+                std::deque<PendingFile> pendingQueue;
+                std::unordered_set<uint32_t> visitedSet;
+                std::deque<DependencyLoader::Asset> loadedQueue;
+
+                uint32_t nbOfActiveWorkers;
+                uint64_t heldBytes;
+                bool isStopped;
+
+                // No file is being read and none is left to read
+                bool isExhausted() const
+                {
+                    return pendingQueue.empty() && nbOfActiveWorkers == 0;
+                }
+            };
+
+        } // namespace
+
+        DependencyLoader::DependencyLoader(datfile::ANDatInterface &iANDatInterface,
+                                           uint32_t iNbThreads,
+                                           uint64_t iMemoryBudget,
+                                           const index::ReferenceGraph *ipReferenceGraph)
+            : _rANDatInterface(iANDatInterface),
+              _nbThreads(utils::getNbWorkerThreads(iNbThreads)),
+              _memoryBudget(iMemoryBudget),
+              _pReferenceGraph(ipReferenceGraph)
+        {
+            if (_pReferenceGraph == nullptr)
+            {
+                _fileIdDict = index::buildFileIdDict(_rANDatInterface);
+            }
+        }
+
+        void DependencyLoader::load(uint32_t iRootFileId, const AssetCallback &iCallback)
+        {
+            // Throws if the root is not in the archive
+            _rANDatInterface.getFileRecordForFileId(iRootFileId);
+
+            LoadState aState;
+            aState.nbOfActiveWorkers = 0;
+            aState.heldBytes = 0;
+            aState.isStopped = false;
+            aState.pendingQueue.push_back(PendingFile{iRootFileId, 0});
+            aState.visitedSet.insert(iRootFileId);
+
+            auto aWorker = [&]()
+            {
+                std::vector<uint8_t> aInputBuffer;
+                std::vector<uint32_t> aReferenceVect;
+
+                while (true)
+                {
+                    PendingFile aPendingFile;
+                    uint64_t aReservedBytes = 0;
+                    {
+                        std::unique_lock<std::mutex> aLock(aState.mutex);
+                        aState.workerCondition.wait(aLock, [&]()
+                        {
+                            return aState.isStopped || aState.isExhausted() ||
+                                   (!aState.pendingQueue.empty() && (aState.heldBytes < _memoryBudget || aState.heldBytes == 0));
+                        });
+
+                        if (aState.isStopped || aState.pendingQueue.empty())
+                        {
+                            return;
+                        }
+
+                        aPendingFile = aState.pendingQueue.front();
+                        aState.pendingQueue.pop_front();
+                        ++aState.nbOfActiveWorkers;
+
+                        // Counted from now on, so that the other workers do not start reads past the budget
+                        // meanwhile: the raw size is all that is known before the read
+                        try
+                        {
+                            aReservedBytes = _rANDatInterface.getFileRecordForFileId(aPendingFile.fileId).size;
+                        }
+                        catch (std::exception &)
+                        {
+                        }
+                        aState.heldBytes += aReservedBytes;
+                    }
+
+                    Asset aAsset;
+                    aAsset.fileId = aPendingFile.fileId;
+                    aAsset.depth = aPendingFile.depth;
+                    aReferenceVect.clear();
+
+                    try
+                    {
+                        const datfile::ANDatInterface::FileRecord &aFileRecord = _rANDatInterface.getFileRecordForFileId(aPendingFile.fileId);
+                        // Inflated straight into the asset, which is handed over to the callback
+                        uint32_t aContentSize = index::readFileContent(_rANDatInterface, aFileRecord, aInputBuffer, aAsset.content);
+                        aAsset.content.resize(aContentSize);
+
+                        if (_pReferenceGraph != nullptr)
+                        {
+                            uint32_t aNbOfReferences;
+                            const uint32_t *pReferences = _pReferenceGraph->getReferences(aPendingFile.fileId, aNbOfReferences);
+                            aReferenceVect.assign(pReferences, pReferences + aNbOfReferences);
+                        }
+                        else
+                        {
+                            index::collectFileReferences(aPendingFile.fileId, aContentSize, aAsset.content.data(), _fileIdDict, aReferenceVect);
+                        }
+                    }
+                    catch (std::exception &iException)
+                    {
+                        aAsset.content.clear();
+                        aAsset.error = iException.what();
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> aLock(aState.mutex);
+
+                        for (uint32_t aReference : aReferenceVect)
+                        {
+                            if (aState.visitedSet.insert(aReference).second)
+                            {
+                                aState.pendingQueue.push_back(PendingFile{aReference, aPendingFile.depth + 1});
+                            }
+                        }
+
+                        aState.heldBytes += aAsset.content.size();
+                        aState.heldBytes -= aReservedBytes;
+                        aState.loadedQueue.push_back(std::move(aAsset));
+                        --aState.nbOfActiveWorkers;
+                    }
+
+                    aState.workerCondition.notify_all();
+                    aState.deliveryCondition.notify_one();
+                }
+            };
+
+            auto aDeliverer = [&]()
+            {
+                try
+                {
+                    while (true)
+                    {
+                        Asset aAsset;
+                        {
+                            std::unique_lock<std::mutex> aLock(aState.mutex);
+                            aState.deliveryCondition.wait(aLock, [&]()
+                            {
+                                return !aState.loadedQueue.empty() || aState.isExhausted();
+                            });
+
+                            if (aState.loadedQueue.empty())
+                            {
+                                return;
+                            }
+
+                            aAsset = std::move(aState.loadedQueue.front());
+                            aState.loadedQueue.pop_front();
+                        }
+
+                        uint64_t aAssetSize = aAsset.content.size();
+                        iCallback(aAsset);
+
+                        {
+                            std::lock_guard<std::mutex> aLock(aState.mutex);
+                            aState.heldBytes -= aAssetSize;
+                        }
+                        aState.workerCondition.notify_all();
+                    }
+                }
+                catch (...)
+                {
+                    {
+                        std::lock_guard<std::mutex> aLock(aState.mutex);
+                        aState.isStopped = true;
+                    }
+                    aState.workerCondition.notify_all();
+                    throw;
+                }
+            };
+
+            // The calling thread delivers the assets while the others read them
+            utils::runWorkers(_nbThreads + 1, [&](uint32_t iThreadIndex)
+            {
+                if (iThreadIndex == 0)
+                {
+                    aDeliverer();
+                }
+                else
+                {
+                    aWorker();
+                }
+            });
+        }
+
+    } // namespace loader
+} // namespace gw2dt
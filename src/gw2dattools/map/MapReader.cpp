@@ -0,0 +1,457 @@
+#include "gw2dattools/map/MapReader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "gw2dattools/anstructs/prp2_PackMapProp.h"
+#include "gw2dattools/anstructs/trn_PackMapTerrain.h"
+#include "gw2dattools/exception/Exception.h"
+
+namespace gw2dt
+{
+    namespace map
+    {
+
+        namespace
+        {
+
+            uint32_t checkContentSize(const std::vector<uint8_t> &iContent)
+            {
+                if (iContent.size() > std::numeric_limits<uint32_t>::max())
+                {
+                    throw exception::Exception("Map content is too large.");
+                }
+                return static_cast<uint32_t>(iContent.size());
+            }
+
+            template <typename Type>
+            void checkArray(const anstructs::Bounds &iBounds, const anstructs::ArrayView<Type> &iArray, const char *iErrorMessage)
+            {
+                if (!iBounds.contains(iArray.getData(), anstructs::ArrayView<Type>::structSize) ||
+                    (iArray.size() != 0 && !iBounds.contains(iArray.getElements(), uint64_t(iArray.size()) * anstructs::ElementTraits<Type>::size)))
+                {
+                    throw exception::Exception(iErrorMessage);
+                }
+            }
+
+            uint32_t readFileId(const anstructs::Bounds &iBounds, const anstructs::Filename &iFilename)
+            {
+                const uint8_t *aValue = anstructs::resolvePointer(iFilename.getData());
+                if (aValue == nullptr)
+                {
+                    return 0;
+                }
+
+                if (!iBounds.contains(aValue, 2 * sizeof(uint16_t)))
+                {
+                    throw exception::Exception("prp2 chunk filename exceeds the chunk.");
+                }
+                return iFilename.getFileId();
+            }
+
+            // Chunks of a tile get their chunkFlags, the versions differ by the surface data they carry
+            template <typename Chunk>
+            void readSurfaces(const anstructs::Bounds &iBounds, const Chunk &iChunk, const uint8_t *&opSurfaceIndices,
+                              uint32_t &oNbOfSurfaceIndices, const uint8_t *&opSurfaceTokens, uint32_t &oNbOfSurfaceTokens,
+                              const uint8_t *&opTileTable, uint32_t &oNbOfTileTableBytes,
+                              decltype(std::declval<Chunk>().surfaceIndexArray()) * = nullptr)
+            {
+                auto aIndexArray = iChunk.surfaceIndexArray();
+                auto aTokenArray = iChunk.surfaceTokenArray();
+                checkArray(iBounds, aIndexArray, "trn chunk surface array exceeds the chunk.");
+                checkArray(iBounds, aTokenArray, "trn chunk surface array exceeds the chunk.");
+
+                opSurfaceIndices = aIndexArray.getElements();
+                oNbOfSurfaceIndices = aIndexArray.size();
+                opSurfaceTokens = aTokenArray.getElements();
+                oNbOfSurfaceTokens = aTokenArray.size();
+                opTileTable = nullptr;
+                oNbOfTileTableBytes = 0;
+            }
+
+            template <typename Chunk>
+            void readSurfaces(const anstructs::Bounds &iBounds, const Chunk &iChunk, const uint8_t *&opSurfaceIndices,
+                              uint32_t &oNbOfSurfaceIndices, const uint8_t *&opSurfaceTokens, uint32_t &oNbOfSurfaceTokens,
+                              const uint8_t *&opTileTable, uint32_t &oNbOfTileTableBytes,
+                              decltype(std::declval<Chunk>().tileTableArray()) * = nullptr)
+            {
+                auto aTableArray = iChunk.tileTableArray();
+                checkArray(iBounds, aTableArray, "trn chunk tile table exceeds the chunk.");
+
+                opSurfaceIndices = nullptr;
+                oNbOfSurfaceIndices = 0;
+                opSurfaceTokens = nullptr;
+                oNbOfSurfaceTokens = 0;
+                opTileTable = aTableArray.getElements();
+                oNbOfTileTableBytes = aTableArray.size();
+            }
+
+            // Tiles are laid out on a grid, each tile holding a square block of the height map. Depending on
+            // how dims is expressed, neighbouring tiles share their border samples or not.
+            void computeTileGrid(MapReader::TerrainInfo &ioInfo)
+            {
+                ioInfo.nbOfTilesX = ioInfo.nbOfTiles;
+                ioInfo.nbOfTilesY = ioInfo.nbOfTiles == 0 ? 0 : 1;
+
+                uint32_t aSide = static_cast<uint32_t>(std::sqrt(static_cast<double>(ioInfo.nbOfHeightsPerTile)) + 0.5);
+                ioInfo.tileSide = aSide * aSide == ioInfo.nbOfHeightsPerTile ? aSide : 0;
+
+                if (ioInfo.nbOfTiles == 0)
+                {
+                    return;
+                }
+
+                if (uint64_t(ioInfo.dims[0]) * ioInfo.dims[1] == ioInfo.nbOfTiles)
+                {
+                    ioInfo.nbOfTilesX = ioInfo.dims[0];
+                    ioInfo.nbOfTilesY = ioInfo.dims[1];
+                    return;
+                }
+
+                if (ioInfo.tileSide < 2)
+                {
+                    return;
+                }
+
+                const uint32_t aStepTab[] = {ioInfo.tileSide - 1, ioInfo.tileSide};
+                for (uint32_t aStep : aStepTab)
+                {
+                    if (ioInfo.dims[0] % aStep == 0 && ioInfo.dims[1] % aStep == 0 &&
+                        uint64_t(ioInfo.dims[0] / aStep) * (ioInfo.dims[1] / aStep) == ioInfo.nbOfTiles)
+                    {
+                        ioInfo.nbOfTilesX = ioInfo.dims[0] / aStep;
+                        ioInfo.nbOfTilesY = ioInfo.dims[1] / aStep;
+                        return;
+                    }
+                }
+            }
+
+            template <typename Array>
+            void indexProps(const anstructs::Bounds &iBounds, const Array &iArray, MapReader::PropKind iKind, std::vector<MapReader::Prop> &ioPropVect)
+            {
+                checkArray(iBounds, iArray, "prp2 chunk prop array exceeds the chunk.");
+
+                for (uint32_t aRecordIndex = 0; aRecordIndex < iArray.size(); ++aRecordIndex)
+                {
+                    auto aRecord = iArray[aRecordIndex];
+
+                    MapReader::Prop aProp;
+                    aProp.kind = iKind;
+                    aProp.recordIndex = aRecordIndex;
+                    aProp.fileId = readFileId(iBounds, aRecord.filename());
+                    aProp.guid = aRecord.guid();
+                    memcpy(aProp.position, aRecord.position().data, sizeof(aProp.position));
+                    memcpy(aProp.rotation, aRecord.rotation().data, sizeof(aProp.rotation));
+                    aProp.scale = aRecord.scale();
+                    aProp.flags = aRecord.flags();
+                    ioPropVect.push_back(aProp);
+                }
+            }
+
+            // Instanced records are placed once per transform, the overloads taking a long are picked
+            // for the versions without instanced or meta records
+            template <typename Root>
+            auto indexInstanceProps(const anstructs::Bounds &iBounds, const Root &iRoot, std::vector<MapReader::Prop> &ioPropVect, int)
+                -> decltype(iRoot.propInstanceArray(), void())
+            {
+                auto aArray = iRoot.propInstanceArray();
+                checkArray(iBounds, aArray, "prp2 chunk prop array exceeds the chunk.");
+
+                for (uint32_t aRecordIndex = 0; aRecordIndex < aArray.size(); ++aRecordIndex)
+                {
+                    auto aRecord = aArray[aRecordIndex];
+                    auto aTransformArray = aRecord.transforms();
+                    checkArray(iBounds, aTransformArray, "prp2 chunk transform array exceeds the chunk.");
+
+                    uint32_t aFileId = readFileId(iBounds, aRecord.filename());
+                    for (uint32_t aTransformIndex = 0; aTransformIndex < aTransformArray.size(); ++aTransformIndex)
+                    {
+                        auto aTransform = aTransformArray[aTransformIndex];
+
+                        MapReader::Prop aProp;
+                        aProp.kind = MapReader::PK_INSTANCE;
+                        aProp.recordIndex = aRecordIndex;
+                        aProp.fileId = aFileId;
+                        aProp.guid = aRecord.guid();
+                        memcpy(aProp.position, aTransform.position().data, sizeof(aProp.position));
+                        memcpy(aProp.rotation, aTransform.rotation().data, sizeof(aProp.rotation));
+                        aProp.scale = aTransform.scale();
+                        aProp.flags = aRecord.flags();
+                        ioPropVect.push_back(aProp);
+                    }
+                }
+            }
+
+            template <typename Root>
+            void indexInstanceProps(const anstructs::Bounds &, const Root &, std::vector<MapReader::Prop> &, long)
+            {
+            }
+
+            template <typename Root>
+            auto indexMetaProps(const anstructs::Bounds &iBounds, const Root &iRoot, std::vector<MapReader::Prop> &ioPropVect, int)
+                -> decltype(iRoot.propMetaArray(), void())
+            {
+                indexProps(iBounds, iRoot.propMetaArray(), MapReader::PK_META, ioPropVect);
+            }
+
+            template <typename Root>
+            void indexMetaProps(const anstructs::Bounds &, const Root &, std::vector<MapReader::Prop> &, long)
+            {
+            }
+
+            struct TerrainVisitor
+            {
+                const anstructs::Bounds &bounds;
+                MapReader::TerrainInfo &info;
+                const uint8_t *&pHeights;
+                const uint8_t *&pTileFlags;
+                uint32_t &nbOfTileFlagsPerTile;
+                std::vector<MapReader::TileRecord> &tileRecordVect;
+
+                template <typename Root>
+                void operator()(const Root &iRoot) const
+                {
+                    if (!bounds.contains(iRoot.getData(), Root::structSize))
+                    {
+                        throw exception::Exception("trn chunk exceeds its data.");
+                    }
+
+                    auto aHeightArray = iRoot.heightMapArray();
+                    auto aTileFlagArray = iRoot.tileFlagArray();
+                    auto aChunkArray = iRoot.chunkArray();
+                    checkArray(bounds, aHeightArray, "trn chunk height map exceeds the chunk.");
+                    checkArray(bounds, aTileFlagArray, "trn chunk tile flags exceed the chunk.");
+                    checkArray(bounds, aChunkArray, "trn chunk tile array exceeds the chunk.");
+
+                    anstructs::Dword2 aDims = iRoot.dims();
+                    info.hasTerrain = true;
+                    info.dims[0] = aDims.data[0];
+                    info.dims[1] = aDims.data[1];
+                    info.swapDistance = iRoot.swapDistance();
+                    info.nbOfTiles = aChunkArray.size();
+
+                    if (info.nbOfTiles != 0)
+                    {
+                        if (aHeightArray.size() % info.nbOfTiles != 0 || aTileFlagArray.size() % info.nbOfTiles != 0)
+                        {
+                            throw exception::Exception("trn chunk height map does not split into its tiles.");
+                        }
+                        info.nbOfHeightsPerTile = aHeightArray.size() / info.nbOfTiles;
+                        nbOfTileFlagsPerTile = aTileFlagArray.size() / info.nbOfTiles;
+                    }
+                    computeTileGrid(info);
+
+                    pHeights = aHeightArray.getElements();
+                    pTileFlags = aTileFlagArray.getElements();
+
+                    tileRecordVect.resize(info.nbOfTiles);
+                    for (uint32_t aTileIndex = 0; aTileIndex < info.nbOfTiles; ++aTileIndex)
+                    {
+                        auto aChunk = aChunkArray[aTileIndex];
+                        MapReader::TileRecord &aRecord = tileRecordVect[aTileIndex];
+                        aRecord.chunkFlags = aChunk.chunkFlags();
+                        readSurfaces(bounds, aChunk, aRecord.pSurfaceIndices, aRecord.nbOfSurfaceIndices, aRecord.pSurfaceTokens,
+                                     aRecord.nbOfSurfaceTokens, aRecord.pTileTable, aRecord.nbOfTileTableBytes);
+                    }
+                }
+            };
+
+            struct PropVisitor
+            {
+                const anstructs::Bounds &bounds;
+                std::vector<MapReader::Prop> &propVect;
+
+                template <typename Root>
+                void operator()(const Root &iRoot) const
+                {
+                    if (!bounds.contains(iRoot.getData(), Root::structSize))
+                    {
+                        throw exception::Exception("prp2 chunk exceeds its data.");
+                    }
+
+                    indexProps(bounds, iRoot.propArray(), MapReader::PK_STATIC, propVect);
+                    indexProps(bounds, iRoot.propAnimArray(), MapReader::PK_ANIMATED, propVect);
+                    indexInstanceProps(bounds, iRoot, propVect, 0);
+                    indexMetaProps(bounds, iRoot, propVect, 0);
+                }
+            };
+
+        } // namespace
+
+        MapReader::MapReader(std::vector<uint8_t> iContent, uint32_t iTileCacheCapacity)
+            : _content(std::move(iContent)),
+              _packFile(checkContentSize(_content), _content.data()),
+              _pHeights(nullptr),
+              _pTileFlags(nullptr),
+              _nbOfTileFlagsPerTile(0),
+              _tileCacheCapacity(iTileCacheCapacity)
+        {
+            memset(&_terrainInfo, 0, sizeof(_terrainInfo));
+
+            const format::PackFileView::Chunk *pTerrainChunk = _packFile.findChunk(anstructs::trn_PackMapTerrain::Magic);
+            if (pTerrainChunk != nullptr)
+            {
+                anstructs::Bounds aBounds(pTerrainChunk->data, pTerrainChunk->dataSize);
+                TerrainVisitor aVisitor{aBounds, _terrainInfo, _pHeights, _pTileFlags, _nbOfTileFlagsPerTile, _tileRecordVect};
+                if (!anstructs::trn_PackMapTerrain::dispatch(*pTerrainChunk, aVisitor))
+                {
+                    throw exception::Exception("Unsupported trn chunk version.");
+                }
+            }
+
+            const format::PackFileView::Chunk *pPropChunk = _packFile.findChunk(anstructs::prp2_PackMapProp::Magic);
+            if (pPropChunk != nullptr)
+            {
+                anstructs::Bounds aBounds(pPropChunk->data, pPropChunk->dataSize);
+                if (!anstructs::prp2_PackMapProp::dispatch(*pPropChunk, PropVisitor{aBounds, _propVect}))
+                {
+                    throw exception::Exception("Unsupported prp2 chunk version.");
+                }
+            }
+        }
+
+        const format::PackFileView &MapReader::getPackFile() const
+        {
+            return _packFile;
+        }
+
+        const MapReader::TerrainInfo &MapReader::getTerrainInfo() const
+        {
+            return _terrainInfo;
+        }
+
+        const std::vector<MapReader::Prop> &MapReader::getPropVect() const
+        {
+            return _propVect;
+        }
+
+        std::vector<uint32_t> MapReader::findProps(const float iMin[3], const float iMax[3]) const
+        {
+            std::vector<uint32_t> aIndexVect;
+
+            for (uint32_t aPropIndex = 0; aPropIndex < _propVect.size(); ++aPropIndex)
+            {
+                const float *aPosition = _propVect[aPropIndex].position;
+                if (aPosition[0] >= iMin[0] && aPosition[0] <= iMax[0] &&
+                    aPosition[1] >= iMin[1] && aPosition[1] <= iMax[1] &&
+                    aPosition[2] >= iMin[2] && aPosition[2] <= iMax[2])
+                {
+                    aIndexVect.push_back(aPropIndex);
+                }
+            }
+
+            return aIndexVect;
+        }
+
+        std::shared_ptr<const MapReader::TerrainTile> MapReader::getTile(uint32_t iIndex)
+        {
+            if (iIndex >= _tileRecordVect.size())
+            {
+                throw exception::Exception("Terrain tile index out of range.");
+            }
+
+            {
+                std::lock_guard<std::mutex> aLock(_tileCacheMutex);
+                auto itCachedTile = _tileCacheMap.find(iIndex);
+                if (itCachedTile != _tileCacheMap.end())
+                {
+                    _tileCacheList.splice(_tileCacheList.begin(), _tileCacheList, itCachedTile->second);
+                    return *itCachedTile->second;
+                }
+            }
+
+            // Decoded without holding the lock so that other tiles can be served meanwhile
+            std::shared_ptr<const TerrainTile> aTile = decodeTile(iIndex);
+            if (_tileCacheCapacity == 0)
+            {
+                return aTile;
+            }
+
+            std::lock_guard<std::mutex> aLock(_tileCacheMutex);
+            auto itCachedTile = _tileCacheMap.find(iIndex);
+            if (itCachedTile != _tileCacheMap.end())
+            {
+                // Another thread decoded the same tile first
+                _tileCacheList.splice(_tileCacheList.begin(), _tileCacheList, itCachedTile->second);
+                return *itCachedTile->second;
+            }
+
+            if (_tileCacheList.size() >= _tileCacheCapacity)
+            {
+                _tileCacheMap.erase(_tileCacheList.back()->index);
+                _tileCacheList.pop_back();
+            }
+
+            _tileCacheList.push_front(aTile);
+            _tileCacheMap[iIndex] = _tileCacheList.begin();
+            return aTile;
+        }
+
+        std::shared_ptr<const MapReader::TerrainTile> MapReader::getTile(uint32_t iX, uint32_t iY)
+        {
+            if (iX >= _terrainInfo.nbOfTilesX || iY >= _terrainInfo.nbOfTilesY)
+            {
+                throw exception::Exception("Terrain tile coordinates out of range.");
+            }
+            return getTile(iY * _terrainInfo.nbOfTilesX + iX);
+        }
+
+        uint32_t MapReader::getNbOfCachedTiles() const
+        {
+            std::lock_guard<std::mutex> aLock(_tileCacheMutex);
+            return static_cast<uint32_t>(_tileCacheList.size());
+        }
+
+        std::shared_ptr<const MapReader::TerrainTile> MapReader::decodeTile(uint32_t iIndex) const
+        {
+            const TileRecord &aRecord = _tileRecordVect[iIndex];
+
+            std::shared_ptr<TerrainTile> aTile = std::make_shared<TerrainTile>();
+            aTile->index = iIndex;
+            aTile->chunkFlags = aRecord.chunkFlags;
+
+            // The content is not guaranteed to be aligned, values are copied out bytewise
+            const uint32_t aNbOfHeights = _terrainInfo.nbOfHeightsPerTile;
+            aTile->heights.resize(aNbOfHeights);
+            if (aNbOfHeights != 0)
+            {
+                memcpy(aTile->heights.data(), _pHeights + uint64_t(iIndex) * aNbOfHeights * sizeof(float), aNbOfHeights * sizeof(float));
+                auto aMinMax = std::minmax_element(aTile->heights.begin(), aTile->heights.end());
+                aTile->minHeight = *aMinMax.first;
+                aTile->maxHeight = *aMinMax.second;
+            }
+            else
+            {
+                aTile->minHeight = 0.0f;
+                aTile->maxHeight = 0.0f;
+            }
+
+            aTile->tileFlags.resize(_nbOfTileFlagsPerTile);
+            if (_nbOfTileFlagsPerTile != 0)
+            {
+                memcpy(aTile->tileFlags.data(), _pTileFlags + uint64_t(iIndex) * _nbOfTileFlagsPerTile * sizeof(uint32_t),
+                       _nbOfTileFlagsPerTile * sizeof(uint32_t));
+            }
+
+            aTile->surfaceIndices.resize(aRecord.nbOfSurfaceIndices);
+            if (aRecord.nbOfSurfaceIndices != 0)
+            {
+                memcpy(aTile->surfaceIndices.data(), aRecord.pSurfaceIndices, aRecord.nbOfSurfaceIndices * sizeof(uint16_t));
+            }
+
+            aTile->surfaceTokens.resize(aRecord.nbOfSurfaceTokens);
+            if (aRecord.nbOfSurfaceTokens != 0)
+            {
+                memcpy(aTile->surfaceTokens.data(), aRecord.pSurfaceTokens, aRecord.nbOfSurfaceTokens * sizeof(uint64_t));
+            }
+
+            aTile->tileTable.assign(aRecord.pTileTable, aRecord.pTileTable + aRecord.nbOfTileTableBytes);
+
+            return aTile;
+        }
+
+    } // namespace map
+} // namespace gw2dt
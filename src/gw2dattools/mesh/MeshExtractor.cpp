@@ -0,0 +1,288 @@
+#include "gw2dattools/mesh/MeshExtractor.h"
+
+#include <cstring>
+
+#include "gw2dattools/anstructs/GEOM_ModelFileGeometry.h"
+#include "gw2dattools/exception/Exception.h"
+
+#include "vertexKernels.h"
+
+namespace gw2dt
+{
+    namespace mesh
+    {
+
+        namespace
+        {
+
+            struct AttributeSize
+            {
+                uint32_t flag;
+                uint32_t size;
+            };
+
+            // Attributes other than the UVs, in storage order
+            const AttributeSize sLeadingAttributeSizes[] = {
+                {VFF_POSITION, 12},
+                {VFF_WEIGHTS, 4},
+                {VFF_GROUP, 4},
+                {VFF_NORMAL, 12},
+                {VFF_COLOR, 4},
+                {VFF_TANGENT, 12},
+                {VFF_BITANGENT, 12},
+                {VFF_TANGENT_FRAME, 12},
+            };
+
+            const AttributeSize sTrailingAttributeSizes[] = {
+                {VFF_UNKNOWN1, 48},
+                {VFF_UNKNOWN2, 4},
+                {VFF_UNKNOWN3, 4},
+                {VFF_UNKNOWN4, 16},
+                {VFF_POSITION_COMPRESSED, 6},
+                {VFF_UNKNOWN5, 12},
+            };
+
+            const uint32_t sKnownFlags = 0x3FFFFFFF;
+
+            template <typename ArrayType>
+            void checkArray(const anstructs::Bounds &iBounds, const ArrayType &iArray, uint64_t iElementSize)
+            {
+                if (!iBounds.contains(iArray.getData(), ArrayType::structSize) ||
+                    (iArray.size() != 0 && !iBounds.contains(iArray.getElements(), iArray.size() * iElementSize)))
+                {
+                    throw exception::Exception("GEOM chunk array exceeds the chunk.");
+                }
+            }
+
+            template <typename Root>
+            void extractGeometryMeshes(const Root &iRoot, const anstructs::Bounds &iBounds, std::vector<Mesh> &oMeshVect)
+            {
+                auto aMeshArray = iRoot.meshes();
+                checkArray(iBounds, aMeshArray, sizeof(anstructs::PointerOffset));
+
+                for (uint32_t aMeshIndex = 0; aMeshIndex < aMeshArray.size(); ++aMeshIndex)
+                {
+                    auto aMeshPtr = aMeshArray[aMeshIndex];
+                    if (aMeshPtr.isNull())
+                    {
+                        continue;
+                    }
+
+                    auto aMeshData = aMeshPtr.get();
+                    if (!iBounds.contains(aMeshData.getData(), decltype(aMeshData)::structSize))
+                    {
+                        throw exception::Exception("GEOM chunk mesh exceeds the chunk.");
+                    }
+
+                    auto aGeometryPtr = aMeshData.geometry();
+                    if (aGeometryPtr.isNull())
+                    {
+                        continue;
+                    }
+
+                    auto aGeometry = aGeometryPtr.get();
+                    if (!iBounds.contains(aGeometry.getData(), decltype(aGeometry)::structSize))
+                    {
+                        throw exception::Exception("GEOM chunk geometry exceeds the chunk.");
+                    }
+
+                    auto aVertexData = aGeometry.verts();
+                    auto aVertexArray = aVertexData.mesh().vertices();
+                    checkArray(iBounds, aVertexArray, sizeof(uint8_t));
+
+                    auto aIndexArray = aGeometry.indices().indices();
+                    checkArray(iBounds, aIndexArray, sizeof(uint16_t));
+
+                    Mesh aMesh;
+                    aMesh.materialIndex = aMeshData.materialIndex();
+                    aMesh.vertexFormatFlags = aVertexData.mesh().fvf();
+
+                    VertexLayout aLayout = decodeVertexFormat(aMesh.vertexFormatFlags);
+                    extractVertices(aLayout, aVertexData.vertexCount(), aVertexArray.size(), aVertexArray.getElements(), aMesh.vertices);
+
+                    aMesh.indices.resize(aIndexArray.size());
+                    if (!aMesh.indices.empty())
+                    {
+                        memcpy(aMesh.indices.data(), aIndexArray.getElements(), aMesh.indices.size() * sizeof(uint16_t));
+                    }
+
+                    oMeshVect.push_back(std::move(aMesh));
+                }
+            }
+
+            struct GeometryVisitor
+            {
+                const anstructs::Bounds &bounds;
+                std::vector<Mesh> &meshVect;
+
+                template <typename Root>
+                void operator()(const Root &iRoot) const
+                {
+                    extractGeometryMeshes(iRoot, bounds, meshVect);
+                }
+            };
+
+        } // namespace
+
+        GW2DATTOOLS_API VertexLayout GW2DATTOOLS_APIENTRY decodeVertexFormat(uint32_t iFlags)
+        {
+            if ((iFlags & ~sKnownFlags) != 0)
+            {
+                throw exception::Exception("Unknown vertex format flags.");
+            }
+
+            VertexLayout aLayout;
+            memset(&aLayout, 0, sizeof(aLayout));
+            aLayout.flags = iFlags;
+
+            uint32_t aOffset = 0;
+
+            for (const AttributeSize &aAttribute : sLeadingAttributeSizes)
+            {
+                if (iFlags & aAttribute.flag)
+                {
+                    if (aAttribute.flag == VFF_POSITION)
+                    {
+                        aLayout.hasPosition = true;
+                        aLayout.positionOffset = aOffset;
+                    }
+                    else if (aAttribute.flag == VFF_NORMAL)
+                    {
+                        aLayout.hasNormal = true;
+                        aLayout.normalOffset = aOffset;
+                    }
+                    aOffset += aAttribute.size;
+                }
+            }
+
+            for (uint32_t aBit = 0; aBit < 8; ++aBit)
+            {
+                if (iFlags & (VFF_UV32_MASK & (0x100u << aBit)))
+                {
+                    aLayout.uvOffsets[aLayout.nbOfUvSets] = aOffset;
+                    aLayout.isUvHalf[aLayout.nbOfUvSets] = false;
+                    ++aLayout.nbOfUvSets;
+                    aOffset += 2 * sizeof(float);
+                }
+            }
+
+            for (uint32_t aBit = 0; aBit < 8; ++aBit)
+            {
+                if (iFlags & (VFF_UV16_MASK & (0x10000u << aBit)))
+                {
+                    aLayout.uvOffsets[aLayout.nbOfUvSets] = aOffset;
+                    aLayout.isUvHalf[aLayout.nbOfUvSets] = true;
+                    ++aLayout.nbOfUvSets;
+                    aOffset += 2 * sizeof(uint16_t);
+                }
+            }
+
+            for (const AttributeSize &aAttribute : sTrailingAttributeSizes)
+            {
+                if (iFlags & aAttribute.flag)
+                {
+                    // The full precision position wins when both are present
+                    if (aAttribute.flag == VFF_POSITION_COMPRESSED && !aLayout.hasPosition)
+                    {
+                        aLayout.hasPosition = true;
+                        aLayout.isPositionCompressed = true;
+                        aLayout.positionOffset = aOffset;
+                    }
+                    aOffset += aAttribute.size;
+                }
+            }
+
+            aLayout.vertexSize = aOffset;
+            return aLayout;
+        }
+
+        GW2DATTOOLS_API void GW2DATTOOLS_APIENTRY extractVertices(const VertexLayout &iLayout,
+                                                                  uint32_t iNbVertices,
+                                                                  uint32_t iSize,
+                                                                  const uint8_t *iVertices,
+                                                                  VertexStreams &oStreams)
+        {
+            if (static_cast<uint64_t>(iNbVertices) * iLayout.vertexSize > iSize)
+            {
+                throw exception::Exception("Vertex buffer is too small for its vertices.");
+            }
+
+            if (iNbVertices != 0 && (iVertices == nullptr || iLayout.vertexSize == 0))
+            {
+                throw exception::Exception("Vertex buffer is null.");
+            }
+
+            oStreams.nbOfVertices = iNbVertices;
+
+            for (uint32_t aComponent = 0; aComponent < 3; ++aComponent)
+            {
+                oStreams.positions[aComponent].assign(iLayout.hasPosition ? iNbVertices : 0, 0.0f);
+                oStreams.normals[aComponent].assign(iLayout.hasNormal ? iNbVertices : 0, 0.0f);
+            }
+            oStreams.uvSets.resize(iLayout.nbOfUvSets);
+
+            if (iNbVertices == 0)
+            {
+                return;
+            }
+
+            if (iLayout.hasPosition)
+            {
+                const uint8_t *pPositions = iVertices + iLayout.positionOffset;
+                if (iLayout.isPositionCompressed)
+                {
+                    kernels::deinterleaveHalf3(pPositions, iLayout.vertexSize, iNbVertices,
+                                               oStreams.positions[0].data(), oStreams.positions[1].data(), oStreams.positions[2].data());
+                }
+                else
+                {
+                    kernels::deinterleaveFloat3(pPositions, iLayout.vertexSize, iNbVertices, iSize - iLayout.positionOffset,
+                                                oStreams.positions[0].data(), oStreams.positions[1].data(), oStreams.positions[2].data());
+                }
+            }
+
+            if (iLayout.hasNormal)
+            {
+                kernels::deinterleaveFloat3(iVertices + iLayout.normalOffset, iLayout.vertexSize, iNbVertices, iSize - iLayout.normalOffset,
+                                            oStreams.normals[0].data(), oStreams.normals[1].data(), oStreams.normals[2].data());
+            }
+
+            for (uint32_t aUvSet = 0; aUvSet < iLayout.nbOfUvSets; ++aUvSet)
+            {
+                VertexStreams::UvSet &aUvStreams = oStreams.uvSets[aUvSet];
+                aUvStreams.u.resize(iNbVertices);
+                aUvStreams.v.resize(iNbVertices);
+
+                const uint8_t *pUvs = iVertices + iLayout.uvOffsets[aUvSet];
+                if (iLayout.isUvHalf[aUvSet])
+                {
+                    kernels::deinterleaveHalf2(pUvs, iLayout.vertexSize, iNbVertices, aUvStreams.u.data(), aUvStreams.v.data());
+                }
+                else
+                {
+                    kernels::deinterleaveFloat2(pUvs, iLayout.vertexSize, iNbVertices, aUvStreams.u.data(), aUvStreams.v.data());
+                }
+            }
+        }
+
+        GW2DATTOOLS_API std::vector<Mesh> GW2DATTOOLS_APIENTRY extractMeshes(const format::PackFileView &iPackFile)
+        {
+            std::vector<Mesh> aMeshVect;
+
+            const format::PackFileView::Chunk *pChunk = iPackFile.findChunk(anstructs::GEOM_ModelFileGeometry::Magic);
+            if (pChunk == nullptr)
+            {
+                return aMeshVect;
+            }
+
+            anstructs::Bounds aBounds(pChunk->data, pChunk->dataSize);
+            if (!anstructs::GEOM_ModelFileGeometry::dispatch(*pChunk, GeometryVisitor{aBounds, aMeshVect}))
+            {
+                throw exception::Exception("Unsupported GEOM chunk version.");
+            }
+
+            return aMeshVect;
+        }
+
+    } // namespace mesh
+} // namespace gw2dt
@@ -0,0 +1,223 @@
+#ifndef GW2DATTOOLS_MESH_VERTEXKERNELS_H
+#define GW2DATTOOLS_MESH_VERTEXKERNELS_H
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GW2DATTOOLS_MESH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace gw2dt
+{
+    namespace mesh
+    {
+        namespace kernels
+        {
+
+            // Converts an IEEE 754 half-precision value, denormals, infinities and NaNs included
+            inline float halfToFloat(uint16_t iHalf)
+            {
+                const uint32_t aShiftedExponent = 0x7C00u << 13;
+
+                uint32_t aBits = (iHalf & 0x7FFFu) << 13;
+                uint32_t aExponent = aBits & aShiftedExponent;
+                aBits += (127u - 15u) << 23;
+
+                float aValue;
+                if (aExponent == aShiftedExponent)
+                {
+                    aBits += (128u - 16u) << 23;
+                    memcpy(&aValue, &aBits, sizeof(aValue));
+                }
+                else if (aExponent == 0)
+                {
+                    // Denormal, renormalized by the FPU
+                    aBits += 1u << 23;
+                    const uint32_t aMagicBits = 113u << 23;
+                    float aMagic;
+                    memcpy(&aValue, &aBits, sizeof(aValue));
+                    memcpy(&aMagic, &aMagicBits, sizeof(aMagic));
+                    aValue -= aMagic;
+                }
+                else
+                {
+                    memcpy(&aValue, &aBits, sizeof(aValue));
+                }
+
+                uint32_t aSignedBits;
+                memcpy(&aSignedBits, &aValue, sizeof(aSignedBits));
+                aSignedBits |= static_cast<uint32_t>(iHalf & 0x8000u) << 16;
+                memcpy(&aValue, &aSignedBits, sizeof(aValue));
+                return aValue;
+            }
+
+#ifdef GW2DATTOOLS_MESH_SSE2
+            // Same as halfToFloat on four halves held in the low 16 bits of each lane
+            inline __m128 halfToFloat4(__m128i iHalves)
+            {
+                const __m128i aShiftedExponent = _mm_set1_epi32(0x7C00 << 13);
+
+                __m128i aSign = _mm_slli_epi32(_mm_and_si128(iHalves, _mm_set1_epi32(0x8000)), 16);
+                __m128i aBits = _mm_slli_epi32(_mm_and_si128(iHalves, _mm_set1_epi32(0x7FFF)), 13);
+                __m128i aExponent = _mm_and_si128(aBits, aShiftedExponent);
+                aBits = _mm_add_epi32(aBits, _mm_set1_epi32((127 - 15) << 23));
+
+                __m128i isInfOrNan = _mm_cmpeq_epi32(aExponent, aShiftedExponent);
+                aBits = _mm_add_epi32(aBits, _mm_and_si128(isInfOrNan, _mm_set1_epi32((128 - 16) << 23)));
+
+                __m128i isDenormal = _mm_cmpeq_epi32(aExponent, _mm_setzero_si128());
+                __m128 aDenormal = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(aBits, _mm_set1_epi32(1 << 23))),
+                                              _mm_castsi128_ps(_mm_set1_epi32(113 << 23)));
+                aBits = _mm_or_si128(_mm_andnot_si128(isDenormal, aBits), _mm_and_si128(isDenormal, _mm_castps_si128(aDenormal)));
+
+                return _mm_castsi128_ps(_mm_or_si128(aBits, aSign));
+            }
+
+            inline __m128i loadHalfPairs(const uint8_t *iData, uint32_t iStride)
+            {
+                uint32_t aPairs[4];
+                memcpy(&aPairs[0], iData, sizeof(uint32_t));
+                memcpy(&aPairs[1], iData + iStride, sizeof(uint32_t));
+                memcpy(&aPairs[2], iData + 2 * iStride, sizeof(uint32_t));
+                memcpy(&aPairs[3], iData + 3 * iStride, sizeof(uint32_t));
+                return _mm_loadu_si128(reinterpret_cast<const __m128i *>(aPairs));
+            }
+#endif
+
+            /**
+             * De-interleaves a float3 attribute of iNbVertices vertices.
+             * @param iData Address of the attribute in the first vertex.
+             * @param iStride Size of a vertex.
+             * @param iNbReadable Number of bytes readable from iData, 16-byte loads are used when it allows.
+             */
+            inline void deinterleaveFloat3(const uint8_t *iData, uint32_t iStride, uint32_t iNbVertices, uint64_t iNbReadable,
+                                           float *oX, float *oY, float *oZ)
+            {
+                uint32_t aIndex = 0;
+
+#ifdef GW2DATTOOLS_MESH_SSE2
+                // Vertices which can be read with a 16-byte load, the fourth float belongs to the next attribute
+                uint64_t aNbWideVertices = iNbReadable < 16 ? 0 : (iNbReadable - 16) / iStride + 1;
+                if (aNbWideVertices > iNbVertices)
+                {
+                    aNbWideVertices = iNbVertices;
+                }
+
+                for (; aIndex + 4 <= aNbWideVertices; aIndex += 4)
+                {
+                    const uint8_t *pVertex = iData + static_cast<uint64_t>(aIndex) * iStride;
+                    __m128 aRow0 = _mm_loadu_ps(reinterpret_cast<const float *>(pVertex));
+                    __m128 aRow1 = _mm_loadu_ps(reinterpret_cast<const float *>(pVertex + iStride));
+                    __m128 aRow2 = _mm_loadu_ps(reinterpret_cast<const float *>(pVertex + 2 * iStride));
+                    __m128 aRow3 = _mm_loadu_ps(reinterpret_cast<const float *>(pVertex + 3 * iStride));
+                    _MM_TRANSPOSE4_PS(aRow0, aRow1, aRow2, aRow3);
+                    _mm_storeu_ps(oX + aIndex, aRow0);
+                    _mm_storeu_ps(oY + aIndex, aRow1);
+                    _mm_storeu_ps(oZ + aIndex, aRow2);
+                }
+#else
+                (void)iNbReadable;
+#endif
+
+                for (; aIndex < iNbVertices; ++aIndex)
+                {
+                    float aVector[3];
+                    memcpy(aVector, iData + static_cast<uint64_t>(aIndex) * iStride, sizeof(aVector));
+                    oX[aIndex] = aVector[0];
+                    oY[aIndex] = aVector[1];
+                    oZ[aIndex] = aVector[2];
+                }
+            }
+
+            // De-interleaves a float2 attribute
+            inline void deinterleaveFloat2(const uint8_t *iData, uint32_t iStride, uint32_t iNbVertices, float *oU, float *oV)
+            {
+                uint32_t aIndex = 0;
+
+#ifdef GW2DATTOOLS_MESH_SSE2
+                for (; aIndex + 4 <= iNbVertices; aIndex += 4)
+                {
+                    const uint8_t *pVertex = iData + static_cast<uint64_t>(aIndex) * iStride;
+                    __m128 aLow = _mm_castsi128_ps(_mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pVertex)),
+                                                                      _mm_loadl_epi64(reinterpret_cast<const __m128i *>(pVertex + iStride))));
+                    __m128 aHigh = _mm_castsi128_ps(_mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pVertex + 2 * iStride)),
+                                                                       _mm_loadl_epi64(reinterpret_cast<const __m128i *>(pVertex + 3 * iStride))));
+                    _mm_storeu_ps(oU + aIndex, _mm_shuffle_ps(aLow, aHigh, _MM_SHUFFLE(2, 0, 2, 0)));
+                    _mm_storeu_ps(oV + aIndex, _mm_shuffle_ps(aLow, aHigh, _MM_SHUFFLE(3, 1, 3, 1)));
+                }
+#endif
+
+                for (; aIndex < iNbVertices; ++aIndex)
+                {
+                    float aVector[2];
+                    memcpy(aVector, iData + static_cast<uint64_t>(aIndex) * iStride, sizeof(aVector));
+                    oU[aIndex] = aVector[0];
+                    oV[aIndex] = aVector[1];
+                }
+            }
+
+            // De-interleaves a half2 attribute into floats
+            inline void deinterleaveHalf2(const uint8_t *iData, uint32_t iStride, uint32_t iNbVertices, float *oU, float *oV)
+            {
+                uint32_t aIndex = 0;
+
+#ifdef GW2DATTOOLS_MESH_SSE2
+                for (; aIndex + 4 <= iNbVertices; aIndex += 4)
+                {
+                    __m128i aPairs = loadHalfPairs(iData + static_cast<uint64_t>(aIndex) * iStride, iStride);
+                    _mm_storeu_ps(oU + aIndex, halfToFloat4(_mm_and_si128(aPairs, _mm_set1_epi32(0xFFFF))));
+                    _mm_storeu_ps(oV + aIndex, halfToFloat4(_mm_srli_epi32(aPairs, 16)));
+                }
+#endif
+
+                for (; aIndex < iNbVertices; ++aIndex)
+                {
+                    uint16_t aVector[2];
+                    memcpy(aVector, iData + static_cast<uint64_t>(aIndex) * iStride, sizeof(aVector));
+                    oU[aIndex] = halfToFloat(aVector[0]);
+                    oV[aIndex] = halfToFloat(aVector[1]);
+                }
+            }
+
+            // De-interleaves a half3 attribute into floats
+            inline void deinterleaveHalf3(const uint8_t *iData, uint32_t iStride, uint32_t iNbVertices, float *oX, float *oY, float *oZ)
+            {
+                uint32_t aIndex = 0;
+
+#ifdef GW2DATTOOLS_MESH_SSE2
+                for (; aIndex + 4 <= iNbVertices; aIndex += 4)
+                {
+                    const uint8_t *pVertex = iData + static_cast<uint64_t>(aIndex) * iStride;
+                    __m128i aPairs = loadHalfPairs(pVertex, iStride);
+
+                    uint32_t aThirds[4];
+                    for (uint32_t aLane = 0; aLane < 4; ++aLane)
+                    {
+                        uint16_t aThird;
+                        memcpy(&aThird, pVertex + aLane * iStride + 2 * sizeof(uint16_t), sizeof(aThird));
+                        aThirds[aLane] = aThird;
+                    }
+
+                    _mm_storeu_ps(oX + aIndex, halfToFloat4(_mm_and_si128(aPairs, _mm_set1_epi32(0xFFFF))));
+                    _mm_storeu_ps(oY + aIndex, halfToFloat4(_mm_srli_epi32(aPairs, 16)));
+                    _mm_storeu_ps(oZ + aIndex, halfToFloat4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(aThirds))));
+                }
+#endif
+
+                for (; aIndex < iNbVertices; ++aIndex)
+                {
+                    uint16_t aVector[3];
+                    memcpy(aVector, iData + static_cast<uint64_t>(aIndex) * iStride, sizeof(aVector));
+                    oX[aIndex] = halfToFloat(aVector[0]);
+                    oY[aIndex] = halfToFloat(aVector[1]);
+                    oZ[aIndex] = halfToFloat(aVector[2]);
+                }
+            }
+
+        } // namespace kernels
+    } // namespace mesh
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_MESH_VERTEXKERNELS_H
@@ -31,6 +31,9 @@ namespace gw2dt {
             template <typename OutputType>
             void drop( );
 
+            // Number of bytes of the buffer already loaded, the bits not yet read included
+            uint32_t getNbOfLoadedBytes( ) const;
+
         private:
             template <typename OutputType>
             void readImpl( uint8_t iBitNumber, OutputType& oValue ) const;
@@ -154,6 +154,11 @@ namespace gw2dt {
             drop<sizeof( OutputType ) * 8>( );
         }
 
+        template <typename IntType>
+        uint32_t BitArray<IntType>::getNbOfLoadedBytes( ) const {
+            return static_cast<uint32_t>( _pBufferPos - _pBufferStartPos );
+        }
+
 
     }
 }
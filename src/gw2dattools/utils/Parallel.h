@@ -0,0 +1,83 @@
+#ifndef GW2DATTOOLS_UTILS_PARALLEL_H
+#define GW2DATTOOLS_UTILS_PARALLEL_H
+
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gw2dt
+{
+    namespace utils
+    {
+
+        /**
+         * Returns the number of worker threads to use.
+         * @param iNbThreads Requested number of threads, 0 means one per hardware thread.
+         */
+        inline uint32_t getNbWorkerThreads(uint32_t iNbThreads)
+        {
+            if (iNbThreads == 0)
+            {
+                iNbThreads = std::thread::hardware_concurrency();
+            }
+            return iNbThreads == 0 ? 1 : iNbThreads;
+        }
+
+        /**
+         * Runs a worker function on several threads and waits for all of them.
+         * The first exception thrown by a worker is rethrown once every thread has joined.
+         * @param iNbThreads Number of threads, 0 means one per hardware thread.
+         * @param iWorker Function called as iWorker(uint32_t iThreadIndex) on each thread.
+         */
+        template <typename WorkerFunction>
+        void runWorkers(uint32_t iNbThreads, WorkerFunction iWorker)
+        {
+            iNbThreads = getNbWorkerThreads(iNbThreads);
+
+            std::exception_ptr aFirstException;
+            std::mutex aExceptionMutex;
+
+            auto aGuardedWorker = [&](uint32_t iThreadIndex)
+            {
+                try
+                {
+                    iWorker(iThreadIndex);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> aLock(aExceptionMutex);
+                    if (!aFirstException)
+                    {
+                        aFirstException = std::current_exception();
+                    }
+                }
+            };
+
+            std::vector<std::thread> aThreadVect;
+            aThreadVect.reserve(iNbThreads - 1);
+
+            for (uint32_t aThreadIndex = 1; aThreadIndex < iNbThreads; ++aThreadIndex)
+            {
+                aThreadVect.emplace_back(aGuardedWorker, aThreadIndex);
+            }
+
+            // The calling thread takes its share of the work
+            aGuardedWorker(0);
+
+            for (auto &itThread : aThreadVect)
+            {
+                itThread.join();
+            }
+
+            if (aFirstException)
+            {
+                std::rethrow_exception(aFirstException);
+            }
+        }
+
+    } // namespace utils
+} // namespace gw2dt
+
+#endif // GW2DATTOOLS_UTILS_PARALLEL_H
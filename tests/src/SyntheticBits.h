@@ -0,0 +1,60 @@
+#ifndef GW2DATTOOLS_TESTS_SYNTHETICBITS_H
+#define GW2DATTOOLS_TESTS_SYNTHETICBITS_H
+
+#include <cstdint>
+#include <vector>
+
+namespace synthetic
+{
+
+    // Writes bits from the most significant one, as the decoder reads them
+    class BitWriter
+    {
+    public:
+        explicit BitWriter(std::vector<uint32_t> &ioWordVect) : _wordVect(ioWordVect),
+                                                                _bits(0),
+                                                                _nbBits(0)
+        {
+        }
+
+        void write(uint32_t iValue, uint8_t iNbBits)
+        {
+            for (int32_t aBit = iNbBits - 1; aBit >= 0; --aBit)
+            {
+                _bits = (_bits << 1) | ((iValue >> aBit) & 1);
+                if (++_nbBits == 32)
+                {
+                    push(static_cast<uint32_t>(_bits));
+                    _bits = 0;
+                    _nbBits = 0;
+                }
+            }
+        }
+
+        void flush()
+        {
+            if (_nbBits != 0)
+            {
+                write(0, 32 - _nbBits);
+            }
+        }
+
+        // The decoder skips a word every 0x4000 ones
+        void push(uint32_t iWord)
+        {
+            if ((_wordVect.size() + 1) % 0x4000 == 0)
+            {
+                _wordVect.push_back(0);
+            }
+            _wordVect.push_back(iWord);
+        }
+
+    private:
+        std::vector<uint32_t> &_wordVect;
+        uint64_t _bits;
+        uint8_t _nbBits;
+    };
+
+} // namespace synthetic
+
+#endif // GW2DATTOOLS_TESTS_SYNTHETICBITS_H
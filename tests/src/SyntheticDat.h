@@ -0,0 +1,223 @@
+#ifndef GW2DATTOOLS_TESTS_SYNTHETICDAT_H
+#define GW2DATTOOLS_TESTS_SYNTHETICDAT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "SyntheticBits.h"
+
+namespace synthetic
+{
+
+    // Symbols of the copy sizes follow the 0x100 literals, the last one being the size 0xFF
+    const uint16_t sNbDatSymbols = 0x100 + 29;
+    const uint16_t sNbDatCopySymbols = 34;
+    const uint32_t sDatCodesPerBlock = 0x1000;
+    const uint32_t sMaxDatCopySize = 0xFF;
+    const uint32_t sMaxDatCopyOffset = 0x20000;
+
+    struct HuffmanCode
+    {
+        uint32_t code;
+        uint8_t bits;
+    };
+
+    // Codes of a tree as built by the decoder from its symbols in the order they are added: symbols
+    // are listed by bit length, the last added first, and codes are given in decreasing order within
+    // a length
+    inline std::vector<HuffmanCode> buildCodes(const std::vector<uint16_t> &iSymbolVect, const std::vector<uint8_t> &iBitsVect, uint16_t iNbSymbols)
+    {
+        std::vector<HuffmanCode> aCodeVect(iNbSymbols, HuffmanCode{0, 0});
+
+        uint32_t aCode = 0;
+        for (uint8_t aNbBits = 1; aNbBits < 32; ++aNbBits)
+        {
+            aCode = (aCode << 1) + 1;
+            for (size_t aIndex = iSymbolVect.size(); aIndex-- > 0;)
+            {
+                if (iBitsVect[aIndex] == aNbBits)
+                {
+                    aCodeVect[iSymbolVect[aIndex]] = HuffmanCode{aCode, aNbBits};
+                    --aCode;
+                }
+            }
+        }
+        return aCodeVect;
+    }
+
+    // Codes of the static dictionary the trees of a block are written with
+    inline std::vector<HuffmanCode> buildDatDictionary()
+    {
+        const std::vector<uint16_t> aSymbolVect = {
+            0x0A, 0x09, 0x08, 0x0C, 0x0B, 0x07, 0x00, 0xE0, 0x2A, 0x29, 0x06, 0x4A, 0x40, 0x2C, 0x2B, 0x28,
+            0x20, 0x05, 0x04, 0x49, 0x48, 0x27, 0x26, 0x25, 0x0D, 0x03, 0x6A, 0x69, 0x4C, 0x4B, 0x47, 0x24,
+            0xE8, 0xA0, 0x89, 0x88, 0x68, 0x67, 0x63, 0x60, 0x46, 0x23, 0xE9, 0xC9, 0xC0, 0xA9, 0xA8, 0x8A,
+            0x87, 0x80, 0x66, 0x65, 0x45, 0x44, 0x43, 0x2D, 0x02, 0x01, 0xE5, 0xC8, 0xAA, 0xA5, 0xA4, 0x8B,
+            0x85, 0x84, 0x6C, 0x6B, 0x64, 0x4D, 0x0E, 0xE7, 0xCA, 0xC7, 0xA7, 0xA6, 0x86, 0x83, 0xE6, 0xE4,
+            0xC4, 0x8C, 0x2E, 0x22, 0xEC, 0xC6, 0x6D, 0x4E, 0xEA, 0xCC, 0xAC, 0xAB, 0x8D, 0x11, 0x10, 0x0F,
+            0xFF, 0xFE, 0xFD, 0xFC, 0xFB, 0xFA, 0xF9, 0xF8, 0xF7, 0xF6, 0xF5, 0xF4, 0xF3, 0xF2, 0xF1, 0xF0,
+            0xEF, 0xEE, 0xED, 0xEB, 0xE3, 0xE2, 0xE1, 0xDF, 0xDE, 0xDD, 0xDC, 0xDB, 0xDA, 0xD9, 0xD8, 0xD7,
+            0xD6, 0xD5, 0xD4, 0xD3, 0xD2, 0xD1, 0xD0, 0xCF, 0xCE, 0xCD, 0xCB, 0xC5, 0xC3, 0xC2, 0xC1, 0xBF,
+            0xBE, 0xBD, 0xBC, 0xBB, 0xBA, 0xB9, 0xB8, 0xB7, 0xB6, 0xB5, 0xB4, 0xB3, 0xB2, 0xB1, 0xB0, 0xAF,
+            0xAE, 0xAD, 0xA3, 0xA2, 0xA1, 0x9F, 0x9E, 0x9D, 0x9C, 0x9B, 0x9A, 0x99, 0x98, 0x97, 0x96, 0x95,
+            0x94, 0x93, 0x92, 0x91, 0x90, 0x8F, 0x8E, 0x82, 0x81, 0x7F, 0x7E, 0x7D, 0x7C, 0x7B, 0x7A, 0x79,
+            0x78, 0x77, 0x76, 0x75, 0x74, 0x73, 0x72, 0x71, 0x70, 0x6F, 0x6E, 0x62, 0x61, 0x5F, 0x5E, 0x5D,
+            0x5C, 0x5B, 0x5A, 0x59, 0x58, 0x57, 0x56, 0x55, 0x54, 0x53, 0x52, 0x51, 0x50, 0x4F, 0x42, 0x41,
+            0x3F, 0x3E, 0x3D, 0x3C, 0x3B, 0x3A, 0x39, 0x38, 0x37, 0x36, 0x35, 0x34, 0x33, 0x32, 0x31, 0x30,
+            0x2F, 0x21, 0x1F, 0x1E, 0x1D, 0x1C, 0x1B, 0x1A, 0x19, 0x18, 0x17, 0x16, 0x15, 0x14, 0x13, 0x12};
+        const uint8_t aBitsCountTab[][2] = {{3, 3}, {4, 4}, {5, 4}, {6, 8}, {7, 7}, {8, 6}, {9, 10}, {10, 16},
+                                            {11, 13}, {12, 7}, {13, 6}, {14, 4}, {15, 8}, {16, 160}};
+
+        std::vector<uint8_t> aBitsVect;
+        for (const uint8_t *pBitsCount : aBitsCountTab)
+        {
+            aBitsVect.insert(aBitsVect.end(), pBitsCount[1], pBitsCount[0]);
+        }
+        return buildCodes(aSymbolVect, aBitsVect, 0x100);
+    }
+
+    // Writes a tree where all the symbols have the same bit length, by runs of at most 8 symbols
+    inline std::vector<HuffmanCode> writeTree(BitWriter &ioWriter, const std::vector<HuffmanCode> &iDictionary, uint16_t iNbSymbols, uint8_t iNbBits)
+    {
+        ioWriter.write(iNbSymbols, 16);
+
+        std::vector<uint16_t> aSymbolVect;
+        for (int32_t aRemaining = iNbSymbols; aRemaining > 0;)
+        {
+            uint32_t aRun = std::min(aRemaining, 8);
+            const HuffmanCode &aCode = iDictionary[((aRun - 1) << 5) | iNbBits];
+            ioWriter.write(aCode.code, aCode.bits);
+            for (uint32_t aIndex = 0; aIndex < aRun; ++aIndex)
+            {
+                aSymbolVect.push_back(static_cast<uint16_t>(--aRemaining));
+            }
+        }
+        return buildCodes(aSymbolVect, std::vector<uint8_t>(aSymbolVect.size(), iNbBits), iNbSymbols);
+    }
+
+    // Symbol and extra bits of a value, for the symbols whose quotient by iNbPerGroup doubles the value
+    // range of the group before
+    inline void writeRange(BitWriter &ioWriter, const std::vector<HuffmanCode> &iTree, uint16_t iSymbolBase, uint32_t iNbPerGroup, uint32_t iValue)
+    {
+        uint32_t aSymbol = 0;
+        while (true)
+        {
+            uint32_t aQuot = aSymbol / iNbPerGroup;
+            uint32_t aStart = aQuot == 0 ? aSymbol : (1u << (aQuot - 1)) * (iNbPerGroup + aSymbol % iNbPerGroup);
+            uint8_t aNbExtraBits = static_cast<uint8_t>(aQuot > 1 ? aQuot - 1 : 0);
+            if (iValue >= aStart && iValue - aStart < (1u << aNbExtraBits))
+            {
+                const HuffmanCode &aCode = iTree[iSymbolBase + aSymbol];
+                ioWriter.write(aCode.code, aCode.bits);
+                ioWriter.write(iValue - aStart, aNbExtraBits);
+                return;
+            }
+            ++aSymbol;
+        }
+    }
+
+    /**
+     * Encodes a content as a compressed DAT stream, with copies of at least 4 bytes found by a
+     * greedy search and codes of 9 bits. From iSingleByteCopyPos on, each byte is a copy of a single
+     * byte from as far as possible instead, and the blocks starting there have codes of 31 bits: the
+     * most input a byte of output can take, about 10 bytes.
+     */
+    inline std::vector<uint32_t> encodeDat(const std::vector<uint8_t> &iContent, size_t iSingleByteCopyPos = SIZE_MAX)
+    {
+        const std::vector<HuffmanCode> aDictionary = buildDatDictionary();
+        const uint32_t aCopySizeAdd = 1;
+
+        std::vector<uint32_t> aWordVect;
+        BitWriter aWriter(aWordVect);
+        aWriter.write(0, 32);
+        aWriter.write(static_cast<uint32_t>(iContent.size()), 32);
+        aWriter.write(0, 4);
+        aWriter.write(aCopySizeAdd - 1, 4);
+
+        std::vector<size_t> aFirstPosVect(0x100, SIZE_MAX);
+        std::vector<size_t> aLastPosVect(0x10000, SIZE_MAX);
+
+        size_t aPos = 0;
+        while (aPos < iContent.size())
+        {
+            uint8_t aNbBits = aPos >= iSingleByteCopyPos ? 31 : 9;
+            std::vector<HuffmanCode> aSymbolTree = writeTree(aWriter, aDictionary, sNbDatSymbols, aNbBits);
+            std::vector<HuffmanCode> aCopyTree = writeTree(aWriter, aDictionary, sNbDatCopySymbols, aNbBits);
+            aWriter.write(sDatCodesPerBlock / 0x1000 - 1, 4);
+
+            for (uint32_t aNbCodes = 0; aNbCodes < sDatCodesPerBlock && aPos < iContent.size(); ++aNbCodes)
+            {
+                uint8_t aByte = iContent[aPos];
+
+                size_t aCopySize = 0;
+                size_t aCopyPos = SIZE_MAX;
+                if (aPos >= iSingleByteCopyPos)
+                {
+                    aCopyPos = aFirstPosVect[aByte];
+                    if (aCopyPos != SIZE_MAX && aPos - aCopyPos > sMaxDatCopyOffset)
+                    {
+                        aCopyPos = aPos - sMaxDatCopyOffset;
+                        while (iContent[aCopyPos] != aByte)
+                        {
+                            ++aCopyPos;
+                        }
+                    }
+                    aCopySize = aCopyPos < aPos ? 1 : 0;
+                }
+                else if (aPos + 1 < iContent.size())
+                {
+                    aCopyPos = aLastPosVect[aByte | (iContent[aPos + 1] << 8)];
+                    if (aCopyPos != SIZE_MAX && aPos - aCopyPos <= sMaxDatCopyOffset)
+                    {
+                        size_t aMaxSize = std::min<size_t>(iContent.size() - aPos, sMaxDatCopySize + aCopySizeAdd);
+                        while (aCopySize < aMaxSize && iContent[aCopyPos + aCopySize] == iContent[aPos + aCopySize])
+                        {
+                            ++aCopySize;
+                        }
+                    }
+                    if (aCopySize < 4)
+                    {
+                        aCopySize = 0;
+                    }
+                }
+
+                size_t aNbEncoded = 1;
+                if (aCopySize != 0)
+                {
+                    if (aCopySize - aCopySizeAdd == sMaxDatCopySize)
+                    {
+                        const HuffmanCode &aCode = aSymbolTree[sNbDatSymbols - 1];
+                        aWriter.write(aCode.code, aCode.bits);
+                    }
+                    else
+                    {
+                        writeRange(aWriter, aSymbolTree, 0x100, 4, static_cast<uint32_t>(aCopySize - aCopySizeAdd));
+                    }
+                    writeRange(aWriter, aCopyTree, 0, 2, static_cast<uint32_t>(aPos - aCopyPos - 1));
+                    aNbEncoded = aCopySize;
+                }
+                else
+                {
+                    const HuffmanCode &aCode = aSymbolTree[aByte];
+                    aWriter.write(aCode.code, aCode.bits);
+                }
+
+                for (size_t aEnd = aPos + aNbEncoded; aPos < aEnd; ++aPos)
+                {
+                    aFirstPosVect[iContent[aPos]] = std::min(aFirstPosVect[iContent[aPos]], aPos);
+                    if (aPos + 1 < iContent.size())
+                    {
+                        aLastPosVect[iContent[aPos] | (iContent[aPos + 1] << 8)] = aPos;
+                    }
+                }
+            }
+        }
+
+        aWriter.flush();
+        return aWordVect;
+    }
+
+} // namespace synthetic
+
+#endif // GW2DATTOOLS_TESTS_SYNTHETICDAT_H
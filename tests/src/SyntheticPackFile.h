@@ -0,0 +1,96 @@
+#ifndef GW2DATTOOLS_TESTS_SYNTHETICPACKFILE_H
+#define GW2DATTOOLS_TESTS_SYNTHETICPACKFILE_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace synthetic
+{
+
+    const uint32_t sPackFileHeaderSize = 12;
+    const uint32_t sPackChunkHeaderSize = 16;
+
+    inline uint32_t makeFourCc(const char *iFourCc)
+    {
+        uint32_t aFourCc;
+        memcpy(&aFourCc, iFourCc, sizeof(aFourCc));
+        return aFourCc;
+    }
+
+    // Builds a PackFile in memory, the header fields of each chunk can be given as is, sizes included
+    class PackFileWriter
+    {
+    public:
+        explicit PackFileWriter(uint32_t iType, uint16_t iVersion = 3) : _buffer(sPackFileHeaderSize, 0)
+        {
+            _buffer[0] = 'P';
+            _buffer[1] = 'F';
+            put16(2, iVersion);
+            put16(6, static_cast<uint16_t>(sPackFileHeaderSize));
+            put32(8, iType);
+        }
+
+        // Appends a chunk of the given data and, if iOffsetVect is not empty, the offset table after it
+        void addChunk(uint32_t iMagic, uint16_t iVersion, const std::vector<uint8_t> &iData, const std::vector<uint32_t> &iOffsetVect = {})
+        {
+            uint32_t aDataSize = static_cast<uint32_t>(iData.size());
+            uint32_t aTableSize = iOffsetVect.empty() ? 0 : static_cast<uint32_t>((iOffsetVect.size() + 1) * sizeof(uint32_t));
+            uint32_t aOffsetToOffsetTable = iOffsetVect.empty() ? 0 : aDataSize;
+
+            addChunkHeader(iMagic, sPackChunkHeaderSize - 8 + aDataSize + aTableSize, iVersion, aOffsetToOffsetTable);
+            _buffer.insert(_buffer.end(), iData.begin(), iData.end());
+            if (!iOffsetVect.empty())
+            {
+                append32(static_cast<uint32_t>(iOffsetVect.size()));
+                for (uint32_t aOffset : iOffsetVect)
+                {
+                    append32(aOffset);
+                }
+            }
+        }
+
+        // Appends a chunk header only, iChunkSize excluding the magic and itself as in the format
+        void addChunkHeader(uint32_t iMagic, uint32_t iChunkSize, uint16_t iVersion, uint32_t iOffsetToOffsetTable)
+        {
+            append32(iMagic);
+            append32(iChunkSize);
+            append16(iVersion);
+            append16(static_cast<uint16_t>(sPackChunkHeaderSize));
+            append32(iOffsetToOffsetTable);
+        }
+
+        void append16(uint16_t iValue)
+        {
+            _buffer.resize(_buffer.size() + sizeof(iValue));
+            put16(static_cast<uint32_t>(_buffer.size() - sizeof(iValue)), iValue);
+        }
+
+        void append32(uint32_t iValue)
+        {
+            _buffer.resize(_buffer.size() + sizeof(iValue));
+            put32(static_cast<uint32_t>(_buffer.size() - sizeof(iValue)), iValue);
+        }
+
+        void put16(uint32_t iPos, uint16_t iValue)
+        {
+            memcpy(_buffer.data() + iPos, &iValue, sizeof(iValue));
+        }
+
+        void put32(uint32_t iPos, uint32_t iValue)
+        {
+            memcpy(_buffer.data() + iPos, &iValue, sizeof(iValue));
+        }
+
+        std::vector<uint8_t> &getBuffer()
+        {
+            return _buffer;
+        }
+
+    private:
+        std::vector<uint8_t> _buffer;
+    };
+
+} // namespace synthetic
+
+#endif // GW2DATTOOLS_TESTS_SYNTHETICPACKFILE_H
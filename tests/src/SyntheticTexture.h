@@ -0,0 +1,131 @@
+#ifndef GW2DATTOOLS_TESTS_SYNTHETICTEXTURE_H
+#define GW2DATTOOLS_TESTS_SYNTHETICTEXTURE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "SyntheticBits.h"
+
+namespace synthetic
+{
+
+    const uint32_t sAtexMagic = 0x58455441;
+
+    // Compression flags of the texture stream
+    const uint32_t sDecodeConstantAlphaFrom8Bits = 0x04;
+    const uint32_t sDecodePlainColor = 0x08;
+
+    // Longest run of the dictionary
+    const uint32_t sMaxRun = 0x12;
+
+    struct TextureFormat
+    {
+        const char *name;
+        uint32_t fourCc;
+        uint32_t compressionFlags;
+    };
+
+    const TextureFormat sFormatTab[] = {
+        {"DXT1", 0x31545844, sDecodePlainColor},
+        {"DXT3", 0x33545844, sDecodeConstantAlphaFrom8Bits | sDecodePlainColor},
+        {"DXT5", 0x35545844, sDecodeConstantAlphaFrom8Bits | sDecodePlainColor},
+        {"DXTA", 0x41545844, sDecodeConstantAlphaFrom8Bits},
+        {"DXTL", 0x4C545844, sDecodeConstantAlphaFrom8Bits | sDecodePlainColor},
+        {"DXTN", 0x4E545844, sDecodePlainColor},
+        {"3DCX", 0x58434433, sDecodePlainColor},
+    };
+
+    // Codes of the texture dictionary, as built by the decoder: symbols are listed by bit length,
+    // the last added first, and codes are given in decreasing order within a length
+    struct Dictionary
+    {
+        uint32_t codeTab[sMaxRun + 1];
+        uint8_t bitsTab[sMaxRun + 1];
+
+        Dictionary()
+        {
+            const uint8_t aSymbolTab[] = {0x01, 0x12, 0x11, 0x10, 0x0F, 0x0E, 0x0D, 0x0C, 0x0B, 0x0A, 0x09, 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02};
+            const uint8_t aBitsTab[] = {1, 2, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6};
+
+            uint32_t aCode = 0;
+            for (uint8_t aNbBits = 1; aNbBits <= 6; ++aNbBits)
+            {
+                aCode = (aCode << 1) + 1;
+                for (int32_t aIndex = sizeof(aSymbolTab) - 1; aIndex >= 0; --aIndex)
+                {
+                    if (aBitsTab[aIndex] == aNbBits)
+                    {
+                        codeTab[aSymbolTab[aIndex]] = aCode;
+                        bitsTab[aSymbolTab[aIndex]] = aNbBits;
+                        --aCode;
+                    }
+                }
+            }
+        }
+    };
+
+    // Writes a pass: runs of sMaxRun filled blocks alternating with runs left unset
+    inline void writePass(BitWriter &ioWriter, const Dictionary &iDictionary, uint32_t iNbBlocks, bool iHasNullBit, std::mt19937 &ioRandom)
+    {
+        uint32_t aPos = 0;
+        bool isFilled = true;
+        while (aPos < iNbBlocks)
+        {
+            uint32_t aRun = isFilled ? sMaxRun : 1 + ioRandom() % sMaxRun;
+            aRun = std::min(aRun, iNbBlocks - aPos);
+
+            ioWriter.write(iDictionary.codeTab[aRun], iDictionary.bitsTab[aRun]);
+            ioWriter.write(isFilled ? 1 : 0, 1);
+            if (iHasNullBit && isFilled)
+            {
+                ioWriter.write(1, 1);
+            }
+
+            aPos += aRun;
+            isFilled = !isFilled;
+        }
+    }
+
+    /**
+     * Encodes a texture with the dictionary of the decoder: a constant alpha pass and a plain color
+     * pass, as selected by the compression flags of the format, alternating filled runs with runs
+     * left to the plain data. Half of the pixel blocks go through the runs, half through the plain data.
+     */
+    inline std::vector<uint32_t> encodeTexture(const TextureFormat &iFormat, uint16_t iWidth, uint16_t iHeight, uint32_t iSeed = 0)
+    {
+        const Dictionary aDictionary;
+        std::mt19937 aRandom(iFormat.fourCc + iSeed);
+
+        uint32_t aNbBlocks = ((iWidth + 3) / 4) * ((iHeight + 3) / 4);
+
+        std::vector<uint32_t> aWordVect = {sAtexMagic, iFormat.fourCc, uint32_t(iWidth) | (uint32_t(iHeight) << 16), 0, iFormat.compressionFlags};
+        BitWriter aWriter(aWordVect);
+
+        if (iFormat.compressionFlags & sDecodeConstantAlphaFrom8Bits)
+        {
+            aWriter.write(0x80, 8);
+            writePass(aWriter, aDictionary, aNbBlocks, true, aRandom);
+        }
+
+        if (iFormat.compressionFlags & sDecodePlainColor)
+        {
+            aWriter.write(0x4080C0, 24);
+            writePass(aWriter, aDictionary, aNbBlocks, false, aRandom);
+        }
+
+        aWriter.flush();
+
+        // Plain data, enough for two words per component of each block
+        for (uint32_t aIndex = 0; aIndex < aNbBlocks * 4; ++aIndex)
+        {
+            aWriter.push(aRandom());
+        }
+
+        return aWordVect;
+    }
+
+} // namespace synthetic
+
+#endif // GW2DATTOOLS_TESTS_SYNTHETICTEXTURE_H
@@ -0,0 +1,292 @@
+// Walks the filename fields of synthetic chunks with the views generated from ANStructs.txt: the
+// Bounds checks of ViewTypes.h on pointers within, past the end of and before the chunk and on null
+// pointers, then the dispatch of visitChunkFilenames, which picks the structure of a chunk magic
+// shared by several pack types from the type of the PackFile.
+//
+// usage: anstructs-views
+
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gw2dattools/anstructs/ANStructs.h>
+#include <gw2dattools/format/PackFileView.h>
+
+#include "SyntheticPackFile.h"
+
+namespace
+{
+
+    namespace anstructs = gw2dt::anstructs;
+
+    const uint32_t sPointerSize = sizeof(anstructs::PointerOffset);
+
+    uint32_t sNbFailures = 0;
+
+    void check(bool iCondition, const std::string &iCase, const char *iWhat)
+    {
+        if (!iCondition)
+        {
+            std::cerr << iCase << ": " << iWhat << std::endl;
+            ++sNbFailures;
+        }
+    }
+
+    // Collects the file ids given to a visitor
+    struct FileIdCollector
+    {
+        std::vector<uint32_t> fileIdVect;
+
+        void operator()(uint32_t iFileId)
+        {
+            fileIdVect.push_back(iFileId);
+        }
+    };
+
+    // Writes a relative pointer at iPos to iTarget, both being positions in ioBuffer
+    void putPointer(std::vector<uint8_t> &ioBuffer, uint32_t iPos, int64_t iTarget)
+    {
+        anstructs::PointerOffset aOffset = static_cast<anstructs::PointerOffset>(iTarget - static_cast<int64_t>(iPos));
+        memcpy(ioBuffer.data() + iPos, &aOffset, sizeof(aOffset));
+    }
+
+    void putNullPointer(std::vector<uint8_t> &ioBuffer, uint32_t iPos)
+    {
+        memset(ioBuffer.data() + iPos, 0, sPointerSize);
+    }
+
+    // Writes the two words a filename field points to for a base id
+    void putFileId(std::vector<uint8_t> &ioBuffer, uint32_t iPos, uint32_t iFileId)
+    {
+        uint16_t aLowValue = static_cast<uint16_t>((iFileId - 1) % 0xFF00 + 0x100);
+        uint16_t aHighValue = static_cast<uint16_t>((iFileId - 1) / 0xFF00 + 0x100);
+        memcpy(ioBuffer.data() + iPos, &aLowValue, sizeof(aLowValue));
+        memcpy(ioBuffer.data() + iPos + sizeof(aLowValue), &aHighValue, sizeof(aHighValue));
+    }
+
+    void putCount(std::vector<uint8_t> &ioBuffer, uint32_t iPos, uint32_t iCount)
+    {
+        memcpy(ioBuffer.data() + iPos, &iCount, sizeof(iCount));
+    }
+
+    template <typename Type>
+    bool visit(const std::vector<uint8_t> &iBuffer, uint32_t iBoundsSize, const Type &iField, FileIdCollector &ioCollector)
+    {
+        anstructs::Bounds aBounds(iBuffer.data(), iBoundsSize);
+        return anstructs::visitFilenames(aBounds, iField, ioCollector);
+    }
+
+    void checkBounds()
+    {
+        std::vector<uint8_t> aBuffer(64);
+        anstructs::Bounds aBounds(aBuffer.data() + 16, 32);
+
+        check(aBounds.contains(aBuffer.data() + 16, 32), "bounds", "whole range rejected");
+        check(aBounds.contains(aBuffer.data() + 48, 0), "bounds", "empty range at the end rejected");
+        check(!aBounds.contains(aBuffer.data() + 45, 4), "bounds", "range past the end accepted");
+        check(!aBounds.contains(aBuffer.data() + 15, 1), "bounds", "range before the start accepted");
+        check(!aBounds.contains(aBuffer.data() + 49, 0), "bounds", "address past the end accepted");
+        check(!aBounds.contains(aBuffer.data() + 16, 0x100000000ull), "bounds", "size over 32 bits accepted");
+        check(!aBounds.contains(nullptr, 0), "bounds", "null address accepted");
+    }
+
+    void checkFilename()
+    {
+        std::vector<uint8_t> aBuffer(32);
+        anstructs::Filename aFilename(aBuffer.data());
+
+        // In bounds, the id spanning both words
+        putPointer(aBuffer, 0, 16);
+        putFileId(aBuffer, 16, 0xFF00 + 42);
+        FileIdCollector aCollector;
+        check(visit(aBuffer, 32, aFilename, aCollector) && aCollector.fileIdVect == std::vector<uint32_t>{0xFF00 + 42}, "filename", "wrong file id");
+        check(aFilename.getFileId() == 0xFF00 + 42, "filename", "getFileId differs from the walk");
+
+        // Words below 0x100 are not a reference
+        memset(aBuffer.data() + 16, 0, 4);
+        aCollector.fileIdVect.clear();
+        check(visit(aBuffer, 32, aFilename, aCollector) && aCollector.fileIdVect.empty(), "filename without id", "visited");
+
+        // Null pointer
+        putNullPointer(aBuffer, 0);
+        check(visit(aBuffer, 32, aFilename, aCollector) && aCollector.fileIdVect.empty(), "null filename", "visited or failed");
+
+        // Words of the id past the end, cut by the end, then before the start
+        putFileId(aBuffer, 28, 7);
+        putPointer(aBuffer, 0, 40);
+        check(!visit(aBuffer, 32, aFilename, aCollector) && aCollector.fileIdVect.empty(), "filename past the end", "walked");
+        putPointer(aBuffer, 0, 30);
+        check(!visit(aBuffer, 32, aFilename, aCollector) && aCollector.fileIdVect.empty(), "filename cut by the end", "walked");
+        putPointer(aBuffer, 0, 28);
+        check(visit(aBuffer, 32, aFilename, aCollector) && aCollector.fileIdVect == std::vector<uint32_t>{7}, "filename at the end", "not walked");
+        aCollector.fileIdVect.clear();
+        check(!visit(aBuffer, 31, aFilename, aCollector) && aCollector.fileIdVect.empty(), "filename in shorter bounds", "walked");
+        putPointer(aBuffer, 0, -8);
+        check(!visit(aBuffer, 32, aFilename, aCollector) && aCollector.fileIdVect.empty(), "filename before the start", "walked");
+
+        // The field itself outside the bounds
+        anstructs::Filename aOutsideFilename(aBuffer.data() + 32 - sPointerSize + 1);
+        check(!visit(aBuffer, 32, aOutsideFilename, aCollector), "filename field past the end", "walked");
+    }
+
+    void checkArrays()
+    {
+        // An array of two filenames then the words of their ids
+        const uint32_t aArraySize = sizeof(uint32_t) + sPointerSize;
+        const uint32_t aElementPos = aArraySize;
+        const uint32_t aIdPos = aElementPos + 2 * sPointerSize;
+        std::vector<uint8_t> aBuffer(aIdPos + 8);
+        anstructs::ArrayView<anstructs::Filename> aArray(aBuffer.data());
+
+        putCount(aBuffer, 0, 2);
+        putPointer(aBuffer, sizeof(uint32_t), aElementPos);
+        putPointer(aBuffer, aElementPos, aIdPos);
+        putPointer(aBuffer, aElementPos + sPointerSize, aIdPos + 4);
+        putFileId(aBuffer, aIdPos, 3);
+        putFileId(aBuffer, aIdPos + 4, 0x20000);
+
+        uint32_t aSize = static_cast<uint32_t>(aBuffer.size());
+        FileIdCollector aCollector;
+        check(visit(aBuffer, aSize, aArray, aCollector) && aCollector.fileIdVect == std::vector<uint32_t>({3, 0x20000}), "array", "wrong file ids");
+
+        // A null element, then a null array with a count
+        putNullPointer(aBuffer, aElementPos);
+        aCollector.fileIdVect.clear();
+        check(visit(aBuffer, aSize, aArray, aCollector) && aCollector.fileIdVect == std::vector<uint32_t>{0x20000}, "array with a null element", "wrong file ids");
+
+        putNullPointer(aBuffer, sizeof(uint32_t));
+        aCollector.fileIdVect.clear();
+        check(aArray.size() == 0 && visit(aBuffer, aSize, aArray, aCollector) && aCollector.fileIdVect.empty(), "null array", "visited or failed");
+
+        // Counts past the end, including one overflowing 32 bits once multiplied by the element size
+        putPointer(aBuffer, sizeof(uint32_t), aElementPos);
+        putCount(aBuffer, 0, 5);
+        check(!visit(aBuffer, aSize, aArray, aCollector), "array count past the end", "walked");
+        putCount(aBuffer, 0, 0xFFFFFFFF);
+        check(!visit(aBuffer, aSize, aArray, aCollector), "array count overflowing", "walked");
+        check(aCollector.fileIdVect.empty(), "array past the end", "visited before failing");
+
+        // Elements before the start
+        putCount(aBuffer, 0, 1);
+        putPointer(aBuffer, sizeof(uint32_t), -static_cast<int64_t>(sPointerSize));
+        check(!visit(aBuffer, aSize, aArray, aCollector), "array before the start", "walked");
+
+        // Array of pointers to filenames
+        const uint32_t aPtrIdPos = aArraySize + sPointerSize + sPointerSize;
+        std::vector<uint8_t> aPtrBuffer(aPtrIdPos + 4);
+        anstructs::PtrArrayView<anstructs::Filename> aPtrArray(aPtrBuffer.data());
+        putCount(aPtrBuffer, 0, 1);
+        putPointer(aPtrBuffer, sizeof(uint32_t), aArraySize);
+        putPointer(aPtrBuffer, aArraySize, aArraySize + sPointerSize);
+        putPointer(aPtrBuffer, aArraySize + sPointerSize, aPtrIdPos);
+        putFileId(aPtrBuffer, aPtrIdPos, 9);
+
+        uint32_t aPtrSize = static_cast<uint32_t>(aPtrBuffer.size());
+        aCollector.fileIdVect.clear();
+        check(visit(aPtrBuffer, aPtrSize, aPtrArray, aCollector) && aCollector.fileIdVect == std::vector<uint32_t>{9}, "pointer array", "wrong file ids");
+
+        putPointer(aPtrBuffer, aArraySize, aPtrSize);
+        check(!visit(aPtrBuffer, aPtrSize, aPtrArray, aCollector), "pointer array element past the end", "walked");
+
+        putNullPointer(aPtrBuffer, aArraySize);
+        aCollector.fileIdVect.clear();
+        check(visit(aPtrBuffer, aPtrSize, aPtrArray, aCollector) && aCollector.fileIdVect.empty(), "pointer array null element", "visited or failed");
+    }
+
+    // Data of a version 1 SKEL chunk of a model referencing iFileId, its other pointers null
+    std::vector<uint8_t> makeModelSkeleton(uint32_t iFileId)
+    {
+        typedef anstructs::SKEL_ModelFileSkeleton::Version<1>::Root Root;
+
+        std::vector<uint8_t> aData(Root::structSize + 4);
+        uint32_t aFieldPos = static_cast<uint32_t>(Root(aData.data()).fileReference().getData() - aData.data());
+        putPointer(aData, aFieldPos, Root::structSize);
+        putFileId(aData, Root::structSize, iFileId);
+        return aData;
+    }
+
+    void checkChunkDispatch()
+    {
+        const uint32_t aTypeModl = synthetic::makeFourCc("MODL");
+        const uint32_t aTypeAmat = synthetic::makeFourCc("AMAT");
+        const uint32_t aTypeScene = synthetic::makeFourCc("ASCN");
+        const uint32_t aMagicSkel = synthetic::makeFourCc("SKEL");
+        const uint32_t aMagicTool = synthetic::makeFourCc("TOOL");
+
+        std::vector<uint8_t> aData = makeModelSkeleton(1234);
+        uint32_t aSize = static_cast<uint32_t>(aData.size());
+
+        // A model skeleton, the only SKEL structure with a filename field
+        FileIdCollector aCollector;
+        check(anstructs::visitChunkFilenames(aTypeModl, aMagicSkel, 1, aData.data(), aSize, aCollector) &&
+              aCollector.fileIdVect == std::vector<uint32_t>{1234}, "SKEL of a model", "wrong file ids");
+
+        // The same bytes in a scene are not guessed to be a model skeleton
+        aCollector.fileIdVect.clear();
+        check(!anstructs::visitChunkFilenames(aTypeScene, aMagicSkel, 1, aData.data(), aSize, aCollector) && aCollector.fileIdVect.empty(),
+              "SKEL of a scene", "walked as a model skeleton");
+
+        // Versions not described, then chunk data cut before the end of the root structure
+        check(!anstructs::visitChunkFilenames(aTypeModl, aMagicSkel, 2, aData.data(), aSize, aCollector), "SKEL version 2", "walked");
+        check(!anstructs::visitChunkFilenames(aTypeModl, aMagicSkel, 1, aData.data(), anstructs::SKEL_ModelFileSkeleton::Version<1>::Root::structSize - 1, aCollector),
+              "SKEL cut", "walked");
+        check(aCollector.fileIdVect.empty(), "SKEL failures", "visited");
+
+        // Every TOOL structure is described but only by pack type, material ones hold no filename
+        std::vector<uint8_t> aToolData(anstructs::TOOL_AmatToolParams::Version<3>::Root::structSize);
+        check(anstructs::visitChunkFilenames(aTypeAmat, aMagicTool, 3, aToolData.data(), static_cast<uint32_t>(aToolData.size()), aCollector),
+              "TOOL of a material", "not described");
+        check(!anstructs::visitChunkFilenames(aTypeScene, aMagicTool, 3, aToolData.data(), static_cast<uint32_t>(aToolData.size()), aCollector),
+              "TOOL of a scene", "described");
+
+        check(!anstructs::visitChunkFilenames(aTypeModl, synthetic::makeFourCc("ZZZZ"), 0, aData.data(), aSize, aCollector), "unknown magic", "described");
+
+        // Through a PackFile, its header giving the pack type
+        synthetic::PackFileWriter aModelWriter(aTypeModl);
+        aModelWriter.addChunk(aMagicSkel, 1, aData);
+        gw2dt::format::PackFileView aModelView(static_cast<uint32_t>(aModelWriter.getBuffer().size()), aModelWriter.getBuffer().data());
+        aCollector.fileIdVect.clear();
+        check(anstructs::visitChunkFilenames(aModelView.getType(), aModelView.getChunkVect()[0], aCollector) &&
+              aCollector.fileIdVect == std::vector<uint32_t>{1234}, "SKEL chunk of a model PackFile", "wrong file ids");
+
+        synthetic::PackFileWriter aSceneWriter(aTypeScene);
+        aSceneWriter.addChunk(aMagicSkel, 1, aData);
+        gw2dt::format::PackFileView aSceneView(static_cast<uint32_t>(aSceneWriter.getBuffer().size()), aSceneWriter.getBuffer().data());
+        aCollector.fileIdVect.clear();
+        check(!anstructs::visitChunkFilenames(aSceneView.getType(), aSceneView.getChunkVect()[0], aCollector) && aCollector.fileIdVect.empty(),
+              "SKEL chunk of a scene PackFile", "walked as a model skeleton");
+
+        // A filename pointing past the chunk into the next one
+        std::vector<uint8_t> aOutsideData = makeModelSkeleton(1234);
+        aOutsideData.resize(anstructs::SKEL_ModelFileSkeleton::Version<1>::Root::structSize);
+        synthetic::PackFileWriter aOutsideWriter(aTypeModl);
+        aOutsideWriter.addChunk(aMagicSkel, 1, aOutsideData);
+        aOutsideWriter.addChunk(synthetic::makeFourCc("ZZZZ"), 0, std::vector<uint8_t>(8, 0x80));
+        gw2dt::format::PackFileView aOutsideView(static_cast<uint32_t>(aOutsideWriter.getBuffer().size()), aOutsideWriter.getBuffer().data());
+        aCollector.fileIdVect.clear();
+        check(!anstructs::visitChunkFilenames(aOutsideView.getType(), aOutsideView.getChunkVect()[0], aCollector) && aCollector.fileIdVect.empty(),
+              "SKEL filename past its chunk", "walked");
+    }
+
+} // namespace
+
+int main()
+{
+    try
+    {
+        checkBounds();
+        checkFilename();
+        checkArrays();
+        checkChunkDispatch();
+    }
+    catch (std::exception &iException)
+    {
+        std::cerr << "anstructs-views: " << iException.what() << std::endl;
+        return 1;
+    }
+
+    return sNbFailures == 0 ? 0 : 1;
+}
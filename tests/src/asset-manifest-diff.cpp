@@ -0,0 +1,148 @@
+// Compares synthetic manifests with diffManifests: added, removed and modified assets, the counters
+// and the download size, and a manifest without crc, as parsed from an MFST chunk, against one
+// without flags, as built from an archive, which must not report the unchanged assets as modified.
+//
+// usage: asset-manifest-diff
+
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gw2dattools/index/AssetManifest.h>
+
+namespace
+{
+
+    using gw2dt::index::AssetManifest;
+    using gw2dt::index::ManifestDiff;
+
+    uint32_t sNbFailures = 0;
+
+    void check(bool iCondition, const std::string &iCase, const char *iWhat)
+    {
+        if (!iCondition)
+        {
+            std::cerr << iCase << ": " << iWhat << std::endl;
+            ++sNbFailures;
+        }
+    }
+
+    // Records, in any order, as {baseId, fileId, size, flags, crc}
+    AssetManifest makeManifest(const std::vector<AssetManifest::Record> &iRecordVect)
+    {
+        return AssetManifest(0, iRecordVect, {});
+    }
+
+    void checkChange(const ManifestDiff &iDiff, uint32_t iIndex, uint32_t iBaseId, ManifestDiff::ChangeKind iKind, const std::string &iCase)
+    {
+        if (iIndex >= iDiff.changeVect.size())
+        {
+            check(false, iCase, "change missing");
+            return;
+        }
+        const ManifestDiff::Change &aChange = iDiff.changeVect[iIndex];
+        check(aChange.baseId == iBaseId, iCase, "wrong baseId");
+        check(aChange.kind == iKind, iCase, "wrong kind");
+        check((aChange.oldRecordIndex == ManifestDiff::NoRecord) == (iKind == ManifestDiff::CK_ADDED), iCase, "wrong old record index");
+        check((aChange.newRecordIndex == ManifestDiff::NoRecord) == (iKind == ManifestDiff::CK_REMOVED), iCase, "wrong new record index");
+    }
+
+    void testChanges()
+    {
+        AssetManifest aOld = makeManifest({
+            {40, 400, 4000, 1, 0xAAAA}, // Removed
+            {10, 100, 1000, 1, 0x1111}, // Unchanged
+            {20, 200, 2000, 1, 0x2222}, // New fileId
+            {30, 300, 3000, 1, 0x3333}, // New size
+            {50, 500, 5000, 1, 0x5555}, // New crc
+            {60, 600, 6000, 1, 0x6666}, // New flags
+        });
+        AssetManifest aNew = makeManifest({
+            {10, 100, 1000, 1, 0x1111},
+            {20, 201, 2000, 1, 0x2222},
+            {30, 300, 3100, 1, 0x3333},
+            {50, 500, 5000, 1, 0x5556},
+            {60, 600, 6000, 2, 0x6666},
+            {70, 700, 7000, 1, 0x7777}, // Added
+            {20, 150, 9999, 1, 0x9999}, // Older version of an asset, dropped
+        });
+
+        ManifestDiff aDiff = gw2dt::index::diffManifests(aOld, aNew);
+        check(aDiff.changeVect.size() == 6, "changes", "wrong number of changes");
+        checkChange(aDiff, 0, 20, ManifestDiff::CK_MODIFIED, "new fileId");
+        checkChange(aDiff, 1, 30, ManifestDiff::CK_MODIFIED, "new size");
+        checkChange(aDiff, 2, 40, ManifestDiff::CK_REMOVED, "removed");
+        checkChange(aDiff, 3, 50, ManifestDiff::CK_MODIFIED, "new crc");
+        checkChange(aDiff, 4, 60, ManifestDiff::CK_MODIFIED, "new flags");
+        checkChange(aDiff, 5, 70, ManifestDiff::CK_ADDED, "added");
+
+        check(aDiff.nbOfAdded == 1 && aDiff.nbOfRemoved == 1 && aDiff.nbOfModified == 4, "changes", "wrong counters");
+        check(aDiff.downloadSize == 2000 + 3100 + 5000 + 6000 + 7000, "changes", "wrong download size");
+
+        if (aDiff.changeVect.size() == 6)
+        {
+            const ManifestDiff::Change &aModified = aDiff.changeVect[0];
+            check(aOld.getRecordVect()[aModified.oldRecordIndex].fileId == 200, "new fileId", "wrong old record");
+            check(aNew.getRecordVect()[aModified.newRecordIndex].fileId == 201, "new fileId", "wrong new record");
+            check(aOld.getRecordVect()[aDiff.changeVect[2].oldRecordIndex].baseId == 40, "removed", "wrong old record");
+            check(aNew.getRecordVect()[aDiff.changeVect[5].newRecordIndex].baseId == 70, "added", "wrong new record");
+        }
+    }
+
+    void testEdges()
+    {
+        AssetManifest aEmpty = makeManifest({});
+        AssetManifest aManifest = makeManifest({{1, 10, 100, 0, 0}, {2, 20, 200, 0, 0}});
+
+        ManifestDiff aDiff = gw2dt::index::diffManifests(aManifest, aManifest);
+        check(aDiff.changeVect.empty() && aDiff.downloadSize == 0, "same manifest", "changes reported");
+
+        aDiff = gw2dt::index::diffManifests(aEmpty, aManifest);
+        check(aDiff.nbOfAdded == 2 && aDiff.changeVect.size() == 2 && aDiff.downloadSize == 300, "from empty", "not all added");
+
+        aDiff = gw2dt::index::diffManifests(aManifest, aEmpty);
+        check(aDiff.nbOfRemoved == 2 && aDiff.changeVect.size() == 2 && aDiff.downloadSize == 0, "to empty", "not all removed");
+    }
+
+    // An MFST manifest has flags and no crc, an archive manifest a crc and no flags
+    void testMixedSources()
+    {
+        AssetManifest aMfst = makeManifest({
+            {10, 100, 1000, 3, 0},
+            {20, 200, 2000, 3, 0},
+            {30, 300, 3000, 3, 0},
+        });
+        AssetManifest aArchive = makeManifest({
+            {10, 100, 1000, 0, 0x1111},
+            {20, 201, 2000, 0, 0x2222},
+            {30, 300, 3000, 0, 0x3333},
+        });
+
+        ManifestDiff aDiff = gw2dt::index::diffManifests(aMfst, aArchive);
+        check(aDiff.changeVect.size() == 1, "mfst to archive", "unchanged assets reported");
+        checkChange(aDiff, 0, 20, ManifestDiff::CK_MODIFIED, "mfst to archive");
+
+        aDiff = gw2dt::index::diffManifests(aArchive, aMfst);
+        check(aDiff.changeVect.size() == 1 && aDiff.nbOfModified == 1, "archive to mfst", "unchanged assets reported");
+    }
+
+} // namespace
+
+int main()
+{
+    try
+    {
+        testChanges();
+        testEdges();
+        testMixedSources();
+    }
+    catch (std::exception &iException)
+    {
+        std::cerr << "asset-manifest-diff: " << iException.what() << std::endl;
+        return 1;
+    }
+
+    return sNbFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,263 @@
+// Writes synthetic files to an export container through a small buffer and reads them back with
+// ContainerReader. Containers which were not finished, whose trailer or index are corrupt or which
+// are cut must be refused rather than give entries reaching past the data.
+//
+// usage: export-container
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gw2dattools/container/ExportContainer.h>
+
+namespace
+{
+
+    using gw2dt::container::ContainerEntry;
+    using gw2dt::container::ContainerReader;
+    using gw2dt::container::ContainerWriter;
+
+    const char *sPath = "export-container.gwct";
+    const uint32_t sBufferSize = 4096;
+    const uint32_t sTrailerSize = 24;
+
+    uint32_t sNbFailures = 0;
+
+    void check(bool iCondition, const std::string &iCase, const char *iWhat)
+    {
+        if (!iCondition)
+        {
+            std::cerr << iCase << ": " << iWhat << std::endl;
+            ++sNbFailures;
+        }
+    }
+
+    struct File
+    {
+        uint32_t fileId;
+        uint32_t flags;
+        std::vector<uint8_t> data;
+    };
+
+    std::vector<File> makeFiles()
+    {
+        std::vector<File> aFileVect;
+        // Out of order ids, unaligned sizes, an empty file and one larger than the buffer
+        const uint32_t aSizeArray[] = {37, 0, 16, 10000, 1, 4095};
+        const uint32_t aFileIdArray[] = {500, 20, 310, 7, 9000, 64};
+        for (uint32_t aIndex = 0; aIndex < 6; ++aIndex)
+        {
+            File aFile = {aFileIdArray[aIndex], aIndex % 2 == 0 ? 0u : uint32_t(gw2dt::container::CEF_TEXTURE), {}};
+            for (uint32_t aByte = 0; aByte < aSizeArray[aIndex]; ++aByte)
+            {
+                aFile.data.push_back(static_cast<uint8_t>(aByte * 7 + aIndex));
+            }
+            aFileVect.push_back(aFile);
+        }
+        return aFileVect;
+    }
+
+    void writeContainer(const std::vector<File> &iFileVect, bool iFinish)
+    {
+        ContainerWriter aWriter(sPath, sBufferSize);
+        for (const File &aFile : iFileVect)
+        {
+            aWriter.add(aFile.fileId, aFile.flags, static_cast<uint32_t>(aFile.data.size()), aFile.data.data());
+        }
+        if (iFinish)
+        {
+            aWriter.finish();
+        }
+    }
+
+    std::vector<uint8_t> readFile()
+    {
+        std::ifstream aStream(sPath, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(aStream), std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const std::vector<uint8_t> &iBuffer)
+    {
+        std::ofstream aStream(sPath, std::ios::binary | std::ios::trunc);
+        aStream.write(reinterpret_cast<const char *>(iBuffer.data()), iBuffer.size());
+    }
+
+    void checkRefused(const std::string &iCase)
+    {
+        try
+        {
+            ContainerReader aReader(sPath);
+            check(false, iCase, "no exception");
+        }
+        catch (std::exception &)
+        {
+        }
+    }
+
+    void testRoundTrip(const std::vector<File> &iFileVect)
+    {
+        uint64_t aSize = 0;
+        {
+            ContainerWriter aWriter(sPath, sBufferSize);
+            for (const File &aFile : iFileVect)
+            {
+                aWriter.add(aFile.fileId, aFile.flags, static_cast<uint32_t>(aFile.data.size()), aFile.data.data());
+            }
+            aWriter.finish();
+            aWriter.finish();
+            aSize = aWriter.getSize();
+
+            try
+            {
+                aWriter.add(1, 0, 0, nullptr);
+                check(false, "add after finish", "no exception");
+            }
+            catch (std::exception &)
+            {
+            }
+        }
+        check(readFile().size() == aSize, "round trip", "size of the file differs from the writer's");
+
+        ContainerReader aReader(sPath);
+        const std::vector<ContainerEntry> &aEntryVect = aReader.getEntryVect();
+        check(aEntryVect.size() == iFileVect.size(), "round trip", "wrong number of entries");
+        for (uint32_t aIndex = 1; aIndex < aEntryVect.size(); ++aIndex)
+        {
+            check(aEntryVect[aIndex - 1].fileId < aEntryVect[aIndex].fileId, "round trip", "index not sorted");
+        }
+
+        for (const File &aFile : iFileVect)
+        {
+            std::string aCase = "file " + std::to_string(aFile.fileId);
+            const ContainerEntry *pEntry = aReader.findEntry(aFile.fileId);
+            if (pEntry == nullptr)
+            {
+                check(false, aCase, "not found");
+                continue;
+            }
+            check(pEntry->size == aFile.data.size() && pEntry->flags == aFile.flags, aCase, "wrong entry");
+            check(pEntry->offset % gw2dt::container::ContainerAlignment == 0, aCase, "data not aligned");
+
+            std::vector<uint8_t> aBuffer(aFile.data.size() + 8, 0xCD);
+            uint32_t aOutputSize = static_cast<uint32_t>(aBuffer.size());
+            aReader.getBuffer(*pEntry, aOutputSize, aBuffer.data());
+            aBuffer.resize(aOutputSize);
+            check(aBuffer == aFile.data, aCase, "data differs");
+
+            // A smaller buffer gets the start of the data
+            if (aFile.data.size() > 1)
+            {
+                aOutputSize = 1;
+                aReader.getBuffer(*pEntry, aOutputSize, aBuffer.data());
+                check(aOutputSize == 1 && aBuffer[0] == aFile.data[0], aCase, "partial read");
+            }
+        }
+
+        check(aReader.findEntry(8) == nullptr && aReader.findEntry(0xFFFFFFFF) == nullptr, "missing file", "found");
+
+        ContainerWriter(sPath, sBufferSize).finish();
+        ContainerReader aEmptyReader(sPath);
+        check(aEmptyReader.getEntryVect().empty(), "empty container", "entries found");
+    }
+
+    void testUnfinished(const std::vector<File> &iFileVect)
+    {
+        // Everything is still in the buffer, the file is empty
+        writeContainer({iFileVect[0]}, false);
+        check(readFile().empty(), "unfinished, buffered", "data written before finish");
+        checkRefused("unfinished, buffered");
+
+        // The buffer was written a few times, the index never
+        writeContainer(iFileVect, false);
+        check(readFile().size() >= sBufferSize, "unfinished", "buffer not written");
+        checkRefused("unfinished");
+    }
+
+    void testCorrupt(const std::vector<File> &iFileVect)
+    {
+        writeContainer(iFileVect, true);
+        const std::vector<uint8_t> aValid = readFile();
+        const size_t aTrailerPos = aValid.size() - sTrailerSize;
+        const size_t aIndexPos = aTrailerPos - iFileVect.size() * sizeof(ContainerEntry);
+
+        struct Corruption
+        {
+            const char *name;
+            size_t pos;
+            uint8_t value;
+        };
+        const Corruption aCorruptionArray[] = {
+            {"file magic", 0, 'X'},
+            {"file version", 4, 2},
+            {"trailer index offset", aTrailerPos, static_cast<uint8_t>(aValid[aTrailerPos] + 16)},
+            {"trailer index offset high byte", aTrailerPos + 7, 0x80},
+            {"trailer entry count", aTrailerPos + 8, static_cast<uint8_t>(aValid[aTrailerPos + 8] + 1)},
+            {"trailer entry count high byte", aTrailerPos + 11, 0x10},
+            {"trailer magic", aTrailerPos + 16, 'X'},
+            {"entry offset high byte", aIndexPos + 7, 0x01},
+            {"entry size", aIndexPos + 12 + 3, 0x7F},
+            {"entry order", aIndexPos + 8 + 3, 0xFF},
+        };
+        for (const Corruption &aCorruption : aCorruptionArray)
+        {
+            std::vector<uint8_t> aBuffer = aValid;
+            aBuffer[aCorruption.pos] = aCorruption.value;
+            writeFile(aBuffer);
+            checkRefused(aCorruption.name);
+        }
+
+        // Data offset on the file header
+        std::vector<uint8_t> aBuffer = aValid;
+        const uint64_t aOffset = 8;
+        memcpy(aBuffer.data() + aIndexPos, &aOffset, sizeof(aOffset));
+        writeFile(aBuffer);
+        checkRefused("entry offset before the data");
+
+        std::vector<uint8_t> aCut(aValid.begin(), aValid.end() - 1);
+        writeFile(aCut);
+        checkRefused("last byte cut");
+
+        aCut.assign(aValid.begin(), aValid.begin() + aIndexPos);
+        writeFile(aCut);
+        checkRefused("index cut");
+
+        aCut.assign(aValid.begin(), aValid.begin() + 20);
+        writeFile(aCut);
+        checkRefused("shorter than a trailer");
+
+        writeFile({});
+        checkRefused("empty file");
+
+        // The untouched file is still accepted
+        writeFile(aValid);
+        ContainerReader aReader(sPath);
+        check(aReader.getEntryVect().size() == iFileVect.size(), "valid", "wrong number of entries");
+    }
+
+} // namespace
+
+int main()
+{
+    try
+    {
+        std::vector<File> aFileVect = makeFiles();
+        testRoundTrip(aFileVect);
+        testUnfinished(aFileVect);
+        testCorrupt(aFileVect);
+    }
+    catch (std::exception &iException)
+    {
+        std::cerr << "export-container: " << iException.what() << std::endl;
+        std::remove(sPath);
+        return 1;
+    }
+
+    std::remove(sPath);
+    return sNbFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+// Inflates a batch of synthetic compressed files with inflateDatFileBatch, through an allocator
+// returning misaligned memory, and compares the contents with the original ones. The batch mixes
+// valid files with an empty content, a missing header, cut data and a header announcing more
+// than its data can expand to, each of which must be flagged in its span without failing the batch.
+//
+// usage: inflate-batch
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gw2dattools/compression/inflateDatFileBatch.h>
+
+#include "SyntheticDat.h"
+
+namespace
+{
+
+    using gw2dt::compression::DecodedBatch;
+
+    const uint32_t sMisalignment = 3;
+
+    // Allocator returning memory off the alignment of malloc, counting its allocations
+    void *allocateMisaligned(void *iContext, uint32_t iSize)
+    {
+        ++*static_cast<uint32_t *>(iContext);
+        uint8_t *pBuffer = static_cast<uint8_t *>(malloc(iSize + sMisalignment));
+        return pBuffer == nullptr ? nullptr : pBuffer + sMisalignment;
+    }
+
+    void releaseMisaligned(void *, void *ipBuffer)
+    {
+        free(static_cast<uint8_t *>(ipBuffer) - sMisalignment);
+    }
+
+    struct File
+    {
+        std::string name;
+        std::vector<uint8_t> content; // As announced by the header when it is plausible
+        std::vector<uint8_t> data;
+        bool isValid;
+    };
+
+    std::vector<uint8_t> toBytes(const std::vector<uint32_t> &iWordVect)
+    {
+        std::vector<uint8_t> aData(iWordVect.size() * sizeof(uint32_t));
+        memcpy(aData.data(), iWordVect.data(), aData.size());
+        return aData;
+    }
+
+    std::vector<File> makeFiles()
+    {
+        std::vector<File> aFileVect;
+
+        std::vector<uint8_t> aText;
+        const char *pText = "model texture map sound string ";
+        while (aText.size() < 50000)
+        {
+            aText.insert(aText.end(), pText, pText + strlen(pText) - (aText.size() / 31) % 7);
+        }
+        aFileVect.push_back({"text", aText, toBytes(synthetic::encodeDat(aText)), true});
+
+        // As compressible as the encoder makes it, within the bound of the header check
+        std::vector<uint8_t> aZeros(1000000, 0);
+        aFileVect.push_back({"zeros", aZeros, toBytes(synthetic::encodeDat(aZeros)), true});
+
+        std::vector<uint8_t> aSmall(37, 'x');
+        aFileVect.push_back({"small", aSmall, toBytes(synthetic::encodeDat(aSmall)), true});
+
+        // A header announcing an empty content
+        aFileVect.push_back({"empty", {}, toBytes({0x12345678, 0, 0}), true});
+
+        aFileVect.push_back({"no header", {}, std::vector<uint8_t>(8, 0), false});
+
+        // Valid header, data cut in half
+        std::vector<uint8_t> aCut = toBytes(synthetic::encodeDat(aText));
+        aCut.resize(aCut.size() / 2 & ~size_t(3));
+        aFileVect.push_back({"cut", aText, aCut, false});
+
+        // 4 GB announced by 16 bytes
+        aFileVect.push_back({"implausible size", {}, toBytes({0, 0xFFFFFF00, 0, 0}), false});
+
+        return aFileVect;
+    }
+
+} // namespace
+
+int main()
+{
+    uint32_t aNbFailures = 0;
+
+    try
+    {
+        std::vector<File> aFileVect = makeFiles();
+
+        std::vector<gw2dt::compression::BatchInput> aInputVect;
+        uint64_t aContentSize = 0;
+        for (const File &aFile : aFileVect)
+        {
+            aInputVect.push_back({static_cast<uint32_t>(aFile.data.size()), aFile.data.data()});
+            aContentSize += aFile.content.size() + DecodedBatch::BatchAlignment;
+        }
+
+        uint32_t aNbAllocations = 0;
+        gw2dt::compression::Allocator aAllocator = {&allocateMisaligned, &releaseMisaligned, &aNbAllocations};
+        DecodedBatch aBatch = gw2dt::compression::inflateDatFileBatch(aInputVect, 2, aAllocator);
+
+        if (aNbAllocations != 1 || aBatch.getArenaSize() > aContentSize)
+        {
+            std::cerr << "arena of " << aBatch.getArenaSize() << " bytes in " << aNbAllocations << " allocations for "
+                      << aContentSize << " bytes of contents" << std::endl;
+            ++aNbFailures;
+        }
+
+        for (uint32_t aIndex = 0; aIndex < aFileVect.size(); ++aIndex)
+        {
+            const File &aFile = aFileVect[aIndex];
+            const DecodedBatch::Span &aSpan = aBatch.getSpanVect()[aIndex];
+            const uint8_t *pContent = aBatch.getContent(aIndex);
+
+            if (aSpan.isDecoded != aFile.isValid)
+            {
+                std::cerr << aFile.name << ": " << (aSpan.isDecoded ? "decoded" : "not decoded") << std::endl;
+                ++aNbFailures;
+            }
+            else if (aFile.isValid && (aSpan.size != aFile.content.size() || memcmp(pContent, aFile.content.data(), aSpan.size) != 0))
+            {
+                std::cerr << aFile.name << ": content differs" << std::endl;
+                ++aNbFailures;
+            }
+            else if (reinterpret_cast<uintptr_t>(pContent) % DecodedBatch::BatchAlignment != 0)
+            {
+                std::cerr << aFile.name << ": content not aligned" << std::endl;
+                ++aNbFailures;
+            }
+        }
+    }
+    catch (std::exception &iException)
+    {
+        std::cerr << "inflate-batch: " << iException.what() << std::endl;
+        return 1;
+    }
+
+    return aNbFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+// Inflates synthetic compressed streams in place, in a buffer of getInPlaceBufferSize bytes, and
+// compares the results with inflateDatFileBuffer and with the original content. The streams include
+// the worst case of the format, where each byte of output takes about 10 bytes of compressed data.
+//
+// usage: inflate-in-place
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gw2dattools/compression/inflateDatFileBuffer.h>
+
+#include "SyntheticDat.h"
+
+namespace
+{
+
+    struct Stream
+    {
+        std::string name;
+        std::vector<uint8_t> content;
+        std::vector<uint32_t> words;
+    };
+
+    std::vector<uint8_t> makeText(size_t iSize, std::mt19937 &ioRandom)
+    {
+        const char *aWordTab[] = {"texture ", "model ", "map ", "sound ", "string ", "0x1F2E ", "\r\n"};
+
+        std::vector<uint8_t> aContent;
+        while (aContent.size() < iSize)
+        {
+            const char *pWord = aWordTab[ioRandom() % (sizeof(aWordTab) / sizeof(aWordTab[0]))];
+            aContent.insert(aContent.end(), pWord, pWord + strlen(pWord));
+        }
+        aContent.resize(iSize);
+        return aContent;
+    }
+
+    std::vector<uint8_t> makeRandom(size_t iSize, std::mt19937 &ioRandom)
+    {
+        std::vector<uint8_t> aContent(iSize);
+        for (uint8_t &aByte : aContent)
+        {
+            aByte = static_cast<uint8_t>(ioRandom());
+        }
+        return aContent;
+    }
+
+    std::vector<Stream> makeStreams()
+    {
+        std::mt19937 aRandom(0x44415400);
+        std::vector<Stream> aStreamVect;
+
+        aStreamVect.push_back({"small text", makeText(100, aRandom), {}});
+        aStreamVect.back().words = synthetic::encodeDat(aStreamVect.back().content);
+
+        aStreamVect.push_back({"text", makeText(300000, aRandom), {}});
+        aStreamVect.back().words = synthetic::encodeDat(aStreamVect.back().content);
+
+        aStreamVect.push_back({"random", makeRandom(100000, aRandom), {}});
+        aStreamVect.back().words = synthetic::encodeDat(aStreamVect.back().content);
+
+        // Every byte a copy of a single byte with codes of 31 bits
+        aStreamVect.push_back({"worst case", makeRandom(20000, aRandom), {}});
+        aStreamVect.back().words = synthetic::encodeDat(aStreamVect.back().content, 0);
+
+        // The output is far ahead of the input when the worst case starts
+        aStreamVect.push_back({"text then worst case", makeText(200000, aRandom), {}});
+        aStreamVect.back().content.resize(206000, 't');
+        aStreamVect.back().words = synthetic::encodeDat(aStreamVect.back().content, 200000);
+
+        return aStreamVect;
+    }
+
+    // Returns the size of the output on success, throws otherwise
+    uint32_t inflateInPlace(const Stream &iStream, uint32_t iBufferSize, std::vector<uint8_t> &oBuffer)
+    {
+        uint32_t aInputSize = static_cast<uint32_t>(iStream.words.size() * sizeof(uint32_t));
+        oBuffer.assign(iBufferSize, 0);
+        memcpy(oBuffer.data() + iBufferSize - aInputSize, iStream.words.data(), aInputSize);
+
+        uint32_t aOutputSize = 0;
+        gw2dt::compression::inflateDatFileBufferInPlace(iBufferSize, oBuffer.data(), aInputSize, aOutputSize);
+        return aOutputSize;
+    }
+
+    bool checkStream(const Stream &iStream)
+    {
+        uint32_t aInputSize = static_cast<uint32_t>(iStream.words.size() * sizeof(uint32_t));
+        uint32_t aContentSize = static_cast<uint32_t>(iStream.content.size());
+        const uint8_t *pInput = reinterpret_cast<const uint8_t *>(iStream.words.data());
+
+        std::vector<uint8_t> aOutputVect(aContentSize);
+        uint32_t aOutputSize = aContentSize;
+        gw2dt::compression::inflateDatFileBuffer(aInputSize, pInput, aOutputSize, aOutputVect.data());
+        if (aOutputVect != iStream.content)
+        {
+            std::cerr << iStream.name << ": inflateDatFileBuffer differs from the content" << std::endl;
+            return false;
+        }
+
+        uint32_t aBufferSize = gw2dt::compression::getInPlaceBufferSize(aInputSize, aContentSize);
+        std::cout << iStream.name << ": " << aContentSize << " bytes from " << aInputSize << ", in place in " << aBufferSize << std::endl;
+
+        std::vector<uint8_t> aBuffer;
+        aOutputSize = inflateInPlace(iStream, aBufferSize, aBuffer);
+        if (aOutputSize != aContentSize || memcmp(aBuffer.data(), aOutputVect.data(), aContentSize) != 0)
+        {
+            std::cerr << iStream.name << ": inflating in place differs from inflateDatFileBuffer" << std::endl;
+            return false;
+        }
+
+        // With less room, decoding either succeeds or fails, it never returns a wrong output
+        uint32_t aSmallBufferSize = std::max(aContentSize, aInputSize);
+        try
+        {
+            aOutputSize = inflateInPlace(iStream, aSmallBufferSize, aBuffer);
+            if (aOutputSize != aContentSize || memcmp(aBuffer.data(), aOutputVect.data(), aContentSize) != 0)
+            {
+                std::cerr << iStream.name << ": inflating in place in " << aSmallBufferSize << " bytes returned a wrong output" << std::endl;
+                return false;
+            }
+        }
+        catch (std::exception &)
+        {
+        }
+
+        return true;
+    }
+
+} // namespace
+
+int main()
+{
+    uint32_t aNbFailures = 0;
+
+    try
+    {
+        for (const Stream &aStream : makeStreams())
+        {
+            if (!checkStream(aStream))
+            {
+                ++aNbFailures;
+            }
+        }
+    }
+    catch (std::exception &iException)
+    {
+        std::cerr << "inflate-in-place: " << iException.what() << std::endl;
+        return 1;
+    }
+
+    return aNbFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,248 @@
+// Parses synthetic PackFiles with PackFileView: well formed ones, whose chunks and offset tables are
+// checked, and malformed, truncated or overlapping ones, which must throw rather than give a chunk
+// reaching past the buffer.
+//
+// usage: packfile-view
+
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gw2dattools/format/PackFileView.h>
+
+#include "SyntheticPackFile.h"
+
+namespace
+{
+
+    using gw2dt::format::PackFileView;
+
+    const uint32_t sTypeModl = synthetic::makeFourCc("MODL");
+    const uint32_t sMagicGeom = synthetic::makeFourCc("GEOM");
+    const uint32_t sMagicSkel = synthetic::makeFourCc("SKEL");
+
+    uint32_t sNbFailures = 0;
+
+    void check(bool iCondition, const std::string &iCase, const char *iWhat)
+    {
+        if (!iCondition)
+        {
+            std::cerr << iCase << ": " << iWhat << std::endl;
+            ++sNbFailures;
+        }
+    }
+
+    void checkThrows(const std::string &iCase, const std::vector<uint8_t> &iBuffer)
+    {
+        try
+        {
+            PackFileView aView(static_cast<uint32_t>(iBuffer.size()), iBuffer.data());
+            std::cerr << iCase << ": parsed with " << aView.getChunkVect().size() << " chunks instead of throwing" << std::endl;
+            ++sNbFailures;
+        }
+        catch (std::exception &)
+        {
+        }
+    }
+
+    // Every chunk lies within the buffer and its offset table within the chunk
+    bool isInBuffer(const PackFileView &iView, const std::vector<uint8_t> &iBuffer)
+    {
+        const uint8_t *pEnd = iBuffer.data() + iBuffer.size();
+        for (const PackFileView::Chunk &aChunk : iView.getChunkVect())
+        {
+            if (aChunk.begin < iBuffer.data() || aChunk.begin + aChunk.size > pEnd ||
+                aChunk.data + aChunk.dataSize > aChunk.begin + aChunk.size ||
+                (aChunk.offsetTab != nullptr && aChunk.offsetTab + aChunk.nbOfOffsets * sizeof(uint32_t) > aChunk.begin + aChunk.size))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void checkWellFormed()
+    {
+        synthetic::PackFileWriter aWriter(sTypeModl, 3);
+        aWriter.addChunk(sMagicGeom, 2, std::vector<uint8_t>(10, 0x47), {0, 4, 9});
+        aWriter.addChunk(sMagicSkel, 1, std::vector<uint8_t>(8, 0x53));
+        const std::vector<uint8_t> &aBuffer = aWriter.getBuffer();
+
+        PackFileView aView(static_cast<uint32_t>(aBuffer.size()), aBuffer.data());
+        check(aView.getVersion() == 3 && aView.getType() == sTypeModl, "well formed", "wrong version or type");
+        check(isInBuffer(aView, aBuffer), "well formed", "chunk outside the buffer");
+
+        const std::vector<PackFileView::Chunk> &aChunkVect = aView.getChunkVect();
+        if (aChunkVect.size() != 2)
+        {
+            check(false, "well formed", "wrong number of chunks");
+            return;
+        }
+
+        // The offset table follows 10 bytes of data, its entries are not aligned
+        const PackFileView::Chunk &aGeom = aChunkVect[0];
+        check(aGeom.magic == sMagicGeom && aGeom.version == 2, "well formed", "wrong first chunk");
+        check(aGeom.dataSize == 10 && aGeom.data == aBuffer.data() + synthetic::sPackFileHeaderSize + synthetic::sPackChunkHeaderSize, "well formed", "wrong data of the first chunk");
+        check(aGeom.nbOfOffsets == 3 && aGeom.getOffset(0) == 0 && aGeom.getOffset(1) == 4 && aGeom.getOffset(2) == 9, "well formed", "wrong offset table");
+
+        const PackFileView::Chunk &aSkel = aChunkVect[1];
+        check(aSkel.begin == aGeom.begin + aGeom.size, "well formed", "second chunk does not follow the first");
+        check(aSkel.dataSize == 8 && aSkel.offsetTab == nullptr && aSkel.nbOfOffsets == 0, "well formed", "wrong second chunk");
+
+        check(aView.findChunk(sMagicSkel) == &aSkel, "well formed", "findChunk missed a chunk");
+        check(aView.findChunk(synthetic::makeFourCc("ANIM")) == nullptr, "well formed", "findChunk found a missing chunk");
+    }
+
+    void checkEdges()
+    {
+        // A header without chunks
+        synthetic::PackFileWriter aEmptyWriter(sTypeModl);
+        PackFileView aEmptyView(static_cast<uint32_t>(aEmptyWriter.getBuffer().size()), aEmptyWriter.getBuffer().data());
+        check(aEmptyView.getChunkVect().empty(), "no chunk", "chunks found");
+
+        // A chunk of a header only
+        synthetic::PackFileWriter aHeaderOnlyWriter(sTypeModl);
+        aHeaderOnlyWriter.addChunk(sMagicGeom, 0, {});
+        PackFileView aHeaderOnlyView(static_cast<uint32_t>(aHeaderOnlyWriter.getBuffer().size()), aHeaderOnlyWriter.getBuffer().data());
+        check(aHeaderOnlyView.getChunkVect().size() == 1 && aHeaderOnlyView.getChunkVect()[0].dataSize == 0, "empty chunk", "wrong chunk");
+
+        // Trailing bytes too few for a chunk header are not a chunk
+        synthetic::PackFileWriter aTrailingWriter(sTypeModl);
+        aTrailingWriter.addChunk(sMagicGeom, 0, std::vector<uint8_t>(4, 0));
+        aTrailingWriter.getBuffer().resize(aTrailingWriter.getBuffer().size() + synthetic::sPackChunkHeaderSize - 1, 0);
+        PackFileView aTrailingView(static_cast<uint32_t>(aTrailingWriter.getBuffer().size()), aTrailingWriter.getBuffer().data());
+        check(aTrailingView.getChunkVect().size() == 1, "trailing bytes", "wrong number of chunks");
+
+        // A file header size past the buffer leaves no chunk
+        synthetic::PackFileWriter aLongHeaderWriter(sTypeModl);
+        aLongHeaderWriter.addChunk(sMagicGeom, 0, std::vector<uint8_t>(4, 0));
+        aLongHeaderWriter.put16(6, 0xFFFF);
+        PackFileView aLongHeaderView(static_cast<uint32_t>(aLongHeaderWriter.getBuffer().size()), aLongHeaderWriter.getBuffer().data());
+        check(aLongHeaderView.getChunkVect().empty(), "file header past the buffer", "chunks found");
+    }
+
+    void checkMalformed()
+    {
+        synthetic::PackFileWriter aWriter(sTypeModl);
+        aWriter.addChunk(sMagicGeom, 0, std::vector<uint8_t>(8, 0));
+
+        std::vector<uint8_t> aNotPackFile = aWriter.getBuffer();
+        aNotPackFile[1] = 'X';
+        check(!PackFileView::isPackFile(static_cast<uint32_t>(aNotPackFile.size()), aNotPackFile.data()), "not a PackFile", "isPackFile accepted it");
+        checkThrows("not a PackFile", aNotPackFile);
+
+        std::vector<uint8_t> aShortHeader(aWriter.getBuffer().begin(), aWriter.getBuffer().begin() + synthetic::sPackFileHeaderSize - 1);
+        checkThrows("truncated file header", aShortHeader);
+
+        try
+        {
+            PackFileView aView(16, nullptr);
+            check(false, "null buffer", "parsed instead of throwing");
+        }
+        catch (std::exception &)
+        {
+        }
+
+        // The chunk size must at least cover the rest of the chunk header
+        synthetic::PackFileWriter aTinyWriter(sTypeModl);
+        aTinyWriter.addChunkHeader(sMagicGeom, synthetic::sPackChunkHeaderSize - 8 - 1, 0, 0);
+        aTinyWriter.append32(0);
+        checkThrows("chunk size below its header", aTinyWriter.getBuffer());
+
+        synthetic::PackFileWriter aZeroWriter(sTypeModl);
+        aZeroWriter.addChunkHeader(sMagicGeom, 0, 0, 0);
+        checkThrows("chunk size of zero", aZeroWriter.getBuffer());
+    }
+
+    void checkTruncated()
+    {
+        synthetic::PackFileWriter aWriter(sTypeModl);
+        aWriter.addChunk(sMagicGeom, 0, std::vector<uint8_t>(20, 0), {0, 8});
+        aWriter.addChunk(sMagicSkel, 0, std::vector<uint8_t>(20, 0));
+        const std::vector<uint8_t> &aBuffer = aWriter.getBuffer();
+
+        // Cut inside the data of the last chunk, then inside the offset table of the first one
+        checkThrows("last chunk cut", std::vector<uint8_t>(aBuffer.begin(), aBuffer.end() - 1));
+        uint32_t aFirstChunkEnd = synthetic::sPackFileHeaderSize + synthetic::sPackChunkHeaderSize + 20 + 3 * sizeof(uint32_t);
+        checkThrows("offset table cut", std::vector<uint8_t>(aBuffer.begin(), aBuffer.begin() + aFirstChunkEnd - 2));
+
+        // Chunk sizes past the buffer, including one overflowing 32 bits once the first 8 bytes are added
+        synthetic::PackFileWriter aLongWriter(sTypeModl);
+        aLongWriter.addChunkHeader(sMagicGeom, 0x1000, 0, 0);
+        checkThrows("chunk size past the buffer", aLongWriter.getBuffer());
+
+        synthetic::PackFileWriter aHugeWriter(sTypeModl);
+        aHugeWriter.addChunkHeader(sMagicGeom, 0xFFFFFFFC, 0, 0);
+        checkThrows("chunk size overflowing", aHugeWriter.getBuffer());
+
+        // The offset table and its count past the chunk
+        synthetic::PackFileWriter aTableWriter(sTypeModl);
+        aTableWriter.addChunk(sMagicGeom, 0, std::vector<uint8_t>(8, 0));
+        aTableWriter.put32(synthetic::sPackFileHeaderSize + 12, 8);
+        checkThrows("offset table at the chunk end", aTableWriter.getBuffer());
+
+        aTableWriter.put32(synthetic::sPackFileHeaderSize + 12, 0xFFFFFFF0);
+        checkThrows("offset table far past the chunk", aTableWriter.getBuffer());
+
+        synthetic::PackFileWriter aCountWriter(sTypeModl);
+        aCountWriter.addChunk(sMagicGeom, 0, std::vector<uint8_t>(8, 0), {1, 2});
+        aCountWriter.put32(synthetic::sPackFileHeaderSize + synthetic::sPackChunkHeaderSize + 8, 3);
+        checkThrows("offset count past the chunk", aCountWriter.getBuffer());
+
+        aCountWriter.put32(synthetic::sPackFileHeaderSize + synthetic::sPackChunkHeaderSize + 8, 0x40000000);
+        checkThrows("offset count overflowing", aCountWriter.getBuffer());
+    }
+
+    void checkOverlapping()
+    {
+        // A first chunk claiming part of the header of the second one: the remainder is no longer a
+        // chunk header, it must not be read as one
+        synthetic::PackFileWriter aWriter(sTypeModl);
+        aWriter.addChunk(sMagicGeom, 0, std::vector<uint8_t>(8, 0));
+        aWriter.addChunk(sMagicSkel, 0, std::vector<uint8_t>(8, 0));
+        std::vector<uint8_t> &aBuffer = aWriter.getBuffer();
+        aWriter.put32(synthetic::sPackFileHeaderSize + 4, synthetic::sPackChunkHeaderSize - 8 + 8 + 4);
+        checkThrows("chunk overlapping the next header", aBuffer);
+
+        // A first chunk covering the whole second one swallows it
+        aWriter.put32(synthetic::sPackFileHeaderSize + 4, synthetic::sPackChunkHeaderSize - 8 + 8 + synthetic::sPackChunkHeaderSize + 8);
+        PackFileView aView(static_cast<uint32_t>(aBuffer.size()), aBuffer.data());
+        check(aView.getChunkVect().size() == 1 && aView.findChunk(sMagicSkel) == nullptr && isInBuffer(aView, aBuffer), "chunk covering the next one", "wrong chunks");
+
+        // Chunks sharing a magic: findChunk returns the first one
+        synthetic::PackFileWriter aDuplicateWriter(sTypeModl);
+        aDuplicateWriter.addChunk(sMagicGeom, 1, std::vector<uint8_t>(4, 0));
+        aDuplicateWriter.addChunk(sMagicGeom, 2, std::vector<uint8_t>(4, 0));
+        PackFileView aDuplicateView(static_cast<uint32_t>(aDuplicateWriter.getBuffer().size()), aDuplicateWriter.getBuffer().data());
+        check(aDuplicateView.getChunkVect().size() == 2 && aDuplicateView.findChunk(sMagicGeom) == &aDuplicateView.getChunkVect()[0], "duplicate magic", "findChunk did not return the first chunk");
+
+        // An offset table overlapping the chunk header of the next chunk
+        synthetic::PackFileWriter aTableWriter(sTypeModl);
+        aTableWriter.addChunk(sMagicGeom, 0, std::vector<uint8_t>(8, 0), {0});
+        aTableWriter.addChunk(sMagicSkel, 0, std::vector<uint8_t>(8, 0));
+        aTableWriter.put32(synthetic::sPackFileHeaderSize + synthetic::sPackChunkHeaderSize + 8, 2);
+        checkThrows("offset table overlapping the next chunk", aTableWriter.getBuffer());
+    }
+
+} // namespace
+
+int main()
+{
+    try
+    {
+        checkWellFormed();
+        checkEdges();
+        checkMalformed();
+        checkTruncated();
+        checkOverlapping();
+    }
+    catch (std::exception &iException)
+    {
+        std::cerr << "packfile-view: " << iException.what() << std::endl;
+        return 1;
+    }
+
+    return sNbFailures == 0 ? 0 : 1;
+}
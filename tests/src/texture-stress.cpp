@@ -0,0 +1,146 @@
+// Decodes textures of every format from several threads at once and compares the results with a
+// sequential decode. Meant to be run under ThreadSanitizer too, see tests/CMakeLists.txt.
+//
+// usage: texture-stress [threads] [rounds]
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <gw2dattools/compression/inflateTextureFileBuffer.h>
+
+#include "SyntheticTexture.h"
+
+namespace
+{
+
+    const uint64_t sFailedHash = 0;
+
+    std::vector<std::vector<uint32_t>> makeTextures()
+    {
+        const uint16_t aSizeTab[][2] = {{4, 4}, {30, 17}, {128, 128}, {256, 64}};
+
+        std::vector<std::vector<uint32_t>> aTextureVect;
+        for (const synthetic::TextureFormat &aFormat : synthetic::sFormatTab)
+        {
+            for (uint32_t aSizeIndex = 0; aSizeIndex < sizeof(aSizeTab) / sizeof(aSizeTab[0]); ++aSizeIndex)
+            {
+                aTextureVect.push_back(synthetic::encodeTexture(aFormat, aSizeTab[aSizeIndex][0], aSizeTab[aSizeIndex][1], aSizeIndex));
+            }
+        }
+
+        // Unknown format, which throws
+        aTextureVect.push_back(synthetic::encodeTexture(synthetic::sFormatTab[0], 64, 64));
+        aTextureVect.back()[1] = 0x30545844;
+
+        return aTextureVect;
+    }
+
+    // Returns a hash of the decoded texture, sFailedHash if the decoding fails
+    uint64_t decode(const std::vector<uint32_t> &iTexture, gw2dt::compression::TextureInflater *ipInflater)
+    {
+        uint32_t aInputSize = static_cast<uint32_t>(iTexture.size() * sizeof(uint32_t));
+        const uint8_t *pInput = reinterpret_cast<const uint8_t *>(iTexture.data());
+
+        // Zeroed, as the decoder leaves the second half of the DXTL blocks untouched
+        std::vector<uint8_t> aOutputVect(((iTexture[2] & 0xFFFF) + 3) / 4 * (((iTexture[2] >> 16) + 3) / 4) * 16, 0);
+
+        try
+        {
+            uint32_t aOutputSize = static_cast<uint32_t>(aOutputVect.size());
+            if (ipInflater != nullptr)
+            {
+                ipInflater->inflate(aInputSize, pInput, aOutputSize, aOutputVect.data());
+            }
+            else
+            {
+                gw2dt::compression::inflateTextureFileBuffer(aInputSize, pInput, aOutputSize, aOutputVect.data());
+            }
+
+            // FNV-1a
+            uint64_t aHash = 0xCBF29CE484222325;
+            for (uint32_t aIndex = 0; aIndex < aOutputSize; ++aIndex)
+            {
+                aHash = (aHash ^ aOutputVect[aIndex]) * 0x100000001B3;
+            }
+            return aHash != sFailedHash ? aHash : 1;
+        }
+        catch (std::exception &)
+        {
+            return sFailedHash;
+        }
+    }
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    uint32_t aNbThreads = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 8;
+    uint32_t aNbRounds = argc > 2 ? static_cast<uint32_t>(atoi(argv[2])) : 20;
+
+    if (aNbThreads == 0 || aNbRounds == 0)
+    {
+        std::cerr << "usage: texture-stress [threads] [rounds]" << std::endl;
+        return 1;
+    }
+
+    const std::vector<std::vector<uint32_t>> aTextureVect = makeTextures();
+    const size_t aNbTextures = aTextureVect.size();
+
+    // The threads start before any texture is decoded, so that the first uses of the shared tables
+    // race. Each goes through the textures in its own order, half of them with a reused inflater.
+    std::vector<uint64_t> aHashVect(aNbThreads * aNbRounds * aNbTextures);
+    std::vector<std::thread> aThreadVect;
+    for (uint32_t aThreadIndex = 0; aThreadIndex < aNbThreads; ++aThreadIndex)
+    {
+        aThreadVect.emplace_back([&, aThreadIndex]()
+        {
+            gw2dt::compression::TextureInflater aInflater;
+            for (uint32_t aRound = 0; aRound < aNbRounds; ++aRound)
+            {
+                for (size_t aStep = 0; aStep < aNbTextures; ++aStep)
+                {
+                    size_t aTextureIndex = (aStep * (2 * aThreadIndex + 1) + aRound) % aNbTextures;
+                    aHashVect[(aThreadIndex * aNbRounds + aRound) * aNbTextures + aTextureIndex] =
+                        decode(aTextureVect[aTextureIndex], (aStep + aThreadIndex) % 2 ? &aInflater : nullptr);
+                }
+            }
+        });
+    }
+
+    for (std::thread &aThread : aThreadVect)
+    {
+        aThread.join();
+    }
+
+    uint32_t aNbMismatches = 0;
+    for (size_t aTextureIndex = 0; aTextureIndex < aNbTextures; ++aTextureIndex)
+    {
+        uint64_t aExpectedHash = decode(aTextureVect[aTextureIndex], nullptr);
+        if ((aExpectedHash == sFailedHash) != (aTextureIndex + 1 == aNbTextures))
+        {
+            std::cerr << "Unexpected result of the sequential decoding of texture " << aTextureIndex << std::endl;
+            return 1;
+        }
+
+        for (size_t aRun = 0; aRun < aNbThreads * aNbRounds; ++aRun)
+        {
+            if (aHashVect[aRun * aNbTextures + aTextureIndex] != aExpectedHash)
+            {
+                ++aNbMismatches;
+            }
+        }
+    }
+
+    if (aNbMismatches != 0)
+    {
+        std::cerr << aNbMismatches << " concurrent decodings differ from the sequential one" << std::endl;
+        return 1;
+    }
+
+    std::cout << aNbThreads << " threads decoded " << aNbTextures << " textures " << aNbRounds << " times each" << std::endl;
+    return 0;
+}
@@ -0,0 +1,822 @@
+// Generates zero-copy C++ views of the chunk structures described in misc/templates/ANStructs.txt.
+//
+// usage: anstructs-generator <ANStructs.txt> <output directory> [pointer size]
+//
+// One header is written per chunk, along with Config.h and the ANStructs.h umbrella header.
+// Files whose content did not change are left untouched so that dependent sources are not rebuilt.
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+    enum FieldKind
+    {
+        FK_VALUE,
+        FK_ARRAY_PTR,     // TSTRUCT_ARRAY_PTR_START / END
+        FK_PTR_ARRAY_PTR, // TSTRUCT_PTR_ARRAY_PTR_START / END
+        FK_PTR            // TPTR_START / END
+    };
+
+    struct Field
+    {
+        FieldKind kind;
+        std::string typeName;
+        std::string name;
+        uint32_t count; // Fixed array size, 0 when the field is not an array
+    };
+
+    struct Struct
+    {
+        std::string name;
+        std::string className;
+        std::vector<Field> fields;
+    };
+
+    struct VersionBlock
+    {
+        uint32_t version;
+        std::vector<Struct> structs;
+    };
+
+    struct Chunk
+    {
+        std::string magic;
+        std::string rootName;
+        std::string namespaceName;
+        std::vector<VersionBlock> versions;
+    };
+
+    struct BuiltinType
+    {
+        const char *name;
+        const char *cppType;
+        uint32_t size; // 0 for the types stored as a pointer
+        bool isView;
+    };
+
+    const BuiltinType sBuiltinTypes[] = {
+        {"byte", "uint8_t", 1, false},
+        {"byte3", "Byte3", 3, false},
+        {"byte4", "Byte4", 4, false},
+        {"byte16", "Byte16", 16, false},
+        {"word", "uint16_t", 2, false},
+        {"word3", "Word3", 6, false},
+        {"dword", "uint32_t", 4, false},
+        {"dword2", "Dword2", 8, false},
+        {"dword4", "Dword4", 16, false},
+        {"qword", "uint64_t", 8, false},
+        {"float", "float", 4, false},
+        {"float2", "Float2", 8, false},
+        {"float3", "Float3", 12, false},
+        {"float4", "Float4", 16, false},
+        {"double", "double", 8, false},
+        {"fileref", "uint32_t", 4, false},
+        {"filename", "Filename", 0, true},
+        {"char_ptr", "CharPtr", 0, true},
+        {"wchar_ptr", "WCharPtr", 0, true},
+    };
+
+    // Member names that would clash with C++ keywords or with the names the views use
+    const char *sReservedNames[] = {
+        "alignas", "alignof", "and", "asm", "auto", "bool", "break", "case", "catch", "char", "char16_t", "char32_t", "class",
+        "const", "constexpr", "continue", "decltype", "default", "delete", "do", "double", "else", "enum", "explicit", "export",
+        "extern", "false", "float", "for", "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new",
+        "noexcept", "not", "nullptr", "operator", "or", "private", "protected", "public", "register", "return", "short",
+        "signed", "sizeof", "static", "struct", "switch", "template", "this", "throw", "true", "try", "typedef", "typename",
+        "union", "unsigned", "using", "virtual", "void", "volatile", "while", "xor",
+        "structSize", "getData", "readValue", "resolvePointer", "Ptr", "ArrayView", "PtrArrayView", "Root", "Bounds", "visitFilenames",
+        "uint8_t", "uint16_t", "uint32_t", "uint64_t", "Byte3", "Byte4", "Byte16", "Word3", "Dword2", "Dword4",
+        "Float2", "Float3", "Float4", "Filename", "CharPtr", "WCharPtr",
+    };
+
+    // ANStructs.txt does not tell which pack type a chunk belongs to. The chunks sharing a magic are told
+    // apart by the pack type of their file, known for the root structs starting with these prefixes.
+    struct PackType
+    {
+        const char *rootPrefix;
+        const char *fourCc;
+    };
+
+    const PackType sPackTypes[] = {
+        {"ModelFile", "MODL"},
+        {"Amat", "AMAT"},
+        {"PackContent", "cntc"},
+        {"PackMapMetadata", "mMet"},
+    };
+
+    const char *findPackType(const std::string &iRootName)
+    {
+        for (const PackType &aPackType : sPackTypes)
+        {
+            if (iRootName.compare(0, std::strlen(aPackType.rootPrefix), aPackType.rootPrefix) == 0)
+            {
+                return aPackType.fourCc;
+            }
+        }
+        return nullptr;
+    }
+
+    const BuiltinType *findBuiltinType(const std::string &iName)
+    {
+        for (const BuiltinType &aType : sBuiltinTypes)
+        {
+            if (iName == aType.name)
+            {
+                return &aType;
+            }
+        }
+        return nullptr;
+    }
+
+    std::string sanitizeIdentifier(const std::string &iName)
+    {
+        std::string aResult;
+        for (char aChar : iName)
+        {
+            aResult += std::isalnum(static_cast<unsigned char>(aChar)) ? aChar : '_';
+        }
+        if (aResult.empty() || std::isdigit(static_cast<unsigned char>(aResult[0])))
+        {
+            aResult = "_" + aResult;
+        }
+        return aResult;
+    }
+
+    // FourCC of a chunk magic, padded with zeros
+    std::string formatMagic(const std::string &iMagic)
+    {
+        uint32_t aMagic = 0;
+        for (size_t aIndex = 0; aIndex < 4 && aIndex < iMagic.size(); ++aIndex)
+        {
+            aMagic |= static_cast<uint32_t>(static_cast<uint8_t>(iMagic[aIndex])) << (8 * aIndex);
+        }
+        std::ostringstream aStream;
+        aStream << "0x" << std::hex << std::uppercase << aMagic;
+        return aStream.str();
+    }
+
+    std::vector<std::string> splitWords(const std::string &iLine)
+    {
+        std::vector<std::string> aWordVect;
+        std::istringstream aStream(iLine);
+        std::string aWord;
+        while (aStream >> aWord)
+        {
+            aWordVect.push_back(aWord);
+        }
+        return aWordVect;
+    }
+
+    bool startsWith(const std::string &iString, const std::string &iPrefix)
+    {
+        return iString.compare(0, iPrefix.size(), iPrefix) == 0;
+    }
+
+    // Parses a field line such as "TSTRUCT_ARRAY_PTR_START dword state TSTRUCT_ARRAY_PTR_END;"
+    Field parseField(const std::string &iLine, uint32_t iLineNumber)
+    {
+        std::string aLine = iLine;
+        std::string::size_type aSemicolonPos = aLine.rfind(';');
+        if (aSemicolonPos == std::string::npos)
+        {
+            throw std::runtime_error("line " + std::to_string(iLineNumber) + ": missing ';'");
+        }
+        aLine.erase(aSemicolonPos);
+
+        std::vector<std::string> aWordVect = splitWords(aLine);
+
+        Field aField;
+        aField.kind = FK_VALUE;
+        aField.count = 0;
+
+        size_t aTypeIndex = 0;
+        if (!aWordVect.empty())
+        {
+            if (aWordVect[0] == "TSTRUCT_ARRAY_PTR_START")
+            {
+                aField.kind = FK_ARRAY_PTR;
+            }
+            else if (aWordVect[0] == "TSTRUCT_PTR_ARRAY_PTR_START")
+            {
+                aField.kind = FK_PTR_ARRAY_PTR;
+            }
+            else if (aWordVect[0] == "TPTR_START")
+            {
+                aField.kind = FK_PTR;
+            }
+        }
+
+        if (aField.kind != FK_VALUE)
+        {
+            aTypeIndex = 1;
+            if (aWordVect.size() != 4)
+            {
+                throw std::runtime_error("line " + std::to_string(iLineNumber) + ": unexpected pointer field syntax");
+            }
+        }
+        else if (aWordVect.size() != 2)
+        {
+            throw std::runtime_error("line " + std::to_string(iLineNumber) + ": unexpected field syntax");
+        }
+
+        aField.typeName = aWordVect[aTypeIndex];
+        aField.name = aWordVect[aTypeIndex + 1];
+
+        std::string::size_type aBracketPos = aField.name.find('[');
+        if (aBracketPos != std::string::npos)
+        {
+            aField.count = static_cast<uint32_t>(std::strtoul(aField.name.c_str() + aBracketPos + 1, nullptr, 10));
+            aField.name.erase(aBracketPos);
+        }
+
+        return aField;
+    }
+
+    std::vector<Chunk> parseStructFile(const char *iPath)
+    {
+        std::ifstream aStream(iPath, std::ios::binary);
+        if (!aStream)
+        {
+            throw std::runtime_error(std::string("cannot open ") + iPath);
+        }
+
+        std::vector<Chunk> aChunkVect;
+        Struct *pCurrentStruct = nullptr;
+
+        std::string aLine;
+        uint32_t aLineNumber = 0;
+
+        while (std::getline(aStream, aLine))
+        {
+            ++aLineNumber;
+
+            if (!aLine.empty() && aLine.back() == '\r')
+            {
+                aLine.pop_back();
+            }
+
+            if (startsWith(aLine, " * Chunk: "))
+            {
+                Chunk aChunk;
+                aChunk.magic = aLine.substr(10, aLine.find(',') - 10);
+                aChunkVect.push_back(aChunk);
+            }
+            else if (startsWith(aLine, "/* Version: "))
+            {
+                if (aChunkVect.empty())
+                {
+                    throw std::runtime_error("line " + std::to_string(aLineNumber) + ": version outside of a chunk");
+                }
+                VersionBlock aVersionBlock;
+                aVersionBlock.version = static_cast<uint32_t>(std::strtoul(aLine.c_str() + 12, nullptr, 10));
+                aChunkVect.back().versions.push_back(aVersionBlock);
+            }
+            else if (startsWith(aLine, "typedef struct {"))
+            {
+                if (aChunkVect.empty() || aChunkVect.back().versions.empty())
+                {
+                    throw std::runtime_error("line " + std::to_string(aLineNumber) + ": struct outside of a version");
+                }
+                aChunkVect.back().versions.back().structs.push_back(Struct());
+                pCurrentStruct = &aChunkVect.back().versions.back().structs.back();
+            }
+            else if (startsWith(aLine, "} ") && pCurrentStruct != nullptr)
+            {
+                pCurrentStruct->name = aLine.substr(2, aLine.find(';') - 2);
+                pCurrentStruct = nullptr;
+            }
+            else if (pCurrentStruct != nullptr && !splitWords(aLine).empty())
+            {
+                pCurrentStruct->fields.push_back(parseField(aLine, aLineNumber));
+            }
+        }
+
+        return aChunkVect;
+    }
+
+    // Gives unique C++ names to the chunks, the structs and the fields
+    void assignNames(std::vector<Chunk> &ioChunkVect)
+    {
+        std::set<std::string> aReservedNameSet(std::begin(sReservedNames), std::end(sReservedNames));
+        std::set<std::string> aNamespaceNameSet;
+
+        for (Chunk &aChunk : ioChunkVect)
+        {
+            if (aChunk.versions.empty() || aChunk.versions.front().structs.empty())
+            {
+                throw std::runtime_error("chunk " + aChunk.magic + " has no structure");
+            }
+
+            // Several file types use the same chunk magic, the name of the root struct tells them apart
+            std::string aRootName = aChunk.versions.front().structs.back().name;
+            std::string::size_type aVersionPos = aRootName.find_last_of('V');
+            if (aVersionPos != std::string::npos && aVersionPos + 1 < aRootName.size() &&
+                aRootName.find_first_not_of("0123456789", aVersionPos + 1) == std::string::npos)
+            {
+                aRootName.erase(aVersionPos);
+            }
+
+            aChunk.rootName = aRootName;
+            std::string aNamespaceName = sanitizeIdentifier(aChunk.magic + "_" + aRootName);
+            std::string aUniqueNamespaceName = aNamespaceName;
+            for (uint32_t aSuffix = 2; !aNamespaceNameSet.insert(aUniqueNamespaceName).second; ++aSuffix)
+            {
+                aUniqueNamespaceName = aNamespaceName + std::to_string(aSuffix);
+            }
+            aChunk.namespaceName = aUniqueNamespaceName;
+
+            for (VersionBlock &aVersionBlock : aChunk.versions)
+            {
+                std::set<std::string> aClassNameSet;
+                for (Struct &aStruct : aVersionBlock.structs)
+                {
+                    // A struct may be redefined in a block, it then shadows the previous definition
+                    std::string aClassName = sanitizeIdentifier(aStruct.name);
+                    aStruct.className = aClassName;
+                    for (uint32_t aSuffix = 2; !aClassNameSet.insert(aStruct.className).second; ++aSuffix)
+                    {
+                        aStruct.className = aClassName + std::to_string(aSuffix);
+                    }
+                }
+
+                for (Struct &aStruct : aVersionBlock.structs)
+                {
+                    std::set<std::string> aFieldNameSet;
+                    for (Field &aField : aStruct.fields)
+                    {
+                        std::string aFieldName = sanitizeIdentifier(aField.name);
+                        if (aReservedNameSet.count(aFieldName) || aClassNameSet.count(aFieldName))
+                        {
+                            aFieldName += "_";
+                        }
+                        aField.name = aFieldName;
+                        for (uint32_t aSuffix = 2; !aFieldNameSet.insert(aField.name).second; ++aSuffix)
+                        {
+                            aField.name = aFieldName + std::to_string(aSuffix);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    class ChunkWriter
+    {
+    public:
+        ChunkWriter(const Chunk &iChunk, uint32_t iPointerSize) : _chunk(iChunk), _pointerSize(iPointerSize), _hasFilenames(false)
+        {
+        }
+
+        // True if a version of the chunk references other files, valid once written
+        bool hasFilenames() const
+        {
+            return _hasFilenames;
+        }
+
+        std::string write()
+        {
+            std::string aGuard = "GW2DATTOOLS_ANSTRUCTS_" + toUpper(_chunk.namespaceName) + "_H";
+
+            _out << "// Generated by anstructs-generator from ANStructs.txt, do not edit.\n\n";
+            _out << "#ifndef " << aGuard << "\n";
+            _out << "#define " << aGuard << "\n\n";
+            _out << "#include <utility>\n\n";
+            _out << "#include \"gw2dattools/anstructs/ViewTypes.h\"\n";
+            _out << "#include \"gw2dattools/format/PackFileView.h\"\n\n";
+            _out << "namespace gw2dt\n{\n    namespace anstructs\n    {\n";
+            _out << "        namespace " << _chunk.namespaceName << "\n        {\n\n";
+            _out << "            static const uint32_t Magic = " << formatMagic(_chunk.magic) << "; // " << _chunk.magic << "\n";
+            _out << "            static const uint16_t LatestVersion = " << _chunk.versions.front().version << ";\n\n";
+
+            for (const VersionBlock &aVersionBlock : _chunk.versions)
+            {
+                writeVersionBlock(aVersionBlock);
+            }
+
+            writeDispatch();
+
+            _out << "        } // namespace " << _chunk.namespaceName << "\n";
+            _out << "    } // namespace anstructs\n} // namespace gw2dt\n\n";
+            _out << "#endif // " << aGuard << "\n";
+
+            return _out.str();
+        }
+
+    private:
+        struct ClassInfo
+        {
+            std::string className;
+            uint32_t size;
+            bool isSizeKnown;
+            bool hasFilenames;
+        };
+
+        // Size and C++ type of a field element, as seen from the current version block
+        struct TypeInfo
+        {
+            std::string cppType;
+            uint32_t size;
+            bool isKnown;
+            bool isSizeKnown;
+            bool isView;
+            bool hasFilenames;
+        };
+
+        static std::string toUpper(const std::string &iString)
+        {
+            std::string aResult = iString;
+            for (char &aChar : aResult)
+            {
+                aChar = static_cast<char>(std::toupper(static_cast<unsigned char>(aChar)));
+            }
+            return aResult;
+        }
+
+        TypeInfo resolveType(const std::string &iTypeName) const
+        {
+            TypeInfo aTypeInfo;
+
+            const BuiltinType *pBuiltinType = findBuiltinType(iTypeName);
+            if (pBuiltinType != nullptr)
+            {
+                aTypeInfo.cppType = pBuiltinType->cppType;
+                aTypeInfo.size = pBuiltinType->size == 0 ? _pointerSize : pBuiltinType->size;
+                aTypeInfo.isKnown = true;
+                aTypeInfo.isSizeKnown = true;
+                aTypeInfo.isView = pBuiltinType->isView;
+                aTypeInfo.hasFilenames = iTypeName == "filename";
+                return aTypeInfo;
+            }
+
+            auto itClassInfo = _classInfoMap.find(iTypeName);
+            if (itClassInfo != _classInfoMap.end())
+            {
+                aTypeInfo.cppType = itClassInfo->second.className;
+                aTypeInfo.size = itClassInfo->second.size;
+                aTypeInfo.isKnown = true;
+                aTypeInfo.isSizeKnown = itClassInfo->second.isSizeKnown;
+                aTypeInfo.isView = true;
+                aTypeInfo.hasFilenames = itClassInfo->second.hasFilenames;
+                return aTypeInfo;
+            }
+
+            aTypeInfo.size = 0;
+            aTypeInfo.isKnown = false;
+            aTypeInfo.isSizeKnown = false;
+            aTypeInfo.isView = false;
+            aTypeInfo.hasFilenames = false;
+            return aTypeInfo;
+        }
+
+        void writeVersionBlock(const VersionBlock &iVersionBlock)
+        {
+            _classInfoMap.clear();
+
+            _out << "            namespace v" << iVersionBlock.version << "\n            {\n\n";
+
+            for (const Struct &aStruct : iVersionBlock.structs)
+            {
+                writeStruct(aStruct);
+            }
+
+            _out << "                typedef " << iVersionBlock.structs.back().className << " Root;\n\n";
+
+            bool aRootHasFilenames = _classInfoMap[iVersionBlock.structs.back().name].hasFilenames;
+            _rootHasFilenamesMap[iVersionBlock.version] = aRootHasFilenames;
+            _hasFilenames = _hasFilenames || aRootHasFilenames;
+            _out << "            } // namespace v" << iVersionBlock.version << "\n\n";
+        }
+
+        void writeStruct(const Struct &iStruct)
+        {
+            const std::string aIndent = "                    ";
+
+            std::ostringstream aAccessors;
+            std::ostringstream aFilenameVisits;
+            uint32_t aOffset = 0;
+            bool isOffsetKnown = true;
+
+            for (const Field &aField : iStruct.fields)
+            {
+                if (!isOffsetKnown)
+                {
+                    aAccessors << aIndent << "// " << aField.name << ": offset unknown\n";
+                    continue;
+                }
+
+                TypeInfo aTypeInfo = resolveType(aField.typeName);
+                std::string aAddress = "_data + " + std::to_string(aOffset);
+
+                // Only the fields leading to a file reference are walked by visitFilenames
+                if (aTypeInfo.hasFilenames && aTypeInfo.isSizeKnown)
+                {
+                    std::string aVisit = "if (!anstructs::visitFilenames(iBounds, " + aField.name + (aField.count == 0 || aField.kind != FK_VALUE ? "()" : "(aIndex)") +
+                                         ", ioVisitor)) return false;\n";
+                    if (aField.count == 0 || aField.kind != FK_VALUE)
+                    {
+                        aFilenameVisits << aIndent << "    " << aVisit;
+                    }
+                    else
+                    {
+                        aFilenameVisits << aIndent << "    for (uint32_t aIndex = 0; aIndex < " << aField.count << "; ++aIndex)\n";
+                        aFilenameVisits << aIndent << "        " << aVisit;
+                    }
+                }
+
+                if (aField.kind != FK_VALUE)
+                {
+                    std::string aViewType = aField.kind == FK_ARRAY_PTR ? "ArrayView" : aField.kind == FK_PTR_ARRAY_PTR ? "PtrArrayView" : "Ptr";
+
+                    if (aTypeInfo.isKnown)
+                    {
+                        std::string aType = aViewType + "<" + aTypeInfo.cppType + ">";
+                        aAccessors << aIndent << aType << " " << aField.name << "() const { return " << aType << "(" << aAddress << "); }\n";
+                    }
+                    else
+                    {
+                        aAccessors << aIndent << "// " << aField.typeName << ": element layout unknown\n";
+                        aAccessors << aIndent << "const uint8_t *" << aField.name << "() const { return " << aAddress << "; }\n";
+                    }
+
+                    aOffset += aField.kind == FK_PTR ? _pointerSize : 4 + _pointerSize;
+                    continue;
+                }
+
+                if (!aTypeInfo.isKnown || !aTypeInfo.isSizeKnown)
+                {
+                    aAccessors << aIndent << "// " << aField.typeName << ": layout unknown\n";
+                    aAccessors << aIndent << "const uint8_t *" << aField.name << "() const { return " << aAddress << "; }\n";
+                    isOffsetKnown = false;
+                    continue;
+                }
+
+                std::string aConstruction = aTypeInfo.isView ? aTypeInfo.cppType + "(" : "readValue<" + aTypeInfo.cppType + ">(";
+
+                if (aField.count == 0)
+                {
+                    aAccessors << aIndent << aTypeInfo.cppType << " " << aField.name << "() const { return " << aConstruction << aAddress << "); }\n";
+                    aOffset += aTypeInfo.size;
+                }
+                else
+                {
+                    aAccessors << aIndent << aTypeInfo.cppType << " " << aField.name << "(uint32_t iIndex) const { return " << aConstruction << aAddress
+                               << " + iIndex * " << aTypeInfo.size << "); }\n";
+                    aAccessors << aIndent << "static uint32_t " << aField.name << "Count() { return " << aField.count << "; }\n";
+                    aOffset += aTypeInfo.size * aField.count;
+                }
+            }
+
+            _out << "                class " << iStruct.className << "\n                {\n                public:\n";
+            if (isOffsetKnown)
+            {
+                _out << aIndent << "static const uint32_t structSize = " << aOffset << ";\n\n";
+            }
+            _out << aIndent << "explicit " << iStruct.className << "(const uint8_t *iData) : _data(iData) {}\n";
+            _out << aIndent << "const uint8_t *getData() const { return _data; }\n\n";
+            _out << aAccessors.str();
+
+            bool aHasFilenames = isOffsetKnown && !aFilenameVisits.str().empty();
+            if (aHasFilenames)
+            {
+                _out << "\n" << aIndent << "template <typename Visitor>\n";
+                _out << aIndent << "bool visitFilenames(const Bounds &iBounds, Visitor &ioVisitor) const\n" << aIndent << "{\n";
+                _out << aIndent << "    if (!iBounds.contains(_data, structSize)) return false;\n";
+                _out << aFilenameVisits.str();
+                _out << aIndent << "    return true;\n" << aIndent << "}\n";
+            }
+
+            _out << "\n                private:\n" << aIndent << "const uint8_t *_data;\n                };\n\n";
+
+            ClassInfo aClassInfo;
+            aClassInfo.className = iStruct.className;
+            aClassInfo.size = aOffset;
+            aClassInfo.isSizeKnown = isOffsetKnown;
+            aClassInfo.hasFilenames = aHasFilenames;
+            _classInfoMap[iStruct.name] = aClassInfo;
+        }
+
+        void writeDispatch()
+        {
+            _out << "            // Root structure of each version, selected at compile time\n";
+            _out << "            template <uint16_t sVersion>\n            struct Version;\n\n";
+            for (const VersionBlock &aVersionBlock : _chunk.versions)
+            {
+                _out << "            template <>\n            struct Version<" << aVersionBlock.version << ">\n            {\n";
+                _out << "                typedef v" << aVersionBlock.version << "::Root Root;\n            };\n\n";
+            }
+
+            _out << "            inline bool isVersionSupported(uint16_t iVersion)\n            {\n";
+            _out << "                switch (iVersion)\n                {\n";
+            for (const VersionBlock &aVersionBlock : _chunk.versions)
+            {
+                _out << "                case " << aVersionBlock.version << ":\n";
+            }
+            _out << "                    return true;\n                default:\n                    return false;\n                }\n            }\n\n";
+
+            _out << "            /**\n";
+            _out << "             * Calls iVisitor with the root view matching iVersion, the visitor is instantiated for each version.\n";
+            _out << "             * @return false if the version is not described.\n";
+            _out << "             */\n";
+            _out << "            template <typename Visitor>\n";
+            _out << "            bool dispatch(uint16_t iVersion, const uint8_t *iData, Visitor &&iVisitor)\n            {\n";
+            _out << "                switch (iVersion)\n                {\n";
+            for (const VersionBlock &aVersionBlock : _chunk.versions)
+            {
+                _out << "                case " << aVersionBlock.version << ":\n";
+                _out << "                    iVisitor(v" << aVersionBlock.version << "::Root(iData));\n";
+                _out << "                    return true;\n";
+            }
+            _out << "                default:\n                    return false;\n                }\n            }\n\n";
+
+            _out << "            // Same as above for a chunk of a PackFile, fails if the chunk magic does not match\n";
+            _out << "            template <typename Visitor>\n";
+            _out << "            bool dispatch(const format::PackFileView::Chunk &iChunk, Visitor &&iVisitor)\n            {\n";
+            _out << "                return iChunk.magic == Magic && dispatch(iChunk.version, iChunk.data, std::forward<Visitor>(iVisitor));\n";
+            _out << "            }\n\n";
+
+            _out << "            /**\n";
+            _out << "             * Calls iVisitor with the base id of every file referenced by the chunk, without leaving its iSize bytes.\n";
+            _out << "             * @return false if the version is not described or the chunk data is malformed.\n";
+            _out << "             */\n";
+            _out << "            template <typename Visitor>\n";
+            if (!_hasFilenames)
+            {
+                _out << "            bool visitFilenames(uint16_t iVersion, const uint8_t *, uint32_t, Visitor &&)\n            {\n";
+                _out << "                return isVersionSupported(iVersion);\n            }\n\n";
+                return;
+            }
+
+            _out << "            bool visitFilenames(uint16_t iVersion, const uint8_t *iData, uint32_t iSize, Visitor &&iVisitor)\n            {\n";
+            _out << "                Bounds aBounds(iData, iSize);\n";
+            _out << "                switch (iVersion)\n                {\n";
+            for (const VersionBlock &aVersionBlock : _chunk.versions)
+            {
+                if (_rootHasFilenamesMap[aVersionBlock.version])
+                {
+                    _out << "                case " << aVersionBlock.version << ":\n";
+                    _out << "                    return v" << aVersionBlock.version << "::Root(iData).visitFilenames(aBounds, iVisitor);\n";
+                }
+            }
+            bool aHasVersionsWithoutFilenames = false;
+            for (const VersionBlock &aVersionBlock : _chunk.versions)
+            {
+                if (!_rootHasFilenamesMap[aVersionBlock.version])
+                {
+                    _out << "                case " << aVersionBlock.version << ":\n";
+                    aHasVersionsWithoutFilenames = true;
+                }
+            }
+            if (aHasVersionsWithoutFilenames)
+            {
+                _out << "                    return true;\n";
+            }
+            _out << "                default:\n                    return false;\n                }\n            }\n\n";
+        }
+
+        const Chunk &_chunk;
+        uint32_t _pointerSize;
+        std::map<std::string, ClassInfo> _classInfoMap;
+        std::map<uint32_t, bool> _rootHasFilenamesMap;
+        bool _hasFilenames;
+        std::ostringstream _out;
+    };
+
+    // Writes a file only if its content changed
+    void writeFile(const std::string &iPath, const std::string &iContent)
+    {
+        {
+            std::ifstream aInput(iPath, std::ios::binary);
+            if (aInput)
+            {
+                std::ostringstream aCurrentContent;
+                aCurrentContent << aInput.rdbuf();
+                if (aCurrentContent.str() == iContent)
+                {
+                    return;
+                }
+            }
+        }
+
+        std::ofstream aOutput(iPath, std::ios::binary);
+        aOutput << iContent;
+        if (!aOutput)
+        {
+            throw std::runtime_error("cannot write " + iPath);
+        }
+    }
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3 && argc != 4)
+    {
+        std::cout << "usage: anstructs-generator <ANStructs.txt> <output directory> [pointer size]" << std::endl;
+        return 1;
+    }
+
+    uint32_t aPointerSize = argc == 4 ? static_cast<uint32_t>(atoi(argv[3])) : 4;
+    if (aPointerSize != 4 && aPointerSize != 8)
+    {
+        std::cerr << "pointer size must be 4 or 8" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        std::vector<Chunk> aChunkVect = parseStructFile(argv[1]);
+        assignNames(aChunkVect);
+
+        std::string aOutputDirectory = argv[2];
+        std::ostringstream aUmbrella;
+        aUmbrella << "// Generated by anstructs-generator from ANStructs.txt, do not edit.\n\n";
+        aUmbrella << "#ifndef GW2DATTOOLS_ANSTRUCTS_ANSTRUCTS_H\n#define GW2DATTOOLS_ANSTRUCTS_ANSTRUCTS_H\n\n";
+
+        // Chunks by magic, several structures may share a magic
+        std::map<std::string, std::vector<const Chunk *>> aChunkMap;
+
+        for (const Chunk &aChunk : aChunkVect)
+        {
+            ChunkWriter aChunkWriter(aChunk, aPointerSize);
+            writeFile(aOutputDirectory + "/" + aChunk.namespaceName + ".h", aChunkWriter.write());
+            aUmbrella << "#include \"gw2dattools/anstructs/" << aChunk.namespaceName << ".h\"\n";
+            aChunkMap[formatMagic(aChunk.magic)].push_back(&aChunk);
+        }
+
+        aUmbrella << "\nnamespace gw2dt\n{\n    namespace anstructs\n    {\n\n";
+        aUmbrella << "        /**\n";
+        aUmbrella << "         * Calls iVisitor with the base id of every file referenced by a chunk, without leaving its iSize bytes.\n";
+        aUmbrella << "         * When several structures share the magic of the chunk, iPackType, the type of the PackFile holding\n";
+        aUmbrella << "         * it, selects one. Such chunks are not guessed when the generator does not know their pack type.\n";
+        aUmbrella << "         * @return false if no structure describes the chunk.\n";
+        aUmbrella << "         */\n";
+        aUmbrella << "        template <typename Visitor>\n";
+        aUmbrella << "        bool visitChunkFilenames(uint32_t iPackType, uint32_t iMagic, uint16_t iVersion, const uint8_t *iData, uint32_t iSize, Visitor &&iVisitor)\n        {\n";
+        aUmbrella << "            switch (iMagic)\n            {\n";
+        for (const auto &itChunks : aChunkMap)
+        {
+            aUmbrella << "            case " << itChunks.first << ":\n";
+            if (itChunks.second.size() == 1)
+            {
+                aUmbrella << "                return " << itChunks.second.front()->namespaceName << "::visitFilenames(iVersion, iData, iSize, iVisitor);\n";
+                continue;
+            }
+
+            std::set<std::string> aPackTypeSet;
+            for (const Chunk *pChunk : itChunks.second)
+            {
+                const char *pPackType = findPackType(pChunk->rootName);
+                if (pPackType == nullptr)
+                {
+                    continue;
+                }
+                if (!aPackTypeSet.insert(pPackType).second)
+                {
+                    throw std::runtime_error("chunk " + pChunk->magic + " has several structures for pack type " + pPackType);
+                }
+                aUmbrella << "                if (iPackType == " << formatMagic(pPackType) << ") return " << pChunk->namespaceName
+                          << "::visitFilenames(iVersion, iData, iSize, iVisitor);\n";
+            }
+            aUmbrella << "                return false;\n";
+        }
+        aUmbrella << "            default:\n                return false;\n            }\n        }\n\n";
+        aUmbrella << "        // Same as above for a chunk of a PackFile of type iPackType\n";
+        aUmbrella << "        template <typename Visitor>\n";
+        aUmbrella << "        bool visitChunkFilenames(uint32_t iPackType, const format::PackFileView::Chunk &iChunk, Visitor &&iVisitor)\n        {\n";
+        aUmbrella << "            return visitChunkFilenames(iPackType, iChunk.magic, iChunk.version, iChunk.data, iChunk.dataSize, std::forward<Visitor>(iVisitor));\n";
+        aUmbrella << "        }\n\n";
+        aUmbrella << "    } // namespace anstructs\n} // namespace gw2dt\n";
+
+        aUmbrella << "\n#endif // GW2DATTOOLS_ANSTRUCTS_ANSTRUCTS_H\n";
+
+        std::ostringstream aConfig;
+        aConfig << "// Generated by anstructs-generator, do not edit.\n\n";
+        aConfig << "#ifndef GW2DATTOOLS_ANSTRUCTS_CONFIG_H\n#define GW2DATTOOLS_ANSTRUCTS_CONFIG_H\n\n";
+        aConfig << "#define GW2DATTOOLS_ANSTRUCTS_POINTER_SIZE " << aPointerSize << "\n\n";
+        aConfig << "#endif // GW2DATTOOLS_ANSTRUCTS_CONFIG_H\n";
+
+        writeFile(aOutputDirectory + "/Config.h", aConfig.str());
+        writeFile(aOutputDirectory + "/ANStructs.h", aUmbrella.str());
+
+        std::cout << "Generated " << aChunkVect.size() << " chunk headers in " << aOutputDirectory << std::endl;
+    }
+    catch (std::exception &iException)
+    {
+        std::cerr << "anstructs-generator: " << iException.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,1116 @@
+// Exports the files of an archive, all of them or a filtered subset.
+//
+// usage: gw2dat-extract <archive> <output directory> [options]
+//
+// The extraction is a pipeline: the files are read in the order of their offsets in the archive,
+// inflated by a pool of threads and written by another pool. The content held by the pipeline is
+// bounded by a memory budget: the reader waits for the later stages to release memory before
+// reading more. Each handled file is recorded in a journal with its checksum: an incremental run
+// compares the journal to the archive and only extracts the files added or changed since the
+// previous run, removing the outputs of the deleted ones. It also resumes an interrupted run.
+//
+// With --dedup, outputs are stored by the hash of their content, computed by the inflating threads:
+// identical files are written once and the journal maps their ids to the hash.
+//
+// With --container, outputs are appended to a single container file instead, which avoids the cost
+// of creating a file per output; gw2dt::container::ContainerReader reads them back.
+//
+// With --plan, the files are split into shards of balanced size, each a contiguous byte range of the
+// archive, and a manifest is written per shard; a run with --shard then only extracts one of them,
+// which lets several machines share an extraction without coordination. A manifest planned on
+// another version of the archive is refused.
+//
+// With --cache, inflated contents are kept in a persistent cache keyed by fileId and MFT crc, which
+// the reader checks before reading the archive: later runs skip the inflating of the cached files.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include <gw2dattools/cache/ContentCache.h>
+#include <gw2dattools/compression/inflateDatFileBuffer.h>
+#include <gw2dattools/compression/inflateTextureFileBuffer.h>
+#include <gw2dattools/container/ExportContainer.h>
+#include <gw2dattools/index/ShardPlanner.h>
+#include <gw2dattools/integrity/ContentHash.h>
+#include <gw2dattools/interface/ANDatInterface.h>
+
+namespace
+{
+
+    typedef gw2dt::datfile::ANDatInterface::FileRecord FileRecord;
+
+    const char *const sUsage =
+        "usage: gw2dat-extract <archive> <output directory> [options]\n"
+        "  --ids <ranges>    only the files whose id is in the ranges, e.g. 16,100-200\n"
+        "  --magic <prefix>  only the files whose content starts with the prefix, e.g. ATEX or PF\n"
+        "  --shard <path>    only the files of a shard manifest written by --plan\n"
+        "  --textures        write the pixel blocks of the texture files instead of their content\n"
+        "  --cache <dir>     keep the inflated contents in a cache shared by the runs\n"
+        "  --dedup           store each distinct output once, under objects/ and named after its hash\n"
+        "  --container       append the outputs to a single container file, gw2dat-extract.container\n"
+        "  --incremental     only extract the files added or changed since the previous run in the\n"
+        "                    same directory, with the same options, and remove the deleted ones\n"
+        "  --threads <n>     number of inflating threads, one per hardware thread by default\n"
+        "  --writers <n>     number of writing threads, 2 by default\n"
+        "  --memory <MB>     memory budget of the pipeline, 512 MB by default\n"
+        "  --plan <n>        write the manifests of n shards, shard-<i>.manifest, instead of extracting\n";
+
+    const char *const sJournalName = "gw2dat-extract.journal";
+    const char *const sContainerName = "gw2dat-extract.container";
+
+    // Sizes read from a corrupted header are not trusted beyond this
+    const uint32_t sMaxContentSize = 1024 * 1024 * 1024;
+
+    struct IdRange
+    {
+        uint32_t first;
+        uint32_t last;
+    };
+
+    struct Options
+    {
+        std::string archivePath;
+        std::string outputDirectory;
+
+        std::vector<IdRange> idRangeVect;
+        std::string magicPrefix;
+        std::string shardPath;
+        std::string cacheDirectory;
+        std::unordered_set<uint32_t> shardIdSet;
+        bool inflateTextures = false;
+        bool incremental = false;
+        bool deduplicate = false;
+        bool toContainer = false;
+
+        uint32_t nbOfInflaters = 0;
+        uint32_t nbOfWriters = 2;
+        uint64_t memoryBudget = 512ull * 1024 * 1024;
+
+        uint32_t nbOfShardsToPlan = 0;
+    };
+
+    /**
+     * Bytes held by the pipeline. Acquiring blocks while the budget is exhausted, which stops the
+     * reader until the later stages release memory.
+     */
+    class MemoryBudget
+    {
+    public:
+        explicit MemoryBudget(uint64_t iBudget) : _budget(iBudget), _usedBytes(0), _peakBytes(0)
+        {
+        }
+
+        // Waits until the bytes fit, or until the caller is the only holder so that a file larger
+        // than the budget still goes through
+        void acquire(uint64_t iSize, uint64_t iHeldByCaller)
+        {
+            std::unique_lock<std::mutex> aLock(_mutex);
+            _condition.wait(aLock, [&]
+            {
+                return _usedBytes + iSize <= _budget || _usedBytes <= iHeldByCaller;
+            });
+            add(iSize);
+        }
+
+        // Used by the stages which cannot wait without blocking the pipeline
+        void forceAcquire(uint64_t iSize)
+        {
+            std::lock_guard<std::mutex> aLock(_mutex);
+            add(iSize);
+        }
+
+        void release(uint64_t iSize)
+        {
+            {
+                std::lock_guard<std::mutex> aLock(_mutex);
+                _usedBytes -= iSize;
+            }
+            _condition.notify_all();
+        }
+
+        uint64_t getUsedBytes() const
+        {
+            std::lock_guard<std::mutex> aLock(_mutex);
+            return _usedBytes;
+        }
+
+        uint64_t getPeakBytes() const
+        {
+            std::lock_guard<std::mutex> aLock(_mutex);
+            return _peakBytes;
+        }
+
+    private:
+        void add(uint64_t iSize)
+        {
+            _usedBytes += iSize;
+            _peakBytes = std::max(_peakBytes, _usedBytes);
+        }
+
+        const uint64_t _budget;
+        uint64_t _usedBytes;
+        uint64_t _peakBytes;
+
+        mutable std::mutex _mutex;
+        std::condition_variable _condition;
+    };
+
+    // Queue between two stages, its size is bounded by the memory budget rather than by a count
+    template <typename Item>
+    class WorkQueue
+    {
+    public:
+        void push(Item iItem)
+        {
+            {
+                std::lock_guard<std::mutex> aLock(_mutex);
+                _itemDeque.push_back(std::move(iItem));
+            }
+            _condition.notify_one();
+        }
+
+        // Returns false once the queue is closed and empty
+        bool pop(Item &oItem)
+        {
+            std::unique_lock<std::mutex> aLock(_mutex);
+            _condition.wait(aLock, [&]
+            {
+                return !_itemDeque.empty() || _isClosed;
+            });
+
+            if (_itemDeque.empty())
+            {
+                return false;
+            }
+
+            oItem = std::move(_itemDeque.front());
+            _itemDeque.pop_front();
+            return true;
+        }
+
+        void close()
+        {
+            {
+                std::lock_guard<std::mutex> aLock(_mutex);
+                _isClosed = true;
+            }
+            _condition.notify_all();
+        }
+
+    private:
+        std::deque<Item> _itemDeque;
+        bool _isClosed = false;
+
+        std::mutex _mutex;
+        std::condition_variable _condition;
+    };
+
+    struct FreeDeleter
+    {
+        void operator()(uint8_t *ipBuffer) const
+        {
+            free(ipBuffer);
+        }
+    };
+
+    struct ExtractItem
+    {
+        const FileRecord *pFileRecord;
+        uint64_t heldBytes;
+
+        std::vector<uint8_t> raw;
+        std::vector<uint8_t> content;
+        uint32_t contentSize;
+
+        std::unique_ptr<uint8_t, FreeDeleter> pTexture; // Allocated by inflateTextureFileBuffer
+        uint32_t textureSize;
+
+        uint64_t hash; // Hash of the output when deduplicating, 0 otherwise
+
+        bool isInflated; // The content was found in the cache
+    };
+
+    typedef std::unique_ptr<ExtractItem> ExtractItemPtr;
+
+    struct Statistics
+    {
+        std::atomic<uint32_t> nbOfWritten{0};
+        std::atomic<uint32_t> nbOfDuplicates{0};
+        std::atomic<uint32_t> nbOfFiltered{0};
+        std::atomic<uint32_t> nbOfFailed{0};
+        std::atomic<uint32_t> nbOfCacheHits{0};
+        std::atomic<uint64_t> readBytes{0};
+        std::atomic<uint64_t> writtenBytes{0};
+    };
+
+    /**
+     * Files handled by the runs in an output directory, one line per file: id, crc, size, offset,
+     * whether an output was written, filtered out files being recorded too, and the hash of the
+     * output when deduplicating. A file is recorded
+     * once its output is closed, so a file interrupted while being written is extracted again.
+     * Later lines override earlier ones until the journal is compacted.
+     */
+    class Journal
+    {
+    public:
+        struct Entry
+        {
+            uint32_t crc;
+            uint32_t size;
+            uint64_t offset;
+            bool isWritten;
+            uint64_t hash;
+        };
+
+        typedef std::unordered_map<uint32_t, Entry> EntryMap;
+
+        Journal(const std::string &iPath, bool iIncremental) : _path(iPath)
+        {
+            if (iIncremental)
+            {
+                std::ifstream aStream(iPath);
+                uint32_t aFileId;
+                Entry aEntry;
+                while (aStream >> aFileId >> aEntry.crc >> aEntry.size >> aEntry.offset >> aEntry.isWritten >> std::hex >> aEntry.hash >> std::dec)
+                {
+                    _previousEntryMap[aFileId] = aEntry;
+                }
+            }
+
+            _stream.open(iPath, iIncremental ? std::ios::app : std::ios::trunc);
+            if (!_stream)
+            {
+                throw std::runtime_error("Unable to open the journal " + iPath + ".");
+            }
+        }
+
+        const EntryMap &getPreviousEntryMap() const
+        {
+            return _previousEntryMap;
+        }
+
+        // The stored data is unchanged when its size and crc are, the offset stands in for a missing crc
+        bool isUpToDate(const FileRecord &iFileRecord) const
+        {
+            auto itEntry = _previousEntryMap.find(iFileRecord.fileId);
+            if (itEntry == _previousEntryMap.end() || itEntry->second.size != iFileRecord.size)
+            {
+                return false;
+            }
+            return iFileRecord.crc != 0 ? itEntry->second.crc == iFileRecord.crc : itEntry->second.offset == iFileRecord.offset;
+        }
+
+        const Entry *findPreviousEntry(uint32_t iFileId) const
+        {
+            auto itEntry = _previousEntryMap.find(iFileId);
+            return itEntry != _previousEntryMap.end() ? &itEntry->second : nullptr;
+        }
+
+        void record(const FileRecord &iFileRecord, bool iIsWritten, uint64_t iHash)
+        {
+            Entry aEntry = {iFileRecord.crc, iFileRecord.size, iFileRecord.offset, iIsWritten, iHash};
+
+            std::lock_guard<std::mutex> aLock(_mutex);
+            _entryMap[iFileRecord.fileId] = aEntry;
+            write(_stream, iFileRecord.fileId, aEntry);
+            _stream.flush();
+        }
+
+        /**
+         * Rewrites the journal with a line per file: the entries of the previous runs which are not
+         * dropped, then the entries recorded by this run.
+         *
+         * @return EntryMap Entries of the compacted journal.
+         */
+        EntryMap compact(const std::unordered_set<uint32_t> &iDroppedIdSet)
+        {
+            std::lock_guard<std::mutex> aLock(_mutex);
+            _stream.close();
+
+            EntryMap aEntryMap = _entryMap;
+            for (const auto &aPrevious : _previousEntryMap)
+            {
+                if (iDroppedIdSet.count(aPrevious.first) == 0)
+                {
+                    aEntryMap.insert(aPrevious);
+                }
+            }
+
+            std::vector<uint32_t> aFileIdVect;
+            aFileIdVect.reserve(aEntryMap.size());
+            for (const auto &aEntry : aEntryMap)
+            {
+                aFileIdVect.push_back(aEntry.first);
+            }
+            std::sort(aFileIdVect.begin(), aFileIdVect.end());
+
+            std::string aTemporaryPath = _path + ".tmp";
+            {
+                std::ofstream aStream(aTemporaryPath, std::ios::trunc);
+                for (uint32_t aFileId : aFileIdVect)
+                {
+                    write(aStream, aFileId, aEntryMap[aFileId]);
+                }
+                if (!aStream.flush())
+                {
+                    throw std::runtime_error("Unable to write the journal " + aTemporaryPath + ".");
+                }
+            }
+
+            // The appended journal stays valid until replaced
+            std::remove(_path.c_str());
+            if (std::rename(aTemporaryPath.c_str(), _path.c_str()) != 0)
+            {
+                throw std::runtime_error("Unable to replace the journal " + _path + ".");
+            }
+            return aEntryMap;
+        }
+
+    private:
+        static void write(std::ostream &ioStream, uint32_t iFileId, const Entry &iEntry)
+        {
+            ioStream << iFileId << ' ' << iEntry.crc << ' ' << iEntry.size << ' ' << iEntry.offset << ' ' << iEntry.isWritten << ' '
+                     << std::hex << iEntry.hash << std::dec << '\n';
+        }
+
+        std::string _path;
+        EntryMap _previousEntryMap;
+        EntryMap _entryMap;
+
+        std::ofstream _stream;
+        std::mutex _mutex;
+    };
+
+    /**
+     * Content-addressed outputs, stored in one subdirectory per value of the first byte of their
+     * hash. An object is written by the first writer claiming it, the writers of the same content
+     * wait until it is stored so that the journal never refers to an incomplete object.
+     */
+    class ObjectStore
+    {
+    public:
+        explicit ObjectStore(const std::string &iDirectory) : _directory(iDirectory)
+        {
+        }
+
+        void create() const;
+
+        // Objects stored by the previous runs
+        void addStored(uint64_t iHash)
+        {
+            _stateMap[iHash] = OS_STORED;
+        }
+
+        // Returns true if the caller has to write the object, false once it is stored
+        bool claim(uint64_t iHash)
+        {
+            std::unique_lock<std::mutex> aLock(_mutex);
+            for (;;)
+            {
+                auto itState = _stateMap.find(iHash);
+                if (itState == _stateMap.end())
+                {
+                    _stateMap[iHash] = OS_WRITING;
+                    return true;
+                }
+                if (itState->second == OS_STORED)
+                {
+                    return false;
+                }
+                _condition.wait(aLock);
+            }
+        }
+
+        // Ends a claim, a failed write lets the next writer of the content claim it
+        void complete(uint64_t iHash, bool iIsStored)
+        {
+            {
+                std::lock_guard<std::mutex> aLock(_mutex);
+                if (iIsStored)
+                {
+                    _stateMap[iHash] = OS_STORED;
+                }
+                else
+                {
+                    _stateMap.erase(iHash);
+                }
+            }
+            _condition.notify_all();
+        }
+
+        std::string getPath(uint64_t iHash) const
+        {
+            char aName[40];
+            snprintf(aName, sizeof(aName), "/%02x/%016llx", static_cast<unsigned int>(iHash >> 56), static_cast<unsigned long long>(iHash));
+            return _directory + aName;
+        }
+
+    private:
+        enum ObjectState
+        {
+            OS_WRITING,
+            OS_STORED
+        };
+
+        std::string _directory;
+        std::unordered_map<uint64_t, ObjectState> _stateMap;
+
+        std::mutex _mutex;
+        std::condition_variable _condition;
+    };
+
+    bool parseIdRanges(const std::string &iText, std::vector<IdRange> &oRangeVect)
+    {
+        std::istringstream aStream(iText);
+        std::string aToken;
+
+        while (std::getline(aStream, aToken, ','))
+        {
+            IdRange aRange;
+            char aDash;
+            std::istringstream aTokenStream(aToken);
+
+            if (!(aTokenStream >> aRange.first))
+            {
+                return false;
+            }
+            if (aTokenStream >> aDash)
+            {
+                if (aDash != '-' || !(aTokenStream >> aRange.last) || aRange.last < aRange.first)
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                aRange.last = aRange.first;
+            }
+            oRangeVect.push_back(aRange);
+        }
+
+        return !oRangeVect.empty();
+    }
+
+    bool parseOptions(int argc, char *argv[], Options &oOptions)
+    {
+        if (argc < 3)
+        {
+            return false;
+        }
+
+        oOptions.archivePath = argv[1];
+        oOptions.outputDirectory = argv[2];
+
+        for (int aIndex = 3; aIndex < argc; ++aIndex)
+        {
+            std::string aOption = argv[aIndex];
+            bool aHasValue = aIndex + 1 < argc;
+
+            if (aOption == "--textures")
+            {
+                oOptions.inflateTextures = true;
+            }
+            else if (aOption == "--dedup")
+            {
+                oOptions.deduplicate = true;
+            }
+            else if (aOption == "--container")
+            {
+                oOptions.toContainer = true;
+            }
+            else if (aOption == "--incremental")
+            {
+                oOptions.incremental = true;
+            }
+            else if (aOption == "--ids" && aHasValue)
+            {
+                if (!parseIdRanges(argv[++aIndex], oOptions.idRangeVect))
+                {
+                    return false;
+                }
+            }
+            else if (aOption == "--magic" && aHasValue)
+            {
+                oOptions.magicPrefix = argv[++aIndex];
+            }
+            else if (aOption == "--cache" && aHasValue)
+            {
+                oOptions.cacheDirectory = argv[++aIndex];
+            }
+            else if (aOption == "--shard" && aHasValue)
+            {
+                oOptions.shardPath = argv[++aIndex];
+            }
+            else if (aOption == "--plan" && aHasValue)
+            {
+                int aNbOfShards = atoi(argv[++aIndex]);
+                if (aNbOfShards <= 0)
+                {
+                    return false;
+                }
+                oOptions.nbOfShardsToPlan = static_cast<uint32_t>(aNbOfShards);
+            }
+            else if (aOption == "--threads" && aHasValue)
+            {
+                oOptions.nbOfInflaters = static_cast<uint32_t>(atoi(argv[++aIndex]));
+            }
+            else if (aOption == "--writers" && aHasValue)
+            {
+                oOptions.nbOfWriters = std::max(1, atoi(argv[++aIndex]));
+            }
+            else if (aOption == "--memory" && aHasValue)
+            {
+                oOptions.memoryBudget = std::max(1, atoi(argv[++aIndex])) * 1024ull * 1024;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        // A container is written from scratch and holds every output
+        if (oOptions.toContainer && (oOptions.incremental || oOptions.deduplicate))
+        {
+            return false;
+        }
+
+        if (oOptions.nbOfInflaters == 0)
+        {
+            oOptions.nbOfInflaters = std::max(1u, std::thread::hardware_concurrency());
+        }
+        return true;
+    }
+
+    bool isSelected(const Options &iOptions, uint32_t iFileId)
+    {
+        if (!iOptions.shardPath.empty() && iOptions.shardIdSet.count(iFileId) == 0)
+        {
+            return false;
+        }
+
+        if (iOptions.idRangeVect.empty())
+        {
+            return true;
+        }
+
+        for (const IdRange &aRange : iOptions.idRangeVect)
+        {
+            if (iFileId >= aRange.first && iFileId <= aRange.last)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void makeDirectory(const std::string &iPath)
+    {
+#ifdef _WIN32
+        _mkdir(iPath.c_str());
+#else
+        mkdir(iPath.c_str(), 0755);
+#endif
+    }
+
+    void ObjectStore::create() const
+    {
+        makeDirectory(_directory);
+        for (uint32_t aShard = 0; aShard < 256; ++aShard)
+        {
+            char aName[8];
+            snprintf(aName, sizeof(aName), "/%02x", aShard);
+            makeDirectory(_directory + aName);
+        }
+    }
+
+    double toMegaBytes(uint64_t iBytes)
+    {
+        return iBytes / (1024.0 * 1024.0);
+    }
+
+    // Inflates the raw data of an item and applies the content filters, returns false if the file is filtered out
+    bool inflateItem(const Options &iOptions, MemoryBudget &ioBudget, gw2dt::cache::ContentCache *ipContentCache, ExtractItem &ioItem)
+    {
+        if (ioItem.isInflated)
+        {
+            // Read from the cache
+        }
+        else if (ioItem.pFileRecord->isCompressed)
+        {
+            uint32_t aSize = ioItem.contentSize;
+            gw2dt::compression::inflateDatFileBuffer(static_cast<uint32_t>(ioItem.raw.size()), ioItem.raw.data(), aSize, ioItem.content.data());
+            ioItem.contentSize = aSize;
+
+            if (ipContentCache != nullptr)
+            {
+                ipContentCache->store(*ioItem.pFileRecord, ioItem.contentSize, ioItem.content.data());
+            }
+
+            ioBudget.release(ioItem.raw.size());
+            ioItem.heldBytes -= ioItem.raw.size();
+            std::vector<uint8_t>().swap(ioItem.raw);
+        }
+        else
+        {
+            ioItem.content.swap(ioItem.raw);
+            ioItem.contentSize = static_cast<uint32_t>(ioItem.content.size());
+        }
+
+        if (ioItem.contentSize < iOptions.magicPrefix.size() ||
+            memcmp(ioItem.content.data(), iOptions.magicPrefix.data(), iOptions.magicPrefix.size()) != 0)
+        {
+            return false;
+        }
+
+        uint32_t aMagic;
+        uint32_t aFormatFourCc;
+        uint16_t aWidth;
+        uint16_t aHeight;
+        if (iOptions.inflateTextures &&
+            gw2dt::compression::readTextureFileHeader(ioItem.contentSize, ioItem.content.data(), aMagic, aFormatFourCc, aWidth, aHeight))
+        {
+            uint32_t aTextureSize = 0;
+            ioItem.pTexture.reset(gw2dt::compression::inflateTextureFileBuffer(ioItem.contentSize, ioItem.content.data(), aTextureSize));
+            ioItem.textureSize = aTextureSize;
+
+            // Inflaters must not wait on the budget: the writers only free memory once fed
+            ioBudget.forceAcquire(aTextureSize);
+            ioBudget.release(ioItem.content.size());
+            ioItem.heldBytes += aTextureSize;
+            ioItem.heldBytes -= ioItem.content.size();
+            std::vector<uint8_t>().swap(ioItem.content);
+        }
+
+        // Hashed while the output is still in the cache of the inflating thread
+        if (iOptions.deduplicate)
+        {
+            ioItem.hash = ioItem.pTexture ? gw2dt::integrity::computeContentHash(ioItem.textureSize, ioItem.pTexture.get())
+                                          : gw2dt::integrity::computeContentHash(ioItem.contentSize, ioItem.content.data());
+        }
+
+        return true;
+    }
+
+    std::string getOutputPath(const Options &iOptions, uint32_t iFileId, bool iIsTexture)
+    {
+        std::ostringstream aPath;
+        aPath << iOptions.outputDirectory << "/" << iFileId << (iIsTexture ? ".tex" : "");
+        return aPath.str();
+    }
+
+    // Removes what a previous run wrote for a file, shared objects are collected after the run instead
+    void removeOutputs(const Options &iOptions, uint32_t iFileId, const Journal::Entry &iEntry)
+    {
+        if (iEntry.isWritten && iEntry.hash == 0)
+        {
+            std::remove(getOutputPath(iOptions, iFileId, false).c_str());
+            std::remove(getOutputPath(iOptions, iFileId, true).c_str());
+        }
+    }
+
+    const uint8_t *getOutputData(const ExtractItem &iItem, uint32_t &oSize)
+    {
+        oSize = iItem.pTexture ? iItem.textureSize : iItem.contentSize;
+        return iItem.pTexture ? iItem.pTexture.get() : iItem.content.data();
+    }
+
+    bool writeItem(const std::string &iPath, const ExtractItem &iItem, uint64_t &oWrittenBytes)
+    {
+        uint32_t aSize;
+        const uint8_t *pData = getOutputData(iItem, aSize);
+        oWrittenBytes = aSize;
+
+        std::ofstream aStream(iPath, std::ios::binary | std::ios::trunc);
+        aStream.write(reinterpret_cast<const char *>(pData), aSize);
+        aStream.close();
+        return !aStream.fail();
+    }
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options aOptions;
+    if (!parseOptions(argc, argv, aOptions))
+    {
+        std::cout << sUsage;
+        return 1;
+    }
+
+    try
+    {
+        auto pANDatInterface = gw2dt::datfile::createANDatInterface(aOptions.archivePath.c_str());
+
+        makeDirectory(aOptions.outputDirectory);
+
+        if (aOptions.nbOfShardsToPlan != 0)
+        {
+            for (const gw2dt::index::Shard &aShard : gw2dt::index::planShards(*pANDatInterface, aOptions.nbOfShardsToPlan))
+            {
+                std::string aPath = aOptions.outputDirectory + "/shard-" + std::to_string(aShard.index) + ".manifest";
+                gw2dt::index::saveShardManifest(aShard, aPath.c_str());
+
+                std::cout << aPath << ": " << aShard.fileIdVect.size() << " files, " << toMegaBytes(aShard.size)
+                          << " MB, bytes " << aShard.beginOffset << " to " << aShard.endOffset << std::endl;
+            }
+            return 0;
+        }
+
+        if (!aOptions.shardPath.empty())
+        {
+            gw2dt::index::Shard aShard = gw2dt::index::loadShardManifest(aOptions.shardPath.c_str(), *pANDatInterface);
+            aOptions.shardIdSet.insert(aShard.fileIdVect.begin(), aShard.fileIdVect.end());
+            std::cout << "Shard " << aShard.index + 1 << " of " << aShard.nbOfShards << std::endl;
+        }
+        Journal aJournal(aOptions.outputDirectory + "/" + sJournalName, aOptions.incremental);
+
+        ObjectStore aObjectStore(aOptions.outputDirectory + "/objects");
+        if (aOptions.deduplicate)
+        {
+            aObjectStore.create();
+        }
+
+        std::unique_ptr<gw2dt::cache::ContentCache> pContentCache;
+        if (!aOptions.cacheDirectory.empty())
+        {
+            pContentCache.reset(new gw2dt::cache::ContentCache(aOptions.cacheDirectory.c_str()));
+        }
+
+        std::unique_ptr<gw2dt::container::ContainerWriter> pContainerWriter;
+        if (aOptions.toContainer)
+        {
+            pContainerWriter.reset(new gw2dt::container::ContainerWriter((aOptions.outputDirectory + "/" + sContainerName).c_str()));
+        }
+
+        // Ids of the journal entries not kept as they are: the extracted and the deleted files
+        std::unordered_set<uint32_t> aDroppedIdSet;
+
+        // Offset order keeps the reads sequential
+        std::vector<const FileRecord *> aFileRecordVect;
+        std::unordered_set<uint32_t> aArchiveIdSet;
+        uint32_t aNbOfUpToDate = 0;
+        for (const FileRecord &aFileRecord : pANDatInterface->getFileRecordVect())
+        {
+            aArchiveIdSet.insert(aFileRecord.fileId);
+            if (!isSelected(aOptions, aFileRecord.fileId))
+            {
+                continue;
+            }
+            if (aJournal.isUpToDate(aFileRecord))
+            {
+                ++aNbOfUpToDate;
+                continue;
+            }
+            aFileRecordVect.push_back(&aFileRecord);
+            aDroppedIdSet.insert(aFileRecord.fileId);
+        }
+
+        uint32_t aNbOfDeleted = 0;
+        for (const auto &aEntry : aJournal.getPreviousEntryMap())
+        {
+            if (aArchiveIdSet.count(aEntry.first) == 0)
+            {
+                removeOutputs(aOptions, aEntry.first, aEntry.second);
+                aDroppedIdSet.insert(aEntry.first);
+                ++aNbOfDeleted;
+            }
+            else if (aEntry.second.hash != 0 && aDroppedIdSet.count(aEntry.first) == 0)
+            {
+                aObjectStore.addStored(aEntry.second.hash);
+            }
+        }
+        std::sort(aFileRecordVect.begin(), aFileRecordVect.end(), [](const FileRecord *iLeft, const FileRecord *iRight)
+        {
+            return iLeft->offset < iRight->offset;
+        });
+
+        std::cout << "Extracting " << aFileRecordVect.size() << " files with " << aOptions.nbOfInflaters << " inflaters, "
+                  << aOptions.nbOfWriters << " writers and a budget of " << toMegaBytes(aOptions.memoryBudget) << " MB";
+        if (aOptions.incremental)
+        {
+            std::cout << ", " << aNbOfUpToDate << " files up to date, " << aNbOfDeleted << " deleted";
+        }
+        std::cout << std::endl;
+
+        MemoryBudget aBudget(aOptions.memoryBudget);
+        WorkQueue<ExtractItemPtr> aInflateQueue;
+        WorkQueue<ExtractItemPtr> aWriteQueue;
+        Statistics aStatistics;
+
+        auto aFail = [&](const ExtractItem &iItem, const char *iReason)
+        {
+            std::cerr << "File " << iItem.pFileRecord->fileId << ": " << iReason << std::endl;
+            ++aStatistics.nbOfFailed;
+            aBudget.release(iItem.heldBytes);
+        };
+
+        std::vector<std::thread> aInflaterVect;
+        for (uint32_t aIndex = 0; aIndex < aOptions.nbOfInflaters; ++aIndex)
+        {
+            aInflaterVect.emplace_back([&]
+            {
+                ExtractItemPtr pItem;
+                while (aInflateQueue.pop(pItem))
+                {
+                    try
+                    {
+                        if (!inflateItem(aOptions, aBudget, pContentCache.get(), *pItem))
+                        {
+                            // The output of a previous version of the file is stale
+                            const Journal::Entry *pPreviousEntry = aJournal.findPreviousEntry(pItem->pFileRecord->fileId);
+                            if (pPreviousEntry != nullptr)
+                            {
+                                removeOutputs(aOptions, pItem->pFileRecord->fileId, *pPreviousEntry);
+                            }
+                            aJournal.record(*pItem->pFileRecord, false, 0);
+                            ++aStatistics.nbOfFiltered;
+                            aBudget.release(pItem->heldBytes);
+                            continue;
+                        }
+                        aWriteQueue.push(std::move(pItem));
+                    }
+                    catch (std::exception &iException)
+                    {
+                        aFail(*pItem, iException.what());
+                    }
+                }
+            });
+        }
+
+        std::vector<std::thread> aWriterVect;
+        for (uint32_t aIndex = 0; aIndex < aOptions.nbOfWriters; ++aIndex)
+        {
+            aWriterVect.emplace_back([&]
+            {
+                ExtractItemPtr pItem;
+                while (aWriteQueue.pop(pItem))
+                {
+                    std::string aPath;
+                    bool aIsDuplicate = false;
+                    uint64_t aWrittenBytes = 0;
+
+                    if (pContainerWriter)
+                    {
+                        try
+                        {
+                            uint32_t aSize;
+                            const uint8_t *pData = getOutputData(*pItem, aSize);
+                            pContainerWriter->add(pItem->pFileRecord->fileId, pItem->pTexture ? gw2dt::container::CEF_TEXTURE : 0, aSize, pData);
+                            aWrittenBytes = aSize;
+                        }
+                        catch (std::exception &iException)
+                        {
+                            aFail(*pItem, iException.what());
+                            continue;
+                        }
+                    }
+                    else if (aOptions.deduplicate)
+                    {
+                        aPath = aObjectStore.getPath(pItem->hash);
+                        aIsDuplicate = !aObjectStore.claim(pItem->hash);
+                    }
+                    else
+                    {
+                        aPath = getOutputPath(aOptions, pItem->pFileRecord->fileId, pItem->pTexture != nullptr);
+                    }
+
+                    if (!pContainerWriter && !aIsDuplicate)
+                    {
+                        bool aIsWritten = writeItem(aPath, *pItem, aWrittenBytes);
+                        if (aOptions.deduplicate)
+                        {
+                            aObjectStore.complete(pItem->hash, aIsWritten);
+                        }
+                        if (!aIsWritten)
+                        {
+                            aFail(*pItem, "unable to write the output file");
+                            continue;
+                        }
+                    }
+
+                    aJournal.record(*pItem->pFileRecord, true, pItem->hash);
+                    ++aStatistics.nbOfWritten;
+                    aStatistics.nbOfDuplicates += aIsDuplicate;
+                    aStatistics.writtenBytes += aWrittenBytes;
+                    aBudget.release(pItem->heldBytes);
+                }
+            });
+        }
+
+        // Throughput report, once per second
+        const auto aStartTime = std::chrono::steady_clock::now();
+        std::mutex aReportMutex;
+        std::condition_variable aReportCondition;
+        bool aIsDone = false;
+
+        std::thread aReporter([&]
+        {
+            std::unique_lock<std::mutex> aLock(aReportMutex);
+            while (!aReportCondition.wait_for(aLock, std::chrono::seconds(1), [&] { return aIsDone; }))
+            {
+                double aSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - aStartTime).count();
+                std::cout << "  " << aStatistics.nbOfWritten << "/" << aFileRecordVect.size() << " files, read "
+                          << toMegaBytes(aStatistics.readBytes) / aSeconds << " MB/s, written "
+                          << toMegaBytes(aStatistics.writtenBytes) / aSeconds << " MB/s, holding "
+                          << toMegaBytes(aBudget.getUsedBytes()) << " MB" << std::endl;
+            }
+        });
+
+        // The calling thread is the reader
+        for (const FileRecord *pFileRecord : aFileRecordVect)
+        {
+            ExtractItemPtr pItem(new ExtractItem());
+            pItem->pFileRecord = pFileRecord;
+            pItem->contentSize = 0;
+            pItem->textureSize = 0;
+            pItem->hash = 0;
+            pItem->isInflated = false;
+
+            pItem->heldBytes = 0;
+
+            try
+            {
+                // A hit replaces both the read and the inflate, the size in the entry header lets the budget
+                // cover the content before it is read
+                uint32_t aCachedSize = 0;
+                if (pContentCache && pContentCache->peekContentSize(*pFileRecord, aCachedSize) && aCachedSize <= sMaxContentSize)
+                {
+                    aBudget.acquire(aCachedSize, 0);
+                    pItem->heldBytes = aCachedSize;
+
+                    if (pContentCache->lookup(*pFileRecord, pItem->content, aCachedSize) && aCachedSize <= pItem->heldBytes)
+                    {
+                        pItem->contentSize = aCachedSize;
+                        pItem->isInflated = true;
+                        ++aStatistics.nbOfCacheHits;
+
+                        aInflateQueue.push(std::move(pItem));
+                        continue;
+                    }
+
+                    // Damaged or replaced meanwhile, read from the archive
+                    aBudget.release(pItem->heldBytes);
+                    pItem->heldBytes = 0;
+                }
+
+                aBudget.acquire(pFileRecord->size, 0);
+                pItem->heldBytes = pFileRecord->size;
+
+                pItem->raw.resize(pFileRecord->size);
+                uint32_t aSize = pFileRecord->size;
+                pANDatInterface->getBuffer(*pFileRecord, aSize, pItem->raw.data());
+                pItem->raw.resize(aSize);
+                aStatistics.readBytes += aSize;
+
+                if (pFileRecord->isCompressed)
+                {
+                    // The size of the content follows the first word of the compressed stream
+                    uint32_t aContentSize = 0;
+                    if (aSize >= 2 * sizeof(uint32_t))
+                    {
+                        memcpy(&aContentSize, pItem->raw.data() + sizeof(uint32_t), sizeof(aContentSize));
+                    }
+                    if (aContentSize == 0 || aContentSize > sMaxContentSize)
+                    {
+                        throw std::runtime_error("invalid content size");
+                    }
+
+                    aBudget.acquire(aContentSize, pItem->heldBytes);
+                    pItem->heldBytes += aContentSize;
+                    pItem->content.resize(aContentSize);
+                    pItem->contentSize = aContentSize;
+                }
+            }
+            catch (std::exception &iException)
+            {
+                aFail(*pItem, iException.what());
+                continue;
+            }
+
+            aInflateQueue.push(std::move(pItem));
+        }
+
+        aInflateQueue.close();
+        for (std::thread &aInflater : aInflaterVect)
+        {
+            aInflater.join();
+        }
+
+        aWriteQueue.close();
+        for (std::thread &aWriter : aWriterVect)
+        {
+            aWriter.join();
+        }
+
+        {
+            std::lock_guard<std::mutex> aLock(aReportMutex);
+            aIsDone = true;
+        }
+        aReportCondition.notify_all();
+        aReporter.join();
+
+        if (pContainerWriter)
+        {
+            pContainerWriter->finish();
+        }
+
+        Journal::EntryMap aEntryMap = aJournal.compact(aDroppedIdSet);
+
+        // Objects no longer referenced by any file
+        std::unordered_set<uint64_t> aReferencedHashSet;
+        for (const auto &aEntry : aEntryMap)
+        {
+            aReferencedHashSet.insert(aEntry.second.hash);
+        }
+        for (const auto &aEntry : aJournal.getPreviousEntryMap())
+        {
+            if (aEntry.second.hash != 0 && aReferencedHashSet.insert(aEntry.second.hash).second)
+            {
+                std::remove(aObjectStore.getPath(aEntry.second.hash).c_str());
+            }
+        }
+
+        double aSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - aStartTime).count();
+        std::cout << "Done in " << aSeconds << " s: " << aStatistics.nbOfWritten << " written (" << aStatistics.nbOfDuplicates
+                  << " duplicates), " << aStatistics.nbOfFiltered << " filtered out, " << aStatistics.nbOfFailed << " failed" << std::endl;
+        std::cout << "Read " << toMegaBytes(aStatistics.readBytes) << " MB (" << toMegaBytes(aStatistics.readBytes) / aSeconds
+                  << " MB/s), written " << toMegaBytes(aStatistics.writtenBytes) << " MB (" << toMegaBytes(aStatistics.writtenBytes) / aSeconds
+                  << " MB/s), peak memory " << toMegaBytes(aBudget.getPeakBytes()) << " MB" << std::endl;
+        if (pContentCache)
+        {
+            std::cout << aStatistics.nbOfCacheHits << " files read from the cache" << std::endl;
+        }
+
+        return aStatistics.nbOfFailed == 0 ? 0 : 2;
+    }
+    catch (std::exception &iException)
+    {
+        std::cerr << iException.what() << std::endl;
+        return 1;
+    }
+}